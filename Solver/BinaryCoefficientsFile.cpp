@@ -0,0 +1,96 @@
+/**
+ * @file BinaryCoefficientsFile.cpp
+ *
+ * @brief BinaryCoefficientsFile class for zero-copy loading of coefficients stored in binary format.
+ *
+ * @author Hovsep Papoyan
+ * Contact: papoyanhovsep93@gmail.com
+ * @Date 2024-03-28
+ *
+ */
+
+#include "BinaryCoefficientsFile.h"
+
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+static_assert(sizeof(BinaryCoefficientsFile::Header) == 24, "Header layout must not contain padding");
+static_assert(sizeof(int) == sizeof(std::int32_t), "Coefficients are stored as int32");
+
+std::optional<BinaryCoefficientsFile> BinaryCoefficientsFile::open(const std::string& path)
+{
+    MappedFile file(path);
+    Header header;
+    if (file.size() < sizeof(Header))
+    {
+        std::cerr << path << " is too small for a coefficients file\n";
+        return std::nullopt;
+    }
+    std::memcpy(&header, file.data(), sizeof(Header));
+    if (std::memcmp(header.m_magic, magic, sizeof(magic)) != 0 || header.m_version != version)
+    {
+        std::cerr << path << " is not a coefficients file of version " << version << '\n';
+        return std::nullopt;
+    }
+    if (header.m_layout != Layout::Interleaved && header.m_layout != Layout::Columnar)
+    {
+        std::cerr << path << " has unknown layout " << static_cast<std::uint32_t>(header.m_layout) << '\n';
+        return std::nullopt;
+    }
+    const std::size_t dataSize = file.size() - sizeof(Header);
+    if (header.m_count == 0 || dataSize % (3 * sizeof(int)) != 0 || header.m_count != dataSize / (3 * sizeof(int)))
+    {
+        // Same requirement as for text input: at least one whole equation.
+        std::cerr << "Please provide enough arguments\n";
+        return std::nullopt;
+    }
+    // Mapping is page aligned and the header is 24 bytes long, so ints are properly aligned.
+    const int* const data = reinterpret_cast<const int*>(file.data() + sizeof(Header));
+    const std::size_t count = static_cast<std::size_t>(header.m_count);
+    const slv::CoefficientsView coeffs = header.m_layout == Layout::Interleaved
+        ? slv::CoefficientsView::fromInterleaved(data, count)
+        : slv::CoefficientsView::fromColumns(data, data + count, data + 2 * count, count);
+    return BinaryCoefficientsFile(std::move(file), coeffs);
+}
+
+void BinaryCoefficientsFile::write(std::ostream& os, const slv::CoefficientsView& coeffs, const Layout layout)
+{
+    Header header{};
+    std::memcpy(header.m_magic, magic, sizeof(magic));
+    header.m_version = version;
+    header.m_layout = layout;
+    header.m_count = coeffs.size();
+    os.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+
+    std::vector<int> data;
+    data.reserve(coeffs.size() * 3);
+    if (layout == Layout::Interleaved)
+    {
+        for (std::size_t i = 0; i < coeffs.size(); ++i)
+        {
+            data.insert(data.end(), { coeffs.a(i), coeffs.b(i), coeffs.c(i) });
+        }
+    }
+    else
+    {
+        for (std::size_t i = 0; i < coeffs.size(); ++i)
+        {
+            data.push_back(coeffs.a(i));
+        }
+        for (std::size_t i = 0; i < coeffs.size(); ++i)
+        {
+            data.push_back(coeffs.b(i));
+        }
+        for (std::size_t i = 0; i < coeffs.size(); ++i)
+        {
+            data.push_back(coeffs.c(i));
+        }
+    }
+    os.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size() * sizeof(int)));
+}
+
+BinaryCoefficientsFile::BinaryCoefficientsFile(MappedFile file, const slv::CoefficientsView& coeffs)
+    : m_file(std::move(file))
+    , m_coeffs(coeffs)
+{ }
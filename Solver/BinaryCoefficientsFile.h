@@ -0,0 +1,67 @@
+/**
+ * @file BinaryCoefficientsFile.h
+ *
+ * @brief BinaryCoefficientsFile class for zero-copy loading of coefficients stored in binary format.
+ *
+ *        Layout of the file (native byte order, little-endian on all supported platforms):
+ *        Header (24 bytes): magic "SLVB", uint32 version, uint32 layout, uint32 reserved, uint64 equations count.
+ *        Data: equations count * 3 int32 values, either interleaved (a1, b1, c1, a2, ...)
+ *        Or columnar (a1, a2, ..., b1, b2, ..., c1, c2, ...).
+ *
+ * @author Hovsep Papoyan
+ * Contact: papoyanhovsep93@gmail.com
+ * @Date 2024-03-28
+ *
+ */
+
+#ifndef BINARY_COEFFICIENTS_FILE_H
+#define BINARY_COEFFICIENTS_FILE_H
+
+#include "CoefficientsView.h"
+#include "MappedFile.h"
+
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string>
+
+class BinaryCoefficientsFile
+{
+public:
+    enum class Layout : std::uint32_t
+    {
+        Interleaved,
+        Columnar
+    };
+
+    struct Header
+    {
+        char m_magic[4];
+        std::uint32_t m_version;
+        Layout m_layout;
+        std::uint32_t m_reserved;
+        std::uint64_t m_count;
+    };
+
+    static constexpr char magic[4] = { 'S', 'L', 'V', 'B' };
+    static constexpr std::uint32_t version = 1;
+
+    // Maps the file and validates its header and size.
+    // Reports the problem and returns std::nullopt if the file is not a valid coefficients file.
+    [[nodiscard]] static std::optional<BinaryCoefficientsFile> open(const std::string& path);
+
+    // Writes coefficients in the binary format, e.g. for producing input files.
+    static void write(std::ostream& os, const slv::CoefficientsView& coeffs, const Layout layout);
+
+    // Coefficients point directly into the mapped file, which stays mapped while this object lives.
+    [[nodiscard]] const slv::CoefficientsView& getCoefficients() const noexcept { return m_coeffs; }
+
+private:
+    BinaryCoefficientsFile(MappedFile file, const slv::CoefficientsView& coeffs);
+
+private:
+    MappedFile m_file;
+    slv::CoefficientsView m_coeffs;
+};
+
+#endif
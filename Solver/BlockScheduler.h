@@ -0,0 +1,124 @@
+/**
+ * @file BlockScheduler.h
+ *
+ * @brief runBlocks and other helpers shared by the parallel solvers for solving and formatting batches block by block.
+ *
+ * @author Hovsep Papoyan
+ * Contact: papoyanhovsep93@gmail.com
+ * @Date 2024-03-28
+ *
+ */
+
+#ifndef BLOCK_SCHEDULER_H
+#define BLOCK_SCHEDULER_H
+
+#include "GranularityPolicy.h"
+#include "ResultFormatter.h"
+#include "Statistics.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <string>
+#include <vector>
+
+namespace slv
+{
+    inline void recordSolvedBlock(const std::size_t equationsCount, const std::chrono::nanoseconds time) noexcept
+    {
+        mt::Statistics::add(mt::Statistics::Counter::SolvedBlocks);
+        mt::Statistics::add(mt::Statistics::Counter::SolvedEquations, equationsCount);
+        mt::Statistics::record(mt::Statistics::Distribution::BlockSolveNs, static_cast<std::uint64_t>(time.count()));
+        mt::Statistics::record(mt::Statistics::Distribution::BlockRows, equationsCount);
+    }
+
+    // ResultFormatter::formatBlock, timed if statistics are enabled.
+    template<typename Equations, typename ResultColumns>
+    void formatBlock(const Equations& equations, const ResultColumns& results, std::string& buffer)
+    {
+        if (!mt::Statistics::isEnabled())
+        {
+            ResultFormatter::formatBlock(equations, results, buffer);
+            return;
+        }
+        const auto start = std::chrono::steady_clock::now();
+        ResultFormatter::formatBlock(equations, results, buffer);
+        const std::chrono::nanoseconds time = std::chrono::steady_clock::now() - start;
+        mt::Statistics::add(mt::Statistics::Counter::FormattedBlocks);
+        mt::Statistics::record(mt::Statistics::Distribution::FormatNs, static_cast<std::uint64_t>(time.count()));
+    }
+
+    // Threads executing blocks of threadPool: its workers, plus the calling thread unless the pool has an affinity.
+    [[nodiscard]] inline std::size_t getBlockThreadsCount(const mt::ThreadPool& threadPool) noexcept
+    {
+        return threadPool.getThreadsCount() + (threadPool.getAffinity() == mt::ThreadPool::Affinity::None ? 1 : 0);
+    }
+
+    // Splits equationsCount equations into the blocks planned by granularity and calls solveBlock(blockIndex, first, count)
+    // For every block. solveBlock returns the time spent on solving (not on delivering) the block, the sum of all blocks is recorded
+    // Into granularity. Returns when every solveBlock call has returned, rethrows the first exception.
+    // Runners claim blocks in increasing order, instead of one task per block which workers would pick up in any order.
+    // So finished blocks wait only for the few blocks still being solved before them, and memory stays flat.
+    // With an affinity runner i goes to worker i of threadPool.
+    template<typename SolveBlock>
+    void runBlocks(mt::ThreadPool& threadPool, GranularityPolicy& granularity, const std::size_t equationsCount, const SolveBlock& solveBlock)
+    {
+        if (equationsCount == 0)
+        {
+            return;
+        }
+        const GranularityPolicy::Plan plan = granularity.plan(equationsCount);
+        const std::size_t numBlocks = plan.m_blocksCount;
+        const std::size_t blockSize = equationsCount / numBlocks;
+        const std::size_t remainder = equationsCount % numBlocks;
+
+        const std::size_t runnersCount = plan.m_inline ? 1 : std::min(numBlocks, getBlockThreadsCount(threadPool));
+        std::atomic<std::size_t> nextBlock{ 0 };
+        std::vector<std::chrono::nanoseconds> blockTimes(numBlocks);
+        const auto runner = [&]
+            {
+                for (std::size_t i = nextBlock++; i < numBlocks; i = nextBlock++)
+                {
+                    const std::size_t blockStart = i * blockSize + std::min(i, remainder);
+                    const std::size_t count = blockSize + (i < remainder ? 1 : 0);
+                    blockTimes[i] = solveBlock(i, blockStart, count);
+                }
+            };
+
+        if (runnersCount == 1)
+        {
+            runner();
+        }
+        else
+        {
+            std::vector<std::future<void>> futures;
+            futures.reserve(runnersCount);
+            for (std::size_t i = 0; i < runnersCount; ++i)
+            {
+                futures.push_back(threadPool.getAffinity() != mt::ThreadPool::Affinity::None ? threadPool.submitTo(i, runner) : threadPool.submit(runner));
+            }
+            // All runners are awaited before any get(), so no task can outlive this call even if one has thrown.
+            for (const std::future<void>& future : futures)
+            {
+                threadPool.waitFor(future);
+            }
+            for (std::future<void>& future : futures)
+            {
+                future.get();
+            }
+        }
+
+        std::chrono::nanoseconds busyTime{ 0 };
+        for (const std::chrono::nanoseconds time : blockTimes)
+        {
+            busyTime += time;
+        }
+        granularity.record(equationsCount, busyTime);
+    }
+} // namespace slv
+
+#endif
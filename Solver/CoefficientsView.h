@@ -0,0 +1,75 @@
+/**
+ * @file CoefficientsView.h
+ *
+ * @brief CoefficientsView class for non-owning access to a, b, c coefficients of equations.
+ *
+ * @author Hovsep Papoyan
+ * Contact: papoyanhovsep93@gmail.com
+ * @Date 2024-03-28
+ *
+ */
+
+#ifndef COEFFICIENTS_VIEW_H
+#define COEFFICIENTS_VIEW_H
+
+#include <cstddef>
+
+namespace slv
+{
+    // Covers both interleaved (a1, b1, c1, a2, ...) and columnar (a1, a2, ..., b1, b2, ..., c1, c2, ...) layouts.
+    // Coefficient i of a column is at m_x[i * m_stride].
+    class CoefficientsView
+    {
+    private:
+        const int* m_a = nullptr;
+        const int* m_b = nullptr;
+        const int* m_c = nullptr;
+        std::size_t m_stride = 0;
+        std::size_t m_count = 0;
+
+    public:
+        constexpr CoefficientsView() noexcept = default;
+
+        [[nodiscard]] static constexpr CoefficientsView fromInterleaved(const int* const coeffs, const std::size_t count) noexcept
+        {
+            return CoefficientsView(coeffs, coeffs + 1, coeffs + 2, 3, count);
+        }
+
+        [[nodiscard]] static constexpr CoefficientsView fromColumns(const int* const aCoefficients, const int* const bCoefficients,
+            const int* const cCoefficients, const std::size_t count) noexcept
+        {
+            return CoefficientsView(aCoefficients, bCoefficients, cCoefficients, 1, count);
+        }
+
+        [[nodiscard]] constexpr int a(const std::size_t i) const noexcept { return m_a[i * m_stride]; }
+        [[nodiscard]] constexpr int b(const std::size_t i) const noexcept { return m_b[i * m_stride]; }
+        [[nodiscard]] constexpr int c(const std::size_t i) const noexcept { return m_c[i * m_stride]; }
+
+        // Count of equations.
+        [[nodiscard]] constexpr std::size_t size() const noexcept { return m_count; }
+        [[nodiscard]] constexpr bool isColumnar() const noexcept { return m_stride == 1; }
+
+        // Columns start pointers, contiguous only if isColumnar().
+        [[nodiscard]] constexpr const int* aData() const noexcept { return m_a; }
+        [[nodiscard]] constexpr const int* bData() const noexcept { return m_b; }
+        [[nodiscard]] constexpr const int* cData() const noexcept { return m_c; }
+
+        // Equations [first, first + count).
+        [[nodiscard]] constexpr CoefficientsView subview(const std::size_t first, const std::size_t count) const noexcept
+        {
+            return CoefficientsView(m_a + first * m_stride, m_b + first * m_stride, m_c + first * m_stride, m_stride, count);
+        }
+
+    private:
+        constexpr CoefficientsView(const int* const aCoefficients, const int* const bCoefficients, const int* const cCoefficients,
+            const std::size_t stride, const std::size_t count) noexcept
+            : m_a(aCoefficients)
+            , m_b(bCoefficients)
+            , m_c(cCoefficients)
+            , m_stride(stride)
+            , m_count(count)
+        { }
+    };
+} // namespace slv
+
+#endif
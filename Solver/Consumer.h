@@ -2,6 +2,7 @@
  * @file Consumer.h
  *
  * @brief Consumer class for popping elements from shared thread-safe container.
+ *        When the shared container is closed and drained, the worker thread stops and the completion future becomes ready.
  *
  * @author Hovsep Papoyan
  * Contact: papoyanhovsep93@gmail.com
@@ -14,16 +15,22 @@
 
 #include "ProducerConsumerBase.h"
 
+#include <vector>
+
 namespace mt
 {
-    template<typename Adapter, typename Callable>
-    class Consumer : public ProducerConsumerBase<Adapter>
+    template<typename Adapter, typename Callable, typename WaitPolicy = SpinThenParkWaitPolicy<>>
+    class Consumer : public ProducerConsumerBase<Adapter, WaitPolicy>
     {
     private:
-        using Super = ProducerConsumerBase<Adapter>;
+        using Super = ProducerConsumerBase<Adapter, WaitPolicy>;
         using Elem = typename Adapter::Elem;
 
+        // Elements are popped in runs of up to this size, with one lock acquisition per run.
+        static constexpr std::size_t popBulkSize = 64;
+
         Callable m_callable;
+        std::vector<Elem> m_items; // The popped run, its buffer is reused.
 
     public:
         explicit Consumer(Adapter& sharedContainer, Callable callable);
@@ -37,32 +44,43 @@ namespace mt
         void workerThreadWork() override;
     };
 
-    template<typename Adapter, typename Callable>
-    Consumer<Adapter, Callable>::Consumer(Adapter& sharedContainer, Callable callable)
+    template<typename Adapter, typename Callable, typename WaitPolicy>
+    Consumer<Adapter, Callable, WaitPolicy>::Consumer(Adapter& sharedContainer, Callable callable)
         : Super(Super::Type::Consumer, sharedContainer)
         , m_callable(std::move(callable))
     {
         this->runMainThread();
     }
 
-    template<typename Adapter, typename Callable>
-    Consumer<Adapter, Callable>::~Consumer()
+    template<typename Adapter, typename Callable, typename WaitPolicy>
+    Consumer<Adapter, Callable, WaitPolicy>::~Consumer()
     {
         this->shutdownMainThread();
     }
 
-    template<typename Adapter, typename Callable>
-    void Consumer<Adapter, Callable>::workerThreadWork()
+    template<typename Adapter, typename Callable, typename WaitPolicy>
+    void Consumer<Adapter, Callable, WaitPolicy>::workerThreadWork()
     {
         while (this->m_workerThreadEnabled)
         {
-            if (Elem item; this->m_sharedContainer.tryPop(item))
+            // A run left by a failed callable is dropped, as a single failed element was.
+            const auto tryPopRun = [&]
+                {
+                    m_items.clear();
+                    return this->m_sharedContainer.tryPopBulk(m_items, popBulkSize) != 0;
+                };
+            if (this->waitForWork(this->m_sharedContainer, tryPopRun))
             {
-                m_callable(std::move_if_noexcept(item));
+                for (auto& item : m_items)
+                {
+                    m_callable(std::move_if_noexcept(item));
+                }
             }
-            else
+            else if (this->m_sharedContainer.isDrained())
             {
-                std::this_thread::yield();
+                // The shared container is closed and every element has been consumed.
+                this->complete();
+                return;
             }
         }
     }
@@ -0,0 +1,141 @@
+/**
+ * @file ConsumerPool.h
+ *
+ * @brief ConsumerPool class for popping elements from shared thread-safe container with several worker threads.
+ *        Every popped element is passed to the callable on one of the worker threads, its result is passed to the sink.
+ *        In Ordering::Input mode results reach the sink in the order their elements were popped, whatever order
+ *        The worker threads finish in. When the shared container is closed and drained, the worker threads stop
+ *        And the completion future becomes ready.
+ *
+ * @author Hovsep Papoyan
+ * Contact: papoyanhovsep93@gmail.com
+ * @Date 2024-03-28
+ *
+ */
+
+#ifndef CONSUMER_POOL_H
+#define CONSUMER_POOL_H
+
+#include "ProducerConsumerBase.h"
+#include "Sequencer.h"
+
+#include <thread>
+#include <type_traits>
+
+namespace mt
+{
+    // Sink of a ConsumerPool which doesn't need the results.
+    struct DiscardResults
+    {
+        template<typename... Args>
+        void operator()(Args&&...) const noexcept
+        { }
+    };
+
+    // The callable is called concurrently by all worker threads, so it must be thread-safe.
+    // The sink is never called concurrently, it is called by whichever worker thread has the next result.
+    template<typename Adapter, typename Callable, typename Sink = DiscardResults, typename WaitPolicy = SpinThenParkWaitPolicy<>>
+    class ConsumerPool : public ProducerConsumerBase<Adapter, WaitPolicy>
+    {
+    private:
+        using Super = ProducerConsumerBase<Adapter, WaitPolicy>;
+        using Elem = typename Adapter::Elem;
+        using Result = std::decay_t<std::invoke_result_t<Callable&, Elem&&>>;
+        static constexpr bool hasResults = !std::is_void_v<Result>;
+        using StoredResult = std::conditional_t<hasResults, Result, bool>;
+        static_assert(hasResults || std::is_same_v<Sink, DiscardResults>, "A sink needs results, Callable must not return void");
+
+        Callable m_callable;
+        Sink m_sink;
+
+        // Elements get sequence numbers in the order they are popped, under this mutex (Ordering::Input only).
+        std::mutex m_popMutex;
+        std::size_t m_poppedCount;
+
+        Sequencer<StoredResult> m_sequencer; // Passes results to the sink.
+
+    public:
+        // Results are discarded, elements are processed in any order.
+        explicit ConsumerPool(Adapter& sharedContainer, Callable callable,
+            const std::size_t workersCount = std::jthread::hardware_concurrency());
+        explicit ConsumerPool(Adapter& sharedContainer, Callable callable, Sink sink, const Ordering ordering,
+            const std::size_t workersCount = std::jthread::hardware_concurrency());
+        ConsumerPool(const ConsumerPool&) = delete;
+        ConsumerPool& operator=(const ConsumerPool&) = delete;
+        ~ConsumerPool() override;
+
+        [[nodiscard]] Ordering getOrdering() const noexcept { return m_sequencer.getOrdering(); }
+
+    private:
+        void workerThreadWork() override;
+        [[nodiscard]] bool tryPop(Elem& item, std::size_t& sequence);
+    };
+
+    template<typename Adapter, typename Callable, typename Sink, typename WaitPolicy>
+    ConsumerPool<Adapter, Callable, Sink, WaitPolicy>::ConsumerPool(Adapter& sharedContainer, Callable callable, const std::size_t workersCount)
+        : ConsumerPool(sharedContainer, std::move(callable), Sink{}, Ordering::Completion, workersCount)
+    { }
+
+    template<typename Adapter, typename Callable, typename Sink, typename WaitPolicy>
+    ConsumerPool<Adapter, Callable, Sink, WaitPolicy>::ConsumerPool(Adapter& sharedContainer, Callable callable, Sink sink,
+        const Ordering ordering, const std::size_t workersCount)
+        : Super(Super::Type::Consumer, sharedContainer, workersCount)
+        , m_callable(std::move(callable))
+        , m_sink(std::move(sink))
+        , m_poppedCount(0)
+        , m_sequencer(ordering)
+    {
+        this->runMainThread();
+    }
+
+    template<typename Adapter, typename Callable, typename Sink, typename WaitPolicy>
+    ConsumerPool<Adapter, Callable, Sink, WaitPolicy>::~ConsumerPool()
+    {
+        this->shutdownMainThread();
+    }
+
+    template<typename Adapter, typename Callable, typename Sink, typename WaitPolicy>
+    void ConsumerPool<Adapter, Callable, Sink, WaitPolicy>::workerThreadWork()
+    {
+        while (this->m_workerThreadEnabled)
+        {
+            Elem item;
+            std::size_t sequence = 0;
+            if (this->waitForWork(this->m_sharedContainer, [&] { return tryPop(item, sequence); }))
+            {
+                if constexpr (hasResults)
+                {
+                    m_sequencer.deliver(sequence, m_callable(std::move_if_noexcept(item)), m_sink);
+                }
+                else
+                {
+                    m_callable(std::move_if_noexcept(item));
+                }
+            }
+            else if (this->m_sharedContainer.isDrained())
+            {
+                // Every element has been popped, the other worker threads may still be processing theirs.
+                this->complete();
+                return;
+            }
+        }
+    }
+
+    template<typename Adapter, typename Callable, typename Sink, typename WaitPolicy>
+    bool ConsumerPool<Adapter, Callable, Sink, WaitPolicy>::tryPop(Elem& item, std::size_t& sequence)
+    {
+        if (getOrdering() == Ordering::Completion)
+        {
+            return this->m_sharedContainer.tryPop(item);
+        }
+        std::lock_guard<std::mutex> lock(m_popMutex);
+        if (!this->m_sharedContainer.tryPop(item))
+        {
+            return false;
+        }
+        sequence = m_poppedCount++;
+        return true;
+    }
+} // namespace mt
+
+#endif
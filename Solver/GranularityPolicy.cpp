@@ -0,0 +1,68 @@
+/**
+ * @file GranularityPolicy.cpp
+ *
+ * @brief GranularityPolicy class for choosing how a batch of equations is split into block tasks.
+ *
+ * @author Hovsep Papoyan
+ * Contact: papoyanhovsep93@gmail.com
+ * @Date 2024-03-28
+ *
+ */
+
+#include "GranularityPolicy.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace slv
+{
+    GranularityPolicy::GranularityPolicy(const std::size_t bytesPerEquation, const std::size_t threadsCount,
+        const double nanosecondsPerEquation) noexcept
+        : m_bytesPerEquation(std::max<std::size_t>(bytesPerEquation, 1))
+        , m_threadsCount(std::max<std::size_t>(threadsCount, 1))
+        , m_nanosecondsPerEquation(std::max(nanosecondsPerEquation, 0.1))
+    { }
+
+    GranularityPolicy::GranularityPolicy(const GranularityPolicy& other) noexcept
+        : m_bytesPerEquation(other.m_bytesPerEquation)
+        , m_threadsCount(other.m_threadsCount)
+        , m_nanosecondsPerEquation(other.getNanosecondsPerEquation())
+    { }
+
+    GranularityPolicy& GranularityPolicy::operator=(const GranularityPolicy& other) noexcept
+    {
+        m_bytesPerEquation = other.m_bytesPerEquation;
+        m_threadsCount = other.m_threadsCount;
+        m_nanosecondsPerEquation.store(other.getNanosecondsPerEquation(), std::memory_order_relaxed);
+        return *this;
+    }
+
+    GranularityPolicy::Plan GranularityPolicy::plan(const std::size_t equationsCount) const noexcept
+    {
+        const double minEquations = std::ceil(static_cast<double>(minBlockTime.count()) / getNanosecondsPerEquation());
+        const std::size_t minEquationsPerBlock = static_cast<std::size_t>(std::max(minEquations, 1.0));
+        const std::size_t maxEquationsPerBlock = std::max(cacheBytes / m_bytesPerEquation, minEquationsPerBlock);
+
+        const std::size_t maxBlocks = equationsCount / minEquationsPerBlock;
+        if (maxBlocks < 2)
+        {
+            return Plan{ 1, true };
+        }
+        const std::size_t cacheBlocks = (equationsCount + maxEquationsPerBlock - 1) / maxEquationsPerBlock;
+        const std::size_t blocksCount = std::min(std::max(m_threadsCount * blocksPerThread, cacheBlocks), maxBlocks);
+        return Plan{ blocksCount, false };
+    }
+
+    void GranularityPolicy::record(const std::size_t equationsCount, const std::chrono::nanoseconds busyTime) noexcept
+    {
+        if (equationsCount < minRecordedEquations)
+        {
+            return;
+        }
+        // Weight 1/4: a single disturbed batch (e.g. a preempted worker) moves the estimation only a little.
+        const double measured = static_cast<double>(busyTime.count()) / static_cast<double>(equationsCount);
+        // Concurrent records may overwrite each other, losing one sample of an average is harmless.
+        const double updated = std::max(0.75 * getNanosecondsPerEquation() + 0.25 * measured, 0.1);
+        m_nanosecondsPerEquation.store(updated, std::memory_order_relaxed);
+    }
+} // namespace slv
@@ -0,0 +1,63 @@
+/**
+ * @file GranularityPolicy.h
+ *
+ * @brief GranularityPolicy class for choosing how a batch of equations is split into block tasks.
+ *
+ * @author Hovsep Papoyan
+ * Contact: papoyanhovsep93@gmail.com
+ * @Date 2024-03-28
+ *
+ */
+
+#ifndef GRANULARITY_POLICY_H
+#define GRANULARITY_POLICY_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+namespace slv
+{
+    // Splits batches by the estimated cost of an equation instead of fixed counts:
+    // - A block should take at least minBlockTime, otherwise submitting and waking a worker costs more than it saves.
+    //   Batches which don't make two such blocks are solved inline, on the calling thread.
+    // - A block's coefficients and results should fit into cacheBytes, so formatting finds them still cached.
+    // - Otherwise there are blocksPerThread blocks per thread, so that stealing can rebalance uneven blocks.
+    // The cost starts from a calibration and follows measured block timings (exponential moving average).
+    // plan and record may be called concurrently, e.g. by batches in flight at the same time.
+    class GranularityPolicy
+    {
+    public:
+        struct Plan
+        {
+            std::size_t m_blocksCount; // Blocks of equal size, the first (equationsCount % m_blocksCount) get one more equation.
+            bool m_inline; // Solve on the calling thread, m_blocksCount is 1.
+        };
+
+        static constexpr std::chrono::nanoseconds minBlockTime{ 20'000 };
+        static constexpr std::size_t cacheBytes = 1024 * 1024;
+        static constexpr std::size_t blocksPerThread = 4;
+        // Shorter batches are not recorded, their timings are dominated by the clock and cache misses.
+        static constexpr std::size_t minRecordedEquations = 1024;
+
+    private:
+        std::size_t m_bytesPerEquation;
+        std::size_t m_threadsCount;
+        std::atomic<double> m_nanosecondsPerEquation;
+
+    public:
+        // bytesPerEquation is the memory of one equation's coefficients and results.
+        // threadsCount counts every thread executing blocks, including the calling one if it helps.
+        GranularityPolicy(const std::size_t bytesPerEquation, const std::size_t threadsCount, const double nanosecondsPerEquation) noexcept;
+        GranularityPolicy(const GranularityPolicy& other) noexcept;
+        GranularityPolicy& operator=(const GranularityPolicy& other) noexcept;
+
+        [[nodiscard]] Plan plan(const std::size_t equationsCount) const noexcept;
+        // Adds the measured time of solving equationsCount equations (the sum of all block times) to the estimation.
+        void record(const std::size_t equationsCount, const std::chrono::nanoseconds busyTime) noexcept;
+
+        [[nodiscard]] double getNanosecondsPerEquation() const noexcept { return m_nanosecondsPerEquation.load(std::memory_order_relaxed); }
+    };
+} // namespace slv
+
+#endif
@@ -12,39 +12,483 @@
  */
 
 #include "InputValidator.h"
+#include "ThreadPool.h"
 
-#include <charconv>
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <future>
 #include <iomanip>
 #include <iostream>
 #include <limits>
-#include <string_view>
 
-std::optional<std::vector<int>> InputValidator::getValidatedInput(const int argc, const char* const argv[])
+namespace
 {
-    if (argc < 4 || (argc - 1) % 3 != 0)
+    [[nodiscard]] constexpr bool isSpace(const char ch) noexcept
+    {
+        return ch == ' ' || ch == '\n' || ch == '\t' || ch == '\r' || ch == '\v' || ch == '\f';
+    }
+
+    [[nodiscard]] constexpr bool isDigit(const char ch) noexcept
+    {
+        return ch >= '0' && ch <= '9';
+    }
+
+    // Size of blocks read from a file stream.
+    constexpr std::size_t readBlockSize = std::size_t(1) << 20;
+    // Text is parsed in parallel by segments of about this size, smaller texts are parsed serially.
+    constexpr std::size_t parallelSegmentSize = std::size_t(1) << 20;
+    // Arguments are parsed in parallel by ranges of this count, if there are at least two ranges.
+    constexpr std::size_t parallelArgumentsCount = std::size_t(1) << 16;
+
+    // 8 characters in one word, the first one in the lowest byte (little endian only).
+    [[nodiscard]] std::uint64_t loadWord(const char* const p) noexcept
+    {
+        std::uint64_t word;
+        std::memcpy(&word, p, sizeof(word));
+        return word;
+    }
+
+    // True if every byte of word is a digit: its high nibble is 3 and it is still below 0x40 after adding 6.
+    [[nodiscard]] constexpr bool areDigits(const std::uint64_t word) noexcept
+    {
+        return ((word & 0xF0F0F0F0F0F0F0F0) | (((word + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) == 0x3333333333333333;
+    }
+
+    // Value of 8 digits loaded by loadWord, combines pairs of digits, then pairs of pairs and so on.
+    [[nodiscard]] constexpr std::uint64_t getDigitsValue(std::uint64_t word) noexcept
+    {
+        word = (word & 0x0F0F0F0F0F0F0F0F) * 2561 >> 8;
+        word = (word & 0x00FF00FF00FF00FF) * 6553601 >> 16;
+        return (word & 0x0000FFFF0000FFFF) * 42949672960001 >> 32;
+    }
+
+    // Parses the token at pos, which ends at the next space or at end, and moves pos past it. Returns std::nullopt for an invalid token.
+    // A valid token is an int accepted by std::from_chars as a whole, without leading zeros unless it is negative, and not -0:
+    // 0, 7, -7 and -07 are valid, 00, 07, -0, +7, 0x7 and 2147483648 are not.
+    [[nodiscard]] std::optional<int> parseToken(const char*& pos, const char* const end) noexcept
+    {
+        const char* p = pos;
+        const bool isNegative = p != end && *p == '-';
+        if (isNegative)
+        {
+            ++p;
+        }
+        const char* const digits = p;
+        if (isNegative)
+        {
+            // std::from_chars skips them, only a resulting 0 is rejected.
+            while (p != end && *p == '0')
+            {
+                ++p;
+            }
+        }
+        const char* const significantDigits = p;
+        std::uint64_t value = 0;
+        if constexpr (std::endian::native == std::endian::little)
+        {
+            // More than 10 significant digits never fit, so two words are enough to know.
+            while (end - p >= 8 && p - significantDigits <= 8 && areDigits(loadWord(p)))
+            {
+                value = value * 100000000 + getDigitsValue(loadWord(p));
+                p += 8;
+            }
+        }
+        while (p != end && isDigit(*p))
+        {
+            if (p - significantDigits <= 10)
+            {
+                value = value * 10 + static_cast<std::uint64_t>(*p - '0');
+            }
+            ++p;
+        }
+        const std::ptrdiff_t significantDigitsCount = p - significantDigits;
+        const bool isValid = (p == end || isSpace(*p)) && p != digits
+            && (isNegative ? significantDigitsCount != 0 : *digits != '0' || p - digits == 1)
+            && significantDigitsCount <= 10
+            && value <= static_cast<std::uint64_t>(std::numeric_limits<int>::max()) + (isNegative ? 1 : 0);
+        while (p != end && !isSpace(*p))
+        {
+            ++p;
+        }
+        pos = p;
+        if (!isValid)
+        {
+            return std::nullopt;
+        }
+        return static_cast<int>(isNegative ? -static_cast<std::int64_t>(value) : static_cast<std::int64_t>(value));
+    }
+
+    // Parses a whole token, e.g. a command line argument, spaces included.
+    [[nodiscard]] std::optional<int> parseCoefficient(const std::string_view token) noexcept
+    {
+        const char* pos = token.data();
+        const char* const end = pos + token.size();
+        const std::optional<int> coefficient = parseToken(pos, end);
+        return pos == end ? coefficient : std::nullopt;
+    }
+
+    struct ParsedSegment
+    {
+        std::vector<int> m_coefficients;
+        std::optional<std::string_view> m_invalidToken; // Parsing stops at the first invalid token.
+    };
+
+    // Parses all tokens of segment, which starts and ends at token boundaries.
+    [[nodiscard]] ParsedSegment parseSegment(const std::string_view segment)
+    {
+        ParsedSegment parsed;
+        parsed.m_coefficients.reserve(segment.size() / 4);
+        const char* pos = segment.data();
+        const char* const end = pos + segment.size();
+        while (true)
+        {
+            while (pos != end && isSpace(*pos))
+            {
+                ++pos;
+            }
+            if (pos == end)
+            {
+                return parsed;
+            }
+            const char* const token = pos;
+            const std::optional<int> coefficient = parseToken(pos, end);
+            if (!coefficient)
+            {
+                parsed.m_invalidToken = std::string_view(token, static_cast<std::size_t>(pos - token));
+                return parsed;
+            }
+            parsed.m_coefficients.push_back(*coefficient);
+        }
+    }
+
+    // End of the segment starting at begin: about parallelSegmentSize characters later at a space, or size.
+    [[nodiscard]] std::size_t getSegmentEnd(const std::string_view text, const std::size_t begin, const std::size_t size) noexcept
+    {
+        std::size_t end = size - begin > parallelSegmentSize ? begin + parallelSegmentSize : size;
+        while (end != size && !isSpace(text[end]))
+        {
+            ++end;
+        }
+        return end;
+    }
+
+    // Segments parsed at once. Only their coefficients are kept besides the chunk, so memory doesn't grow with the input.
+    [[nodiscard]] std::size_t getWindowSegmentsCount(const mt::ThreadPool& threadPool) noexcept
+    {
+        return 2 * threadPool.getThreadsCount();
+    }
+} // namespace
+
+// Accumulates validated coefficients and hands them over by chunks.
+class InputValidator::ChunkBuilder
+{
+private:
+    const ChunkHandler& m_handler;
+    std::size_t m_coefficientsPerEquation;
+    std::size_t m_chunkSize;
+    std::size_t m_count;
+    std::vector<int> m_chunk;
+
+public:
+    ChunkBuilder(const std::size_t chunkSize, const ChunkHandler& handler, const std::size_t coefficientsPerEquation)
+        : m_handler(handler)
+        , m_coefficientsPerEquation(coefficientsPerEquation)
+        // Chunks must contain whole equations.
+        , m_chunkSize(chunkSize < coefficientsPerEquation ? coefficientsPerEquation : chunkSize / coefficientsPerEquation * coefficientsPerEquation)
+        , m_count(0)
+    {
+        m_chunk.reserve(m_chunkSize);
+    }
+
+    // Validates all whitespace separated tokens of text.
+    // If isLast is false, a token touching the end of text is not consumed, as it may continue in the next block.
+    // Returns count of consumed characters or std::nullopt on invalid token.
+    [[nodiscard]] std::optional<std::size_t> add(const std::string_view text, const bool isLast)
+    {
+        std::size_t pos = 0;
+        const std::size_t sz = text.size();
+        while (true)
+        {
+            while (pos != sz && isSpace(text[pos]))
+            {
+                ++pos;
+            }
+            if (pos == sz)
+            {
+                return pos;
+            }
+            const char* tokenEnd = text.data() + pos;
+            const std::optional<int> coefficient = parseToken(tokenEnd, text.data() + sz);
+            const std::size_t tokenSize = static_cast<std::size_t>(tokenEnd - (text.data() + pos));
+            if (pos + tokenSize == sz && !isLast)
+            {
+                return pos;
+            }
+            if (!coefficient)
+            {
+                reportInvalidCoefficient(text.substr(pos, tokenSize));
+                return std::nullopt;
+            }
+            push(*coefficient);
+            pos += tokenSize;
+        }
+    }
+
+    // Same as above, but a window of segments of text is parsed on threadPool at a time, then their coefficients are pushed in order.
+    [[nodiscard]] std::optional<std::size_t> add(const std::string_view text, const bool isLast, mt::ThreadPool& threadPool)
+    {
+        std::size_t size = text.size();
+        if (!isLast)
+        {
+            while (size != 0 && !isSpace(text[size - 1]))
+            {
+                --size;
+            }
+        }
+        if (size <= parallelSegmentSize)
+        {
+            return add(text, isLast);
+        }
+        const std::size_t windowSegmentsCount = getWindowSegmentsCount(threadPool);
+        std::vector<std::future<ParsedSegment>> segments;
+        std::size_t pos = 0;
+        while (pos != size)
+        {
+            segments.clear();
+            while (segments.size() != windowSegmentsCount && pos != size)
+            {
+                const std::size_t segmentEnd = getSegmentEnd(text, pos, size);
+                segments.push_back(threadPool.submit([segment = text.substr(pos, segmentEnd - pos)] { return parseSegment(segment); }));
+                pos = segmentEnd;
+            }
+            // No segment may still be reading text once the builder returns, even on failure.
+            for (const std::future<ParsedSegment>& segment : segments)
+            {
+                threadPool.waitFor(segment);
+            }
+            for (std::future<ParsedSegment>& segment : segments)
+            {
+                const ParsedSegment parsed = segment.get();
+                push(parsed.m_coefficients);
+                if (parsed.m_invalidToken)
+                {
+                    reportInvalidCoefficient(*parsed.m_invalidToken);
+                    return std::nullopt;
+                }
+            }
+        }
+        return size;
+    }
+
+    [[nodiscard]] bool finish()
+    {
+        if (!validateCoefficientsCount(m_count, m_coefficientsPerEquation))
+        {
+            return false;
+        }
+        if (!m_chunk.empty())
+        {
+            flush();
+        }
+        return true;
+    }
+
+private:
+    void push(const int coefficient)
+    {
+        m_chunk.push_back(coefficient);
+        ++m_count;
+        if (m_chunk.size() == m_chunkSize)
+        {
+            flush();
+        }
+    }
+
+    void push(const std::vector<int>& coefficients)
+    {
+        auto first = coefficients.begin();
+        while (first != coefficients.end())
+        {
+            const std::size_t count = std::min(static_cast<std::size_t>(coefficients.end() - first), m_chunkSize - m_chunk.size());
+            m_chunk.insert(m_chunk.end(), first, first + static_cast<std::ptrdiff_t>(count));
+            m_count += count;
+            first += static_cast<std::ptrdiff_t>(count);
+            if (m_chunk.size() == m_chunkSize)
+            {
+                flush();
+            }
+        }
+    }
+
+    void flush()
+    {
+        std::vector<int> chunk;
+        chunk.reserve(m_chunkSize);
+        m_chunk.swap(chunk);
+        m_handler(std::move(chunk));
+    }
+};
+
+std::optional<std::vector<int>> InputValidator::getValidatedInput(const int argc, const char* const argv[],
+    const std::size_t coefficientsPerEquation)
+{
+    if (!validateCoefficientsCount(static_cast<std::size_t>(argc > 0 ? argc - 1 : 0), coefficientsPerEquation))
     {
-        // Minimum 3 arguments are needed except the first one (program name).
-        // Provided arguments count must be multiple of 3.
-        std::cerr << "Please provide enough arguments\n";
         return std::nullopt;
     }
     std::vector<int> validatedInput;
     validatedInput.reserve(static_cast<std::size_t>(argc) - 1);
-    for (const std::string_view arg : std::vector<std::string_view>(argv + 1, argv + argc))
-    {
-        int result;
-        const char* const last = arg.data() + arg.size();
-        auto [ptr, ec] = std::from_chars(arg.data(), last, result);
-
-        if (ec != std::errc() || ptr != last
-            || (result == 0 && arg.size() > 1) || (result != 0 && arg[0] == '0'))
-        {            
-            // reporting "is not an int" in case of diapason violation also. 
-            std::cerr << std::quoted(arg) << " is not an int ["
-                << std::numeric_limits<int>::min() << ',' << std::numeric_limits<int>::max() << "]\n";
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::optional<int> coefficient = validateCoefficient(argv[i]);
+        if (!coefficient)
+        {
+            return std::nullopt;
+        }
+        validatedInput.push_back(*coefficient);
+    }
+    return validatedInput;
+}
+
+std::optional<std::vector<int>> InputValidator::getValidatedInput(const int argc, const char* const argv[], mt::ThreadPool& threadPool,
+    const std::size_t coefficientsPerEquation)
+{
+    const std::size_t count = static_cast<std::size_t>(argc > 0 ? argc - 1 : 0);
+    if (count < 2 * parallelArgumentsCount)
+    {
+        return getValidatedInput(argc, argv, coefficientsPerEquation);
+    }
+    if (!validateCoefficientsCount(count, coefficientsPerEquation))
+    {
+        return std::nullopt;
+    }
+    // Every range fills its own part of validatedInput and returns the index of its first invalid argument, or count.
+    std::vector<int> validatedInput(count);
+    std::vector<std::future<std::size_t>> ranges;
+    for (std::size_t begin = 0; begin < count; begin += parallelArgumentsCount)
+    {
+        const std::size_t end = std::min(begin + parallelArgumentsCount, count);
+        ranges.push_back(threadPool.submit([&validatedInput, argv, begin, end, count]
+            {
+                for (std::size_t i = begin; i != end; ++i)
+                {
+                    const std::optional<int> coefficient = parseCoefficient(argv[i + 1]);
+                    if (!coefficient)
+                    {
+                        return i;
+                    }
+                    validatedInput[i] = *coefficient;
+                }
+                return count;
+            }));
+    }
+    for (const std::future<std::size_t>& range : ranges)
+    {
+        threadPool.waitFor(range);
+    }
+    for (std::future<std::size_t>& range : ranges)
+    {
+        const std::size_t invalidIndex = range.get();
+        if (invalidIndex != count)
+        {
+            reportInvalidCoefficient(argv[invalidIndex + 1]);
             return std::nullopt;
         }
-        validatedInput.push_back(result);
     }
     return validatedInput;
 }
+
+bool InputValidator::getValidatedInput(const std::string_view text, const std::size_t chunkSize, const ChunkHandler& handler,
+    const std::size_t coefficientsPerEquation)
+{
+    ChunkBuilder builder(chunkSize, handler, coefficientsPerEquation);
+    return builder.add(text, true) && builder.finish();
+}
+
+bool InputValidator::getValidatedInput(const std::string_view text, const std::size_t chunkSize, const ChunkHandler& handler,
+    mt::ThreadPool& threadPool, const std::size_t coefficientsPerEquation)
+{
+    ChunkBuilder builder(chunkSize, handler, coefficientsPerEquation);
+    return builder.add(text, true, threadPool) && builder.finish();
+}
+
+bool InputValidator::getValidatedInput(std::FILE* const file, const std::size_t chunkSize, const ChunkHandler& handler,
+    const std::size_t coefficientsPerEquation)
+{
+    return getValidatedInput(file, chunkSize, handler, nullptr, coefficientsPerEquation);
+}
+
+bool InputValidator::getValidatedInput(std::FILE* const file, const std::size_t chunkSize, const ChunkHandler& handler,
+    mt::ThreadPool& threadPool, const std::size_t coefficientsPerEquation)
+{
+    return getValidatedInput(file, chunkSize, handler, &threadPool, coefficientsPerEquation);
+}
+
+bool InputValidator::getValidatedInput(std::FILE* const file, const std::size_t chunkSize, const ChunkHandler& handler,
+    mt::ThreadPool* const threadPool, const std::size_t coefficientsPerEquation)
+{
+    ChunkBuilder builder(chunkSize, handler, coefficientsPerEquation);
+    // A parallel block holds a window of segments.
+    const std::size_t blockSize = threadPool ? std::max(readBlockSize, parallelSegmentSize * getWindowSegmentsCount(*threadPool)) : readBlockSize;
+    // Unconsumed tail of the previous block (a token split between blocks) is kept at the front of the buffer.
+    std::vector<char> buffer(blockSize);
+    std::size_t tailSize = 0;
+    while (true)
+    {
+        if (buffer.size() - tailSize < blockSize)
+        {
+            buffer.resize(tailSize + blockSize);
+        }
+        const std::size_t readSize = std::fread(buffer.data() + tailSize, 1, blockSize, file);
+        const bool isLast = readSize < blockSize;
+        const std::size_t dataSize = tailSize + readSize;
+        const std::string_view data(buffer.data(), dataSize);
+        const std::optional<std::size_t> consumed = threadPool ? builder.add(data, isLast, *threadPool) : builder.add(data, isLast);
+        if (!consumed)
+        {
+            return false;
+        }
+        if (isLast)
+        {
+            if (std::ferror(file))
+            {
+                std::cerr << "Can't read the input\n";
+                return false;
+            }
+            return builder.finish();
+        }
+        tailSize = dataSize - *consumed;
+        std::copy(buffer.data() + *consumed, buffer.data() + dataSize, buffer.data());
+    }
+}
+
+std::optional<int> InputValidator::validateCoefficient(const std::string_view token)
+{
+    const std::optional<int> coefficient = parseCoefficient(token);
+    if (!coefficient)
+    {
+        reportInvalidCoefficient(token);
+    }
+    return coefficient;
+}
+
+void InputValidator::reportInvalidCoefficient(const std::string_view token)
+{
+    // reporting "is not an int" in case of diapason violation also. 
+    std::cerr << std::quoted(token) << " is not an int ["
+        << std::numeric_limits<int>::min() << ',' << std::numeric_limits<int>::max() << "]\n";
+}
+
+bool InputValidator::validateCoefficientsCount(const std::size_t count, const std::size_t coefficientsPerEquation)
+{
+    if (count < coefficientsPerEquation || count % coefficientsPerEquation != 0)
+    {
+        // Minimum coefficientsPerEquation coefficients are needed (for arguments, except the first one which is program name).
+        // Provided coefficients count must be multiple of coefficientsPerEquation.
+        std::cerr << "Please provide enough arguments\n";
+        return false;
+    }
+    return true;
+}
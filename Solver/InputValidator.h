@@ -3,7 +3,7 @@
  *
  * @brief InputValidator class for command line arguments validation.
  *        Arguments must be int values, which represents coefficients
- *        of quadratic equations.
+ *        of quadratic equations or of polynomials.
  *
  * @author Hovsep Papoyan
  * Contact: papoyanhovsep93@gmail.com
@@ -14,13 +14,63 @@
 #ifndef INPUT_VALIDATOR_H
 #define INPUT_VALIDATOR_H
 
+#include <cstdio>
+#include <functional>
 #include <optional>
+#include <string_view>
 #include <vector>
 
+namespace mt
+{
+    class ThreadPool;
+} // namespace mt
+
+// Tokens are parsed 8 digits at a time (SWAR) where they are long enough. The overloads taking a thread pool split large inputs
+// Into segments on token boundaries, parse the segments on the pool's workers and merge them in input order.
+// They hand over the same chunks and report the same first invalid token as the serial overloads.
 class InputValidator
 {
 public:
-    static [[nodiscard]] std::optional<std::vector<int>> getValidatedInput(const int argc, const char* const argv[]);
+    // Receives validated coefficients, chunk size is a multiple of coefficientsPerEquation.
+    using ChunkHandler = std::function<void(std::vector<int>)>;
+
+    // 3 * 2^20 coefficients (12 MiB) per chunk.
+    static constexpr std::size_t defaultChunkSize = 3 * (std::size_t(1) << 20);
+
+    // coefficientsPerEquation is 3 for quadratic equations, degree + 1 for polynomials (see PolynomialSolver.h).
+    // Count of coefficients must be a non-zero multiple of it.
+    [[nodiscard]] static std::optional<std::vector<int>> getValidatedInput(const int argc, const char* const argv[],
+        const std::size_t coefficientsPerEquation = 3);
+    [[nodiscard]] static std::optional<std::vector<int>> getValidatedInput(const int argc, const char* const argv[], mt::ThreadPool& threadPool,
+        const std::size_t coefficientsPerEquation = 3);
+
+    // Validates whitespace separated coefficients of text (e.g. a memory mapped file) with the same rules as for arguments.
+    // Every chunkSize validated coefficients are handed to handler as soon as they are parsed,
+    // So an invalid token is reported after the chunks preceding it were handled. Returns false on invalid input.
+    [[nodiscard]] static bool getValidatedInput(const std::string_view text, const std::size_t chunkSize, const ChunkHandler& handler,
+        const std::size_t coefficientsPerEquation = 3);
+    // Handler is called on the calling thread, while no segment is being parsed.
+    [[nodiscard]] static bool getValidatedInput(const std::string_view text, const std::size_t chunkSize, const ChunkHandler& handler,
+        mt::ThreadPool& threadPool, const std::size_t coefficientsPerEquation = 3);
+
+    // Same as above, but reads the text from file (e.g. stdin) in large blocks.
+    [[nodiscard]] static bool getValidatedInput(std::FILE* const file, const std::size_t chunkSize, const ChunkHandler& handler,
+        const std::size_t coefficientsPerEquation = 3);
+    [[nodiscard]] static bool getValidatedInput(std::FILE* const file, const std::size_t chunkSize, const ChunkHandler& handler,
+        mt::ThreadPool& threadPool, const std::size_t coefficientsPerEquation = 3);
+
+private:
+    class ChunkBuilder;
+
+    // Shared by the serial and the parallel versions, threadPool is nullptr for the serial ones.
+    [[nodiscard]] static bool getValidatedInput(std::FILE* const file, const std::size_t chunkSize, const ChunkHandler& handler,
+        mt::ThreadPool* const threadPool, const std::size_t coefficientsPerEquation);
+
+    // Parses one coefficient. Reports the error and returns std::nullopt if token is not a valid int.
+    [[nodiscard]] static std::optional<int> validateCoefficient(const std::string_view token);
+    static void reportInvalidCoefficient(const std::string_view token);
+    // Checks count of coefficients. Reports the error and returns false if it is not valid.
+    [[nodiscard]] static bool validateCoefficientsCount(const std::size_t count, const std::size_t coefficientsPerEquation);
 };
 
 #endif
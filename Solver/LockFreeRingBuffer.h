@@ -0,0 +1,674 @@
+/**
+ * @file LockFreeRingBuffer.h
+ *
+ * @brief SPSCRingBuffer and MPMCRingBuffer classes, lock-free bounded alternatives of ThreadSafeSTLAdapter.
+ *        Elements are stored inline in a preallocated ring, no allocation happens on push/pop.
+ *        Both provide push/pushAndNotify/pushFor/pushBulkFor/tryPop/tryPopBulk/waitAndPop/waitFor/notifyAll/close/isDrained,
+ *        So they can be used as Adapter of Producer and Consumer.
+ *
+ * @author Hovsep Papoyan
+ * Contact: papoyanhovsep93@gmail.com
+ * @Date 2024-03-28
+ *
+ */
+
+#ifndef LOCK_FREE_RING_BUFFER_H
+#define LOCK_FREE_RING_BUFFER_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mt
+{
+    // Separates indices written by different threads, to avoid false sharing.
+    inline constexpr std::size_t cacheLineSize = 64;
+
+    [[nodiscard]] constexpr std::size_t roundUpToPowerOfTwo(const std::size_t value) noexcept
+    {
+        std::size_t result = 2;
+        while (result < value)
+        {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    // Raw storage for one element, constructed and destroyed explicitly.
+    template<typename T>
+    struct RingSlot
+    {
+        alignas(T) unsigned char m_storage[sizeof(T)];
+
+        [[nodiscard]] T* get() noexcept { return std::launder(reinterpret_cast<T*>(m_storage)); }
+    };
+
+    // Lets consumers of a lock-free ring sleep while it is empty.
+    // Pushers pay only a fence and a load unless somebody actually sleeps.
+    class RingParking
+    {
+    private:
+        std::atomic<std::size_t> m_waitersCount;
+        std::mutex m_mutex;
+        std::condition_variable m_condVar;
+
+    public:
+        RingParking() noexcept
+            : m_waitersCount(0)
+        { }
+
+        // Sleeps until ready() returns true or timeout expires. ready() is evaluated under the parking lock.
+        template<typename Rep, typename Period, typename Predicate>
+        void waitFor(const std::chrono::duration<Rep, Period>& timeout, Predicate ready)
+        {
+            m_waitersCount.fetch_add(1);
+            // Pairs with the fence in notifyOne: either the pusher sees the waiter or ready() sees the pushed element.
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_condVar.wait_for(lock, timeout, ready);
+            }
+            m_waitersCount.fetch_sub(1);
+        }
+
+        // Called after an element has been published.
+        void notifyOne()
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (m_waitersCount.load(std::memory_order_relaxed) != 0)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                }
+                m_condVar.notify_one();
+            }
+        }
+
+        void notifyAll()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+            }
+            m_condVar.notify_all();
+        }
+    };
+
+    // Single producer, single consumer. Only one thread may push and only one thread may pop at a time.
+    template<typename T>
+    class SPSCRingBuffer
+    {
+    private:
+        const std::size_t m_mask;
+        const std::unique_ptr<RingSlot<T>[]> m_slots;
+        alignas(cacheLineSize) std::atomic<std::size_t> m_head; // Next index to pop, written by the consumer.
+        alignas(cacheLineSize) std::size_t m_cachedTail;        // Consumer's copy of m_tail, refreshed only when the ring looks empty.
+        alignas(cacheLineSize) std::atomic<std::size_t> m_tail; // Next index to push, written by the producer.
+        alignas(cacheLineSize) std::size_t m_cachedHead;        // Producer's copy of m_head, refreshed only when the ring looks full.
+        std::atomic<bool> m_closed;
+        RingParking m_parking;
+
+    public:
+        using Elem = T;
+
+        // Capacity is rounded up to a power of two.
+        explicit SPSCRingBuffer(const std::size_t capacity);
+        SPSCRingBuffer(const SPSCRingBuffer&) = delete;
+        SPSCRingBuffer(SPSCRingBuffer&&) = delete;
+        SPSCRingBuffer& operator=(const SPSCRingBuffer&) = delete;
+        SPSCRingBuffer& operator=(SPSCRingBuffer&&) = delete;
+        ~SPSCRingBuffer();
+
+        // Waits (yielding) while the ring is full.
+        void push(Elem value);
+        void pushAndNotify(Elem value);
+        // Returns false if the ring is full. value is moved from only on success.
+        [[nodiscard]] bool tryPush(Elem& value);
+        // Returns false if the ring is still full when timeout expires. value is moved from only on success.
+        template<typename Rep, typename Period>
+        [[nodiscard]] bool pushFor(Elem& value, const std::chrono::duration<Rep, Period>& timeout);
+        // Bulk variants of push, tryPush and pushFor, elements are moved from the range only if they are pushed.
+        // Return the iterator past the last pushed element.
+        template<typename ForwardIt>
+        void pushBulk(ForwardIt first, ForwardIt last);
+        template<typename ForwardIt>
+        [[nodiscard]] ForwardIt tryPushBulk(ForwardIt first, ForwardIt last);
+        template<typename ForwardIt, typename Rep, typename Period>
+        [[nodiscard]] ForwardIt pushBulkFor(ForwardIt first, ForwardIt last, const std::chrono::duration<Rep, Period>& timeout);
+
+        void waitAndPop(Elem& value);
+        bool tryPop(Elem& value);
+        // Appends up to maxCount elements to out, returns how many.
+        std::size_t tryPopBulk(std::vector<Elem>& out, const std::size_t maxCount);
+
+        // Blocks until the ring is not empty, stopWaiting() returns true or timeout expires.
+        template<typename Rep, typename Period, typename Predicate>
+        void waitFor(const std::chrono::duration<Rep, Period>& timeout, Predicate stopWaiting);
+        // Wakes all threads blocked in waitFor to reevaluate their stop conditions.
+        void notifyAll();
+
+        // Marks the end of input and wakes threads blocked in waitFor. Must be called after all pushes have returned.
+        void close();
+        [[nodiscard]] bool isClosed() const noexcept;
+        // True if the ring is closed and all its elements are popped.
+        [[nodiscard]] bool isDrained() const noexcept;
+
+        [[nodiscard]] bool empty() const noexcept;
+
+        [[nodiscard]] std::size_t capacity() const noexcept { return m_mask + 1; }
+    };
+
+    // Multiple producers, multiple consumers (D. Vyukov's bounded queue).
+    // Every cell carries a sequence number telling whether it is ready for the next push or the next pop.
+    template<typename T>
+    class MPMCRingBuffer
+    {
+    private:
+        struct Cell
+        {
+            std::atomic<std::size_t> m_sequence;
+            RingSlot<T> m_slot;
+        };
+
+        const std::size_t m_mask;
+        const std::unique_ptr<Cell[]> m_cells;
+        alignas(cacheLineSize) std::atomic<std::size_t> m_enqueuePos;
+        alignas(cacheLineSize) std::atomic<std::size_t> m_dequeuePos;
+        std::atomic<bool> m_closed;
+        RingParking m_parking;
+
+    public:
+        using Elem = T;
+
+        // Capacity is rounded up to a power of two.
+        explicit MPMCRingBuffer(const std::size_t capacity);
+        MPMCRingBuffer(const MPMCRingBuffer&) = delete;
+        MPMCRingBuffer(MPMCRingBuffer&&) = delete;
+        MPMCRingBuffer& operator=(const MPMCRingBuffer&) = delete;
+        MPMCRingBuffer& operator=(MPMCRingBuffer&&) = delete;
+        ~MPMCRingBuffer();
+
+        // Waits (yielding) while the ring is full.
+        void push(Elem value);
+        void pushAndNotify(Elem value);
+        // Returns false if the ring is full. value is moved from only on success.
+        [[nodiscard]] bool tryPush(Elem& value);
+        // Returns false if the ring is still full when timeout expires. value is moved from only on success.
+        template<typename Rep, typename Period>
+        [[nodiscard]] bool pushFor(Elem& value, const std::chrono::duration<Rep, Period>& timeout);
+        // Bulk variants of push, tryPush and pushFor, elements are moved from the range only if they are pushed.
+        // Return the iterator past the last pushed element.
+        template<typename ForwardIt>
+        void pushBulk(ForwardIt first, ForwardIt last);
+        template<typename ForwardIt>
+        [[nodiscard]] ForwardIt tryPushBulk(ForwardIt first, ForwardIt last);
+        template<typename ForwardIt, typename Rep, typename Period>
+        [[nodiscard]] ForwardIt pushBulkFor(ForwardIt first, ForwardIt last, const std::chrono::duration<Rep, Period>& timeout);
+
+        void waitAndPop(Elem& value);
+        bool tryPop(Elem& value);
+        // Appends up to maxCount elements to out, returns how many.
+        std::size_t tryPopBulk(std::vector<Elem>& out, const std::size_t maxCount);
+
+        // Blocks until the ring is not empty, stopWaiting() returns true or timeout expires.
+        template<typename Rep, typename Period, typename Predicate>
+        void waitFor(const std::chrono::duration<Rep, Period>& timeout, Predicate stopWaiting);
+        // Wakes all threads blocked in waitFor to reevaluate their stop conditions.
+        void notifyAll();
+
+        // Marks the end of input and wakes threads blocked in waitFor. Must be called after all pushes have returned.
+        void close();
+        [[nodiscard]] bool isClosed() const noexcept;
+        // True if the ring is closed and all its elements are popped.
+        [[nodiscard]] bool isDrained() const noexcept;
+
+        [[nodiscard]] bool empty() const noexcept;
+
+        [[nodiscard]] std::size_t capacity() const noexcept { return m_mask + 1; }
+    };
+
+    template<typename T>
+    SPSCRingBuffer<T>::SPSCRingBuffer(const std::size_t capacity)
+        : m_mask(roundUpToPowerOfTwo(capacity) - 1)
+        , m_slots(std::make_unique<RingSlot<T>[]>(m_mask + 1))
+        , m_head(0)
+        , m_cachedTail(0)
+        , m_tail(0)
+        , m_cachedHead(0)
+        , m_closed(false)
+    { }
+
+    template<typename T>
+    SPSCRingBuffer<T>::~SPSCRingBuffer()
+    {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        for (std::size_t head = m_head.load(std::memory_order_relaxed); head != tail; ++head)
+        {
+            std::destroy_at(m_slots[head & m_mask].get());
+        }
+    }
+
+    template<typename T>
+    void SPSCRingBuffer<T>::push(Elem value)
+    {
+        while (!tryPush(value))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    template<typename T>
+    void SPSCRingBuffer<T>::pushAndNotify(Elem value)
+    {
+        // Every successful push already wakes a parked consumer.
+        push(std::move_if_noexcept(value));
+    }
+
+    template<typename T>
+    template<typename Rep, typename Period>
+    bool SPSCRingBuffer<T>::pushFor(Elem& value, const std::chrono::duration<Rep, Period>& timeout)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (!tryPush(value))
+        {
+            if (std::chrono::steady_clock::now() >= deadline)
+            {
+                return false;
+            }
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+    template<typename T>
+    bool SPSCRingBuffer<T>::tryPush(Elem& value)
+    {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead > m_mask)
+        {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead > m_mask)
+            {
+                return false;
+            }
+        }
+        ::new (static_cast<void*>(m_slots[tail & m_mask].m_storage)) T(std::move_if_noexcept(value));
+        m_tail.store(tail + 1, std::memory_order_release);
+        m_parking.notifyOne();
+        return true;
+    }
+
+    template<typename T>
+    template<typename ForwardIt>
+    ForwardIt SPSCRingBuffer<T>::tryPushBulk(ForwardIt first, ForwardIt last)
+    {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        const std::size_t count = static_cast<std::size_t>(std::distance(first, last));
+        if (m_mask + 1 - (tail - m_cachedHead) < count)
+        {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+        }
+        const std::size_t pushCount = std::min(count, m_mask + 1 - (tail - m_cachedHead));
+        for (std::size_t i = 0; i != pushCount; ++i, ++first)
+        {
+            ::new (static_cast<void*>(m_slots[(tail + i) & m_mask].m_storage)) T(std::move_if_noexcept(*first));
+        }
+        if (pushCount != 0)
+        {
+            // The whole run is published at once.
+            m_tail.store(tail + pushCount, std::memory_order_release);
+            m_parking.notifyOne();
+        }
+        return first;
+    }
+
+    template<typename T>
+    template<typename ForwardIt>
+    void SPSCRingBuffer<T>::pushBulk(ForwardIt first, ForwardIt last)
+    {
+        while ((first = tryPushBulk(first, last)) != last)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    template<typename T>
+    template<typename ForwardIt, typename Rep, typename Period>
+    ForwardIt SPSCRingBuffer<T>::pushBulkFor(ForwardIt first, ForwardIt last, const std::chrono::duration<Rep, Period>& timeout)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while ((first = tryPushBulk(first, last)) != last && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::yield();
+        }
+        return first;
+    }
+
+    template<typename T>
+    void SPSCRingBuffer<T>::waitAndPop(Elem& value)
+    {
+        while (!tryPop(value))
+        {
+            waitFor(std::chrono::seconds(1), [] { return false; });
+        }
+    }
+
+    template<typename T>
+    bool SPSCRingBuffer<T>::tryPop(Elem& value)
+    {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cachedTail)
+        {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail)
+            {
+                return false;
+            }
+        }
+        T* const item = m_slots[head & m_mask].get();
+        value = std::move_if_noexcept(*item);
+        std::destroy_at(item);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    template<typename T>
+    std::size_t SPSCRingBuffer<T>::tryPopBulk(std::vector<Elem>& out, const std::size_t maxCount)
+    {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+        if (m_cachedTail - head < maxCount)
+        {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+        }
+        const std::size_t count = std::min(maxCount, m_cachedTail - head);
+        out.reserve(out.size() + count);
+        std::size_t poppedCount = 0;
+        try
+        {
+            for (; poppedCount != count; ++poppedCount)
+            {
+                T* const item = m_slots[(head + poppedCount) & m_mask].get();
+                out.push_back(std::move_if_noexcept(*item));
+                std::destroy_at(item);
+            }
+        }
+        catch (...)
+        {
+            m_head.store(head + poppedCount, std::memory_order_release);
+            throw;
+        }
+        // The whole run is released to the producer at once.
+        m_head.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    template<typename T>
+    MPMCRingBuffer<T>::MPMCRingBuffer(const std::size_t capacity)
+        : m_mask(roundUpToPowerOfTwo(capacity) - 1)
+        , m_cells(std::make_unique<Cell[]>(m_mask + 1))
+        , m_enqueuePos(0)
+        , m_dequeuePos(0)
+        , m_closed(false)
+    {
+        for (std::size_t i = 0; i <= m_mask; ++i)
+        {
+            m_cells[i].m_sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    template<typename T>
+    MPMCRingBuffer<T>::~MPMCRingBuffer()
+    {
+        const std::size_t enqueuePos = m_enqueuePos.load(std::memory_order_relaxed);
+        for (std::size_t pos = m_dequeuePos.load(std::memory_order_relaxed); pos != enqueuePos; ++pos)
+        {
+            std::destroy_at(m_cells[pos & m_mask].m_slot.get());
+        }
+    }
+
+    template<typename T>
+    void MPMCRingBuffer<T>::push(Elem value)
+    {
+        while (!tryPush(value))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    template<typename T>
+    void MPMCRingBuffer<T>::pushAndNotify(Elem value)
+    {
+        // Every successful push already wakes a parked consumer.
+        push(std::move_if_noexcept(value));
+    }
+
+    template<typename T>
+    template<typename Rep, typename Period>
+    bool MPMCRingBuffer<T>::pushFor(Elem& value, const std::chrono::duration<Rep, Period>& timeout)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (!tryPush(value))
+        {
+            if (std::chrono::steady_clock::now() >= deadline)
+            {
+                return false;
+            }
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+    template<typename T>
+    bool MPMCRingBuffer<T>::tryPush(Elem& value)
+    {
+        std::size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true)
+        {
+            cell = &m_cells[pos & m_mask];
+            const std::size_t sequence = cell->m_sequence.load(std::memory_order_acquire);
+            const std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0)
+            {
+                // The cell is free for position pos, try to claim it.
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                // The cell still holds the element pushed one lap ago: the ring is full.
+                return false;
+            }
+            else
+            {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        ::new (static_cast<void*>(cell->m_slot.m_storage)) T(std::move_if_noexcept(value));
+        cell->m_sequence.store(pos + 1, std::memory_order_release);
+        m_parking.notifyOne();
+        return true;
+    }
+
+    template<typename T>
+    template<typename ForwardIt>
+    ForwardIt MPMCRingBuffer<T>::tryPushBulk(ForwardIt first, ForwardIt last)
+    {
+        // Cells are claimed one by one, other producers may interleave.
+        while (first != last && tryPush(*first))
+        {
+            ++first;
+        }
+        return first;
+    }
+
+    template<typename T>
+    template<typename ForwardIt>
+    void MPMCRingBuffer<T>::pushBulk(ForwardIt first, ForwardIt last)
+    {
+        while ((first = tryPushBulk(first, last)) != last)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    template<typename T>
+    template<typename ForwardIt, typename Rep, typename Period>
+    ForwardIt MPMCRingBuffer<T>::pushBulkFor(ForwardIt first, ForwardIt last, const std::chrono::duration<Rep, Period>& timeout)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while ((first = tryPushBulk(first, last)) != last && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::yield();
+        }
+        return first;
+    }
+
+    template<typename T>
+    void MPMCRingBuffer<T>::waitAndPop(Elem& value)
+    {
+        while (!tryPop(value))
+        {
+            waitFor(std::chrono::seconds(1), [] { return false; });
+        }
+    }
+
+    template<typename T>
+    bool MPMCRingBuffer<T>::tryPop(Elem& value)
+    {
+        std::size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true)
+        {
+            cell = &m_cells[pos & m_mask];
+            const std::size_t sequence = cell->m_sequence.load(std::memory_order_acquire);
+            const std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0)
+            {
+                // The cell holds the element of position pos, try to claim it.
+                if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                // The cell is not filled yet: the ring is empty.
+                return false;
+            }
+            else
+            {
+                pos = m_dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+        T* const item = cell->m_slot.get();
+        value = std::move_if_noexcept(*item);
+        std::destroy_at(item);
+        // Makes the cell free for the push of the next lap.
+        cell->m_sequence.store(pos + m_mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    template<typename T>
+    std::size_t MPMCRingBuffer<T>::tryPopBulk(std::vector<Elem>& out, const std::size_t maxCount)
+    {
+        // Cells are claimed one by one, other consumers may interleave.
+        std::size_t poppedCount = 0;
+        for (Elem value; poppedCount != maxCount && tryPop(value); ++poppedCount)
+        {
+            out.push_back(std::move_if_noexcept(value));
+        }
+        return poppedCount;
+    }
+
+    template<typename T>
+    template<typename Rep, typename Period, typename Predicate>
+    void SPSCRingBuffer<T>::waitFor(const std::chrono::duration<Rep, Period>& timeout, Predicate stopWaiting)
+    {
+        m_parking.waitFor(timeout, [&] { return !empty() || isClosed() || stopWaiting(); });
+    }
+
+    template<typename T>
+    void SPSCRingBuffer<T>::notifyAll()
+    {
+        m_parking.notifyAll();
+    }
+
+    template<typename T>
+    void SPSCRingBuffer<T>::close()
+    {
+        m_closed.store(true, std::memory_order_release);
+        m_parking.notifyAll();
+    }
+
+    template<typename T>
+    bool SPSCRingBuffer<T>::isClosed() const noexcept
+    {
+        return m_closed.load(std::memory_order_acquire);
+    }
+
+    template<typename T>
+    bool SPSCRingBuffer<T>::isDrained() const noexcept
+    {
+        // Pushes happen before close, so once closed is seen all pushed elements are visible.
+        return isClosed() && empty();
+    }
+
+    template<typename T>
+    bool SPSCRingBuffer<T>::empty() const noexcept
+    {
+        return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+    }
+
+    template<typename T>
+    template<typename Rep, typename Period, typename Predicate>
+    void MPMCRingBuffer<T>::waitFor(const std::chrono::duration<Rep, Period>& timeout, Predicate stopWaiting)
+    {
+        m_parking.waitFor(timeout, [&] { return !empty() || isClosed() || stopWaiting(); });
+    }
+
+    template<typename T>
+    void MPMCRingBuffer<T>::notifyAll()
+    {
+        m_parking.notifyAll();
+    }
+
+    template<typename T>
+    void MPMCRingBuffer<T>::close()
+    {
+        m_closed.store(true, std::memory_order_release);
+        m_parking.notifyAll();
+    }
+
+    template<typename T>
+    bool MPMCRingBuffer<T>::isClosed() const noexcept
+    {
+        return m_closed.load(std::memory_order_acquire);
+    }
+
+    template<typename T>
+    bool MPMCRingBuffer<T>::isDrained() const noexcept
+    {
+        // Pushes happen before close, so once closed is seen all pushed elements are visible.
+        return isClosed() && empty();
+    }
+
+    template<typename T>
+    bool MPMCRingBuffer<T>::empty() const noexcept
+    {
+        return m_dequeuePos.load(std::memory_order_acquire) == m_enqueuePos.load(std::memory_order_acquire);
+    }
+} // namespace mt
+
+#endif
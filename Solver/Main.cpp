@@ -9,32 +9,318 @@
  *
  */
 
+#include "BinaryCoefficientsFile.h"
 #include "Consumer.h"
 #include "InputValidator.h"
+#include "MappedFile.h"
+#include "ParallelPolynomialSolver.h"
 #include "ParallelSolver.h"
 #include "Producer.h"
+#include "ResultCache.h"
+#include "Statistics.h"
+#include "ThreadPool.h"
+#include "Topology.h"
 
-int main(int argc, char* argv[])
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+namespace
 {
-    try
+    // Leading command line options.
+    struct Options
+    {
+        std::string_view m_precision; // Empty means SOLVER_FLOAT_TYPE.
+        std::size_t m_degree = 2; // 2 is solved by BasicParallelSolver, other degrees by BasicParallelPolynomialSolver.
+        std::size_t m_cacheCapacity = 0; // 0 disables the result cache.
+        mt::ThreadPool::Affinity m_affinity = mt::ThreadPool::Affinity::None;
+    };
+
+    // Validated chunks go straight to the solver, results are streamed block by block.
+    // This way multi-GB inputs are solved without building a giant argv or keeping all coefficients or results at once.
+    template<typename T>
+    [[nodiscard]] InputValidator::ChunkHandler makeChunkSolver(slv::BasicParallelSolver<T>& pSolver)
+    {
+        return [&pSolver](std::vector<int> chunk)
+            {
+                pSolver.stream(slv::CoefficientsView::fromInterleaved(chunk.data(), chunk.size() / 3), stdout);
+            };
+    }
+
+    // Solves and prints polynomials of the given degree (except 2), from the same inputs as run.
+    // Blocks are written as soon as they and the blocks before them are solved, results are not kept.
+    template<typename T>
+    void runPolynomials(int argc, char* argv[], const std::size_t degree, mt::ThreadPool& threadPool)
     {
-        if (auto validatedInput = InputValidator::getValidatedInput(argc, argv))
+        slv::BasicParallelPolynomialSolver<T> pSolver(threadPool);
+        const auto solveChunk = [&pSolver, degree](std::vector<int> chunk)
+            {
+                pSolver.stream(slv::PolynomialsView(chunk.data(), chunk.size() / (degree + 1), degree), stdout);
+            };
+        if (argc == 3 && std::strcmp(argv[1], "--file") == 0)
+        {
+            const MappedFile file(argv[2]);
+            if (InputValidator::getValidatedInput(file.getView(), InputValidator::defaultChunkSize, solveChunk, threadPool, degree + 1))
+            {
+                std::cout << std::endl;
+            }
+        }
+        else if (argc == 3 && std::strcmp(argv[1], "--binary") == 0)
+        {
+            std::cerr << "Binary input holds quadratic equations only, use --degree 2" << std::endl;
+        }
+        else if (argc == 2 && std::strcmp(argv[1], "--stdin") == 0)
+        {
+            if (InputValidator::getValidatedInput(stdin, InputValidator::defaultChunkSize, solveChunk, threadPool, degree + 1))
+            {
+                std::cout << std::endl;
+            }
+        }
+        else if (auto validatedInput = InputValidator::getValidatedInput(argc, argv, threadPool, degree + 1))
+        {
+            solveChunk(std::move(validatedInput.value()));
+            std::cout << std::endl;
+        }
+    }
+
+    // Solves and prints the input given by command line arguments with results of type T.
+    // A non-zero cache capacity enables the result cache, its statistics are printed to stderr.
+    // With an affinity the solver gets its own pinned pool, one worker per CPU, the detected topology is printed to stderr.
+    template<typename T>
+    void run(int argc, char* argv[], const Options& options)
+    {
+        std::unique_ptr<slv::ResultCache<T>> cache;
+        if (options.m_cacheCapacity != 0)
+        {
+            cache = std::make_unique<slv::ResultCache<T>>(options.m_cacheCapacity);
+        }
+        std::unique_ptr<mt::ThreadPool> pinnedPool;
+        if (options.m_affinity != mt::ThreadPool::Affinity::None)
+        {
+            const mt::Topology& topology = mt::Topology::get();
+            std::cerr << "TOPOLOGY: " << topology << std::endl;
+            pinnedPool = std::make_unique<mt::ThreadPool>(topology.getCpusCount(), options.m_affinity);
+        }
+        // Coefficients are parsed in parallel by the same workers which solve them.
+        mt::ThreadPool& threadPool = pinnedPool ? *pinnedPool : mt::ThreadPool::getDefault();
+        if (options.m_degree != 2)
+        {
+            runPolynomials<T>(argc, argv, options.m_degree, threadPool);
+            return;
+        }
+        slv::BasicParallelSolver<T> pSolver(threadPool);
+        pSolver.setCache(cache.get());
+
+        if (argc == 3 && std::strcmp(argv[1], "--file") == 0)
+        {
+            // Usage: Solver --file <path>. Coefficients are whitespace separated.
+            const MappedFile file(argv[2]);
+            if (InputValidator::getValidatedInput(file.getView(), InputValidator::defaultChunkSize, makeChunkSolver(pSolver), threadPool))
+            {
+                std::cout << std::endl;
+            }
+        }
+        else if (argc == 3 && std::strcmp(argv[1], "--binary") == 0)
+        {
+            // Usage: Solver --binary <path>. See BinaryCoefficientsFile.h for the format.
+            // Coefficients are solved right from the mapped file, without parsing or copying.
+            // Every block is written once it and the blocks before it are solved, results are not kept.
+            if (const auto file = BinaryCoefficientsFile::open(argv[2]))
+            {
+                pSolver.stream(file->getCoefficients(), stdout);
+                std::cout << std::endl;
+            }
+        }
+        else if (argc == 2 && std::strcmp(argv[1], "--stdin") == 0)
+        {
+            // Usage: Solver --stdin. Coefficients are whitespace separated.
+            if (InputValidator::getValidatedInput(stdin, InputValidator::defaultChunkSize, makeChunkSolver(pSolver), threadPool))
+            {
+                std::cout << std::endl;
+            }
+        }
+        else if (auto validatedInput = InputValidator::getValidatedInput(argc, argv, threadPool))
         {
-            slv::ParallelSolver pSolver;
             {
                 // Creating thread-safe STL adapter (thread-safe queue) from non thread-safe original STL adapter.
                 auto sharedContainer = mt::createThreadSafeSTLAdapterFrom(std::queue<std::vector<int>>{});
+                sharedContainer.enableStatistics();
                 // Producer and consumer instances will work with this sharedContainer.
                 mt::Producer producer(sharedContainer);
                 mt::Consumer consumer(sharedContainer, std::ref(pSolver));
+                const std::shared_future<void> consumed = consumer.getCompletionFuture();
                 producer.enableWorkerThread();
                 consumer.enableWorkerThread();
                 producer.push({ std::move(validatedInput.value()) });
-                // This sleep is necessary to prolong the life of the producer and consumer,
-                // Otherwise after pushing validatedInput may not have time to get into sharedContainer.
-                std::this_thread::sleep_for(std::chrono::milliseconds(200));
+                // The producer closes sharedContainer after pushing everything, the consumer completes once it is drained.
+                // Waiting for that keeps producer and consumer alive exactly as long as needed, failures are rethrown here.
+                producer.close();
+                consumed.get();
+            }
+            pSolver.write(stdout);
+            std::cout << std::endl;
+        }
+
+        if (cache)
+        {
+            const typename slv::ResultCache<T>::Statistics statistics = cache->getStatistics();
+            std::cerr << "CACHE: " << statistics.m_hits << " hits, " << statistics.m_misses << " misses, "
+                << statistics.m_evictions << " evictions, " << statistics.m_size << " entries" << std::endl;
+        }
+    }
+
+    // Instantiates run for the floating type named by options.m_precision.
+    void runWithPrecision(int argc, char* argv[], const Options& options)
+    {
+        const std::string_view precision = options.m_precision;
+        if (precision.empty())
+        {
+            run<slv::Solver::Float>(argc, argv, options);
+        }
+        else if (precision == "float")
+        {
+            run<float>(argc, argv, options);
+        }
+        else if (precision == "double")
+        {
+            run<double>(argc, argv, options);
+        }
+        else if (precision == "long-double")
+        {
+            run<long double>(argc, argv, options);
+        }
+        else
+        {
+            std::cerr << "Unknown precision " << precision << ", expected float, double or long-double" << std::endl;
+        }
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        // Leading options, the remaining arguments select the input (see run):
+        // --precision float|double|long-double  Floating type of results, SOLVER_FLOAT_TYPE if not given.
+        // --degree 1|2|3|4                      Degree of the polynomials, every one has degree + 1 coefficients (2 by default).
+        // --cache <capacity>                    Reuse results of repeated equations across batches.
+        // --affinity none|core|node             Pin solver workers to CPUs or NUMA nodes, with node-local block memory.
+        // --stats on|off                        Collect mt::Statistics, print them at exit and on SIGUSR1 (Ctrl+Break on Windows).
+        // --kernel auto|scalar|sse2|avx2|avx512  Instruction set of the double batch kernel, the chosen one is printed to stderr.
+        Options options;
+        bool optionsAreValid = true;
+        while (argc >= 3 && optionsAreValid)
+        {
+            const std::string_view option = argv[1];
+            const std::string_view value = argv[2];
+            if (option == "--precision")
+            {
+                options.m_precision = value;
+            }
+            else if (option == "--degree")
+            {
+                const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), options.m_degree);
+                if (error != std::errc{} || end != value.data() + value.size()
+                    || options.m_degree == 0 || options.m_degree > slv::BasicPolynomialSolver<double>::maxDegree)
+                {
+                    std::cerr << "Invalid degree " << value << ", expected 1, 2, 3 or 4" << std::endl;
+                    optionsAreValid = false;
+                }
+            }
+            else if (option == "--cache")
+            {
+                const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), options.m_cacheCapacity);
+                if (error != std::errc{} || end != value.data() + value.size())
+                {
+                    std::cerr << "Invalid cache capacity " << value << std::endl;
+                    optionsAreValid = false;
+                }
+            }
+            else if (option == "--affinity")
+            {
+                if (value == "none")
+                {
+                    options.m_affinity = mt::ThreadPool::Affinity::None;
+                }
+                else if (value == "core")
+                {
+                    options.m_affinity = mt::ThreadPool::Affinity::Core;
+                }
+                else if (value == "node")
+                {
+                    options.m_affinity = mt::ThreadPool::Affinity::Node;
+                }
+                else
+                {
+                    std::cerr << "Unknown affinity " << value << ", expected none, core or node" << std::endl;
+                    optionsAreValid = false;
+                }
+            }
+            else if (option == "--stats")
+            {
+                if (value == "on" || value == "off")
+                {
+                    mt::Statistics::setEnabled(value == "on");
+                }
+                else
+                {
+                    std::cerr << "Unknown stats mode " << value << ", expected on or off" << std::endl;
+                    optionsAreValid = false;
+                }
+            }
+            else if (option == "--kernel")
+            {
+                std::optional<slv::BatchKernel> kernel;
+                if (value == "auto")
+                {
+                    kernel = slv::getBestBatchKernel();
+                }
+                for (const slv::BatchKernel candidate : { slv::BatchKernel::Scalar, slv::BatchKernel::Sse2, slv::BatchKernel::Avx2, slv::BatchKernel::Avx512 })
+                {
+                    if (value == slv::getBatchKernelName(candidate))
+                    {
+                        kernel = candidate;
+                    }
+                }
+                if (!kernel)
+                {
+                    std::cerr << "Unknown kernel " << value << ", expected auto, scalar, sse2, avx2 or avx512" << std::endl;
+                    optionsAreValid = false;
+                }
+                else if (!slv::setBatchKernel(*kernel))
+                {
+                    std::cerr << "Kernel " << value << " is not supported by this CPU" << std::endl;
+                    optionsAreValid = false;
+                }
+                else
+                {
+                    std::cerr << "KERNEL: " << slv::getBatchKernelName(*kernel) << std::endl;
+                }
+            }
+            else
+            {
+                break;
+            }
+            argv[2] = argv[0];
+            argc -= 2;
+            argv += 2;
+        }
+
+        if (optionsAreValid && options.m_degree != 2 && options.m_cacheCapacity != 0)
+        {
+            std::cerr << "The result cache holds quadratic equations only, use --degree 2" << std::endl;
+            optionsAreValid = false;
+        }
+        if (optionsAreValid)
+        {
+            if (mt::Statistics::isEnabled())
+            {
+                mt::Statistics::installDumpHandlers();
             }
-            std::cout << pSolver << std::endl;
+            runWithPrecision(argc, argv, options);
         }
     }
     catch (const std::exception& ex)
@@ -45,5 +331,7 @@ int main(int argc, char* argv[])
     {
         std::cerr << "Unknown exception" << std::endl;
     }
+#ifdef _WIN32
     system("pause");
+#endif
 }
@@ -0,0 +1,163 @@
+/**
+ * @file MappedFile.cpp
+ *
+ * @brief MappedFile class for read-only memory mapping of input files.
+ *
+ * @author Hovsep Papoyan
+ * Contact: papoyanhovsep93@gmail.com
+ * @Date 2024-03-28
+ *
+ */
+
+#include "MappedFile.h"
+
+#include <system_error>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& path)
+{
+    m_fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (m_fileHandle == INVALID_HANDLE_VALUE)
+    {
+        m_fileHandle = nullptr;
+        throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), "Can't open " + path);
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(m_fileHandle, &fileSize))
+    {
+        const DWORD error = GetLastError();
+        unmap();
+        throw std::system_error(static_cast<int>(error), std::system_category(), "Can't get size of " + path);
+    }
+    m_size = static_cast<std::size_t>(fileSize.QuadPart);
+    if (m_size == 0)
+    {
+        // Empty files can't be mapped, an empty view is returned.
+        return;
+    }
+    m_mappingHandle = CreateFileMappingA(m_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mappingHandle == nullptr)
+    {
+        const DWORD error = GetLastError();
+        unmap();
+        throw std::system_error(static_cast<int>(error), std::system_category(), "Can't map " + path);
+    }
+    m_data = static_cast<const char*>(MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    if (m_data == nullptr)
+    {
+        const DWORD error = GetLastError();
+        unmap();
+        throw std::system_error(static_cast<int>(error), std::system_category(), "Can't map " + path);
+    }
+}
+
+void MappedFile::unmap() noexcept
+{
+    if (m_data != nullptr)
+    {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mappingHandle != nullptr)
+    {
+        CloseHandle(m_mappingHandle);
+    }
+    if (m_fileHandle != nullptr)
+    {
+        CloseHandle(m_fileHandle);
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_mappingHandle = nullptr;
+    m_fileHandle = nullptr;
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& path)
+{
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1)
+    {
+        throw std::system_error(errno, std::generic_category(), "Can't open " + path);
+    }
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) == -1)
+    {
+        const int error = errno;
+        close(fd);
+        throw std::system_error(error, std::generic_category(), "Can't get size of " + path);
+    }
+    m_size = static_cast<std::size_t>(fileStat.st_size);
+    if (m_size != 0)
+    {
+        void* const address = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address == MAP_FAILED)
+        {
+            const int error = errno;
+            close(fd);
+            m_size = 0;
+            throw std::system_error(error, std::generic_category(), "Can't map " + path);
+        }
+        // Input is parsed front to back once, let the kernel read ahead aggressively.
+        madvise(address, m_size, MADV_SEQUENTIAL);
+        m_data = static_cast<const char*>(address);
+    }
+    // The mapping stays valid after the descriptor is closed.
+    close(fd);
+}
+
+void MappedFile::unmap() noexcept
+{
+    if (m_data != nullptr)
+    {
+        munmap(const_cast<char*>(m_data), m_size);
+    }
+    m_data = nullptr;
+    m_size = 0;
+}
+
+#endif
+
+MappedFile::MappedFile(MappedFile&& rhs) noexcept
+    : m_data(std::exchange(rhs.m_data, nullptr))
+    , m_size(std::exchange(rhs.m_size, 0))
+#ifdef _WIN32
+    , m_fileHandle(std::exchange(rhs.m_fileHandle, nullptr))
+    , m_mappingHandle(std::exchange(rhs.m_mappingHandle, nullptr))
+#endif
+{ }
+
+MappedFile& MappedFile::operator=(MappedFile&& rhs) noexcept
+{
+    if (this != &rhs)
+    {
+        unmap();
+        m_data = std::exchange(rhs.m_data, nullptr);
+        m_size = std::exchange(rhs.m_size, 0);
+#ifdef _WIN32
+        m_fileHandle = std::exchange(rhs.m_fileHandle, nullptr);
+        m_mappingHandle = std::exchange(rhs.m_mappingHandle, nullptr);
+#endif
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile()
+{
+    unmap();
+}
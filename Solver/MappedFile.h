@@ -0,0 +1,46 @@
+/**
+ * @file MappedFile.h
+ *
+ * @brief MappedFile class for read-only memory mapping of input files.
+ *
+ * @author Hovsep Papoyan
+ * Contact: papoyanhovsep93@gmail.com
+ * @Date 2024-03-28
+ *
+ */
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+class MappedFile
+{
+public:
+    // Maps the whole file. Throws std::system_error if the file can't be opened or mapped.
+    explicit MappedFile(const std::string& path);
+    MappedFile(const MappedFile&) = delete;
+    MappedFile(MappedFile&& rhs) noexcept;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile& operator=(MappedFile&& rhs) noexcept;
+    ~MappedFile();
+
+    [[nodiscard]] const char* data() const noexcept { return m_data; }
+    [[nodiscard]] std::size_t size() const noexcept { return m_size; }
+    [[nodiscard]] std::string_view getView() const noexcept { return { m_data, m_size }; }
+
+private:
+    void unmap() noexcept;
+
+private:
+    const char* m_data = nullptr;
+    std::size_t m_size = 0;
+#ifdef _WIN32
+    void* m_fileHandle = nullptr;
+    void* m_mappingHandle = nullptr;
+#endif
+};
+
+#endif
@@ -0,0 +1,112 @@
+/**
+ * @file NodePool.cpp
+ *
+ * @brief NodePool class for recycling small allocations of node based containers and of shared_ptr elements.
+ *
+ * @author Hovsep Papoyan
+ * Contact: papoyanhovsep93@gmail.com
+ * @Date 2024-03-28
+ *
+ */
+
+#include "NodePool.h"
+
+#include <bit>
+
+namespace mt
+{
+    NodePool::NodePool(const std::size_t slabSize)
+        : m_slabSize(slabSize < maxBlockSize ? maxBlockSize : slabSize)
+    { }
+
+    NodePool::~NodePool()
+    {
+        for (std::byte* const slab : m_slabs)
+        {
+            ::operator delete(slab);
+        }
+    }
+
+    void* NodePool::allocate(const std::size_t bytes, const std::size_t alignment)
+    {
+        if (!isPooled(bytes, alignment))
+        {
+            return alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__ ? ::operator new(bytes, std::align_val_t{ alignment }) : ::operator new(bytes);
+        }
+        const std::size_t sizeClassIndex = getSizeClass(bytes);
+        const std::size_t blockSize = minBlockSize << sizeClassIndex;
+        SizeClass& sizeClass = m_sizeClasses[sizeClassIndex];
+        std::lock_guard<std::mutex> lock(sizeClass.m_mutex);
+        if (FreeBlock* const block = sizeClass.m_freeList)
+        {
+            sizeClass.m_freeList = block->m_next;
+            return block;
+        }
+        if (sizeClass.m_unused == sizeClass.m_unusedEnd)
+        {
+            // The global heap is visited once per slab, not per block.
+            std::byte* const slab = static_cast<std::byte*>(::operator new(m_slabSize));
+            {
+                std::lock_guard<std::mutex> slabsLock(m_slabsMutex);
+                try
+                {
+                    m_slabs.push_back(slab);
+                }
+                catch (...)
+                {
+                    ::operator delete(slab);
+                    throw;
+                }
+            }
+            sizeClass.m_unused = slab;
+            sizeClass.m_unusedEnd = slab + m_slabSize / blockSize * blockSize;
+        }
+        void* const block = sizeClass.m_unused;
+        sizeClass.m_unused += blockSize;
+        return block;
+    }
+
+    void NodePool::deallocate(void* const p, const std::size_t bytes, const std::size_t alignment) noexcept
+    {
+        if (!isPooled(bytes, alignment))
+        {
+            if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+            {
+                ::operator delete(p, std::align_val_t{ alignment });
+            }
+            else
+            {
+                ::operator delete(p);
+            }
+            return;
+        }
+        SizeClass& sizeClass = m_sizeClasses[getSizeClass(bytes)];
+        FreeBlock* const block = ::new (p) FreeBlock{};
+        std::lock_guard<std::mutex> lock(sizeClass.m_mutex);
+        block->m_next = sizeClass.m_freeList;
+        sizeClass.m_freeList = block;
+    }
+
+    std::size_t NodePool::getSlabsCount()
+    {
+        std::lock_guard<std::mutex> lock(m_slabsMutex);
+        return m_slabs.size();
+    }
+
+    NodePool& NodePool::getDefault()
+    {
+        // Leaked on purpose: elements of static adapters may be freed during static destruction.
+        static NodePool* const pool = new NodePool();
+        return *pool;
+    }
+
+    std::size_t NodePool::getSizeClass(const std::size_t bytes) noexcept
+    {
+        return static_cast<std::size_t>(std::bit_width((bytes - 1) / minBlockSize));
+    }
+
+    bool NodePool::isPooled(const std::size_t bytes, const std::size_t alignment) noexcept
+    {
+        return bytes != 0 && bytes <= maxBlockSize && alignment <= minBlockSize;
+    }
+} // namespace mt
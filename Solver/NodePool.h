@@ -0,0 +1,124 @@
+/**
+ * @file NodePool.h
+ *
+ * @brief NodePool class and PoolAllocator class template for recycling small allocations of node based containers
+ *        And of shared_ptr elements, without trips to the global heap in the steady state.
+ *
+ * @author Hovsep Papoyan
+ * Contact: papoyanhovsep93@gmail.com
+ * @Date 2024-03-28
+ *
+ */
+
+#ifndef NODE_POOL_H
+#define NODE_POOL_H
+
+#include <array>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace mt
+{
+    // Blocks of up to maxBlockSize bytes are carved from slabs and recycled through per size class free lists,
+    // Larger or over-aligned allocations go to the global heap. Slabs are released only when the pool is destroyed,
+    // So the pool keeps the peak of its usage. Thread-safe: blocks may be freed by other threads than those allocating them.
+    class NodePool
+    {
+    public:
+        static constexpr std::size_t maxBlockSize = 1024;
+
+        // Size of the slabs requested from the global heap, every size class gets its own slabs.
+        explicit NodePool(const std::size_t slabSize = 64 * 1024);
+        NodePool(const NodePool&) = delete;
+        NodePool& operator=(const NodePool&) = delete;
+        ~NodePool();
+
+        [[nodiscard]] void* allocate(const std::size_t bytes, const std::size_t alignment);
+        void deallocate(void* const p, const std::size_t bytes, const std::size_t alignment) noexcept;
+
+        // Count of slabs taken from the global heap so far.
+        [[nodiscard]] std::size_t getSlabsCount();
+
+        // Process-wide pool used by default-constructed PoolAllocators, it is never destroyed.
+        [[nodiscard]] static NodePool& getDefault();
+
+    private:
+        static constexpr std::size_t minBlockSize = alignof(std::max_align_t);
+        // minBlockSize, 2 * minBlockSize, 4 * minBlockSize, ..., maxBlockSize.
+        static constexpr std::size_t sizeClassesCount = 7;
+
+        struct FreeBlock
+        {
+            FreeBlock* m_next;
+        };
+
+        // Each size class has its own lock, so containers of different node sizes don't contend.
+        struct alignas(64) SizeClass
+        {
+            std::mutex m_mutex;
+            FreeBlock* m_freeList = nullptr;
+            std::byte* m_unused = nullptr; // Not yet handed out part of the last slab.
+            std::byte* m_unusedEnd = nullptr;
+        };
+
+        [[nodiscard]] static std::size_t getSizeClass(const std::size_t bytes) noexcept;
+        [[nodiscard]] static bool isPooled(const std::size_t bytes, const std::size_t alignment) noexcept;
+
+    private:
+        const std::size_t m_slabSize;
+        std::array<SizeClass, sizeClassesCount> m_sizeClasses;
+        std::mutex m_slabsMutex;
+        std::vector<std::byte*> m_slabs; // Guarded by m_slabsMutex.
+    };
+
+    // Allocator of NodePool blocks. It can be the allocator of the container wrapped by ThreadSafeSTLAdapter,
+    // The adapter then allocates its elements together with their shared_ptr control blocks from the same pool.
+    // The pool must outlive every allocation, including elements still held through shared_ptrs returned by pop().
+    template<typename T>
+    class PoolAllocator
+    {
+    private:
+        NodePool* m_pool;
+
+    public:
+        using value_type = T;
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+
+        PoolAllocator() noexcept
+            : m_pool(&NodePool::getDefault())
+        { }
+        explicit PoolAllocator(NodePool& pool) noexcept
+            : m_pool(&pool)
+        { }
+        template<typename U>
+        PoolAllocator(const PoolAllocator<U>& other) noexcept
+            : m_pool(&other.getPool())
+        { }
+
+        [[nodiscard]] T* allocate(const std::size_t count)
+        {
+            if (count > static_cast<std::size_t>(-1) / sizeof(T))
+            {
+                throw std::bad_array_new_length{};
+            }
+            return static_cast<T*>(m_pool->allocate(count * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T* const p, const std::size_t count) noexcept
+        {
+            m_pool->deallocate(p, count * sizeof(T), alignof(T));
+        }
+
+        [[nodiscard]] NodePool& getPool() const noexcept { return *m_pool; }
+
+        template<typename U>
+        [[nodiscard]] bool operator==(const PoolAllocator<U>& rhs) const noexcept { return m_pool == &rhs.getPool(); }
+    };
+} // namespace mt
+
+#endif
@@ -0,0 +1,132 @@
+/**
+ * @file ParallelPolynomialSolver.cpp
+ *
+ * @brief BasicParallelPolynomialSolver class template for finding real roots of polynomials up to degree 4 in parallel.
+ *
+ * @author Hovsep Papoyan
+ * Contact: papoyanhovsep93@gmail.com
+ * @Date 2024-03-28
+ *
+ */
+
+#include "ParallelPolynomialSolver.h"
+#include "BlockScheduler.h"
+#include "ResultFormatter.h"
+
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace slv
+{
+    namespace
+    {
+        // Measures BasicPolynomialSolver::solveBatch once per type on quartics with 0, 2 and 4 real roots, the most expensive degree.
+        // It's only the initial estimation for GranularityPolicy, real block timings replace it soon.
+        template<typename T>
+        [[nodiscard]] double calibrateNanosecondsPerPolynomial()
+        {
+            static const double nanosecondsPerPolynomial = []
+                {
+                    static constexpr std::size_t degree = BasicPolynomialSolver<T>::maxDegree;
+                    static constexpr std::size_t count = 256;
+                    static constexpr int rounds = 4;
+                    std::vector<int> coeffs(count * (degree + 1));
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        const int k = static_cast<int>(i);
+                        int* const row = coeffs.data() + i * (degree + 1);
+                        row[0] = k % 3 + 1;
+                        row[1] = k * 7 % 13 - 6;
+                        row[2] = k * 11 % 17 - 8;
+                        row[3] = k * 5 % 19 - 9;
+                        row[4] = k * 3 % 23 - 11;
+                    }
+                    const PolynomialsView polynomials(coeffs.data(), count, degree);
+                    PolynomialResultStore<T> results;
+                    results.resize(count);
+                    BasicPolynomialSolver<T>::solveBatch(polynomials, results.getColumns()); // Warm-up.
+                    const auto start = std::chrono::steady_clock::now();
+                    for (int round = 0; round < rounds; ++round)
+                    {
+                        BasicPolynomialSolver<T>::solveBatch(polynomials, results.getColumns());
+                    }
+                    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+                    return elapsed.count() / (count * rounds);
+                }();
+            return nanosecondsPerPolynomial;
+        }
+    } // namespace
+
+    template<typename T>
+    BasicParallelPolynomialSolver<T>::BasicParallelPolynomialSolver(mt::ThreadPool& threadPool)
+        : m_threadPool(&threadPool)
+        // Coefficients and results of a quartic.
+        , m_granularity((Solver::maxDegree + 1) * sizeof(int) + Solver::maxDegree * sizeof(T) + sizeof(PolynomialKind),
+            getBlockThreadsCount(threadPool), calibrateNanosecondsPerPolynomial<T>())
+    { }
+
+    template<typename T>
+    void BasicParallelPolynomialSolver<T>::stream(const PolynomialsView& polynomials, const BlockSink& sink, const mt::Ordering ordering)
+    {
+        struct StreamedBlock
+        {
+            std::size_t m_first;
+            PolynomialsView m_polynomials;
+            PolynomialResultStore<T> m_results;
+        };
+        mt::Sequencer<StreamedBlock> sequencer(ordering);
+        const auto passToSink = [&sink](const StreamedBlock& block)
+            {
+                sink(SolvedBlock{ block.m_first, block.m_polynomials, block.m_results });
+            };
+        streamBlocks(polynomials, [&](const std::size_t blockIndex, const std::size_t first, const PolynomialsView& block, PolynomialResultStore<T> results)
+            {
+                sequencer.deliver(blockIndex, StreamedBlock{ first, block, std::move(results) }, passToSink);
+            });
+    }
+
+    template<typename T>
+    void BasicParallelPolynomialSolver<T>::stream(const PolynomialsView& polynomials, std::FILE* const file)
+    {
+        mt::Sequencer<std::string> sequencer(mt::Ordering::Input);
+        const auto writeText = [file](std::string text)
+            {
+                std::vector<std::string> buffers;
+                buffers.push_back(std::move(text));
+                ResultFormatter::write(file, buffers);
+            };
+        streamBlocks(polynomials, [&](const std::size_t blockIndex, std::size_t, const PolynomialsView& block, PolynomialResultStore<T> results)
+            {
+                std::string text;
+                formatBlock(block, results.getColumns(), text);
+                // Only the text waits for the blocks before it.
+                results.clear();
+                sequencer.deliver(blockIndex, std::move(text), writeText);
+            });
+    }
+
+    template<typename T>
+    template<typename Deliver>
+    void BasicParallelPolynomialSolver<T>::streamBlocks(const PolynomialsView& polynomials, const Deliver& deliver)
+    {
+        runBlocks(*m_threadPool, m_granularity, polynomials.size(), [&](const std::size_t blockIndex, const std::size_t first, const std::size_t count)
+            {
+                const PolynomialsView block = polynomials.subview(first, count);
+                const auto start = std::chrono::steady_clock::now();
+                // Allocated by the solving thread, so with an affinity the results are on its node.
+                PolynomialResultStore<T> results;
+                results.resize(count, m_threadPool->getAffinity() != mt::ThreadPool::Affinity::None);
+                Solver::solveBatch(block, results.getColumns());
+                const auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+                recordSolvedBlock(count, time);
+                deliver(blockIndex, first, block, std::move(results));
+                return time;
+            });
+    }
+
+    template class BasicParallelPolynomialSolver<float>;
+    template class BasicParallelPolynomialSolver<double>;
+    template class BasicParallelPolynomialSolver<long double>;
+} // namespace slv
@@ -0,0 +1,72 @@
+/**
+ * @file ParallelPolynomialSolver.h
+ *
+ * @brief BasicParallelPolynomialSolver class template for finding real roots of polynomials up to degree 4 in parallel.
+ *
+ * @author Hovsep Papoyan
+ * Contact: papoyanhovsep93@gmail.com
+ * @Date 2024-03-28
+ *
+ */
+
+#ifndef PARALLEL_POLYNOMIAL_SOLVER_H
+#define PARALLEL_POLYNOMIAL_SOLVER_H
+
+#include "GranularityPolicy.h"
+#include "PolynomialSolver.h"
+#include "Sequencer.h"
+#include "ThreadPool.h"
+
+#include <cstdio>
+#include <functional>
+
+namespace slv
+{
+    // T is the floating type of results: float, double or long double.
+    // Polynomials are solved by the same pipeline as BasicParallelSolver::stream: blocks sized by GranularityPolicy,
+    // Claimed in order by runners on the thread pool (see runBlocks), formatted on their workers and delivered through mt::Sequencer.
+    // The degree is given by the PolynomialsView, so one solver handles batches of any degree up to maxDegree.
+    template<typename T>
+    class BasicParallelPolynomialSolver
+    {
+    public:
+        using Solver = BasicPolynomialSolver<T>;
+
+        // Results of one block of a streamed batch. They are valid only during the sink call, then their memory is released.
+        struct SolvedBlock
+        {
+            std::size_t m_first; // Index of the block's first polynomial in the batch.
+            PolynomialsView m_polynomials; // Polynomials of the block.
+            const PolynomialResultStore<T>& m_results; // Row i belongs to polynomial m_polynomials[i].
+        };
+        using BlockSink = std::function<void(const SolvedBlock&)>;
+
+        explicit BasicParallelPolynomialSolver(mt::ThreadPool& threadPool = mt::ThreadPool::getDefault());
+
+        // Same as BasicParallelSolver::stream. polynomials.getDegree() must not exceed Solver::maxDegree.
+        void stream(const PolynomialsView& polynomials, const BlockSink& sink, const mt::Ordering ordering = mt::Ordering::Input);
+        void stream(const PolynomialsView& polynomials, std::FILE* const file);
+
+        // Block sizing of the next batches, tuned by the timings of the previous ones.
+        [[nodiscard]] const GranularityPolicy& getGranularity() const noexcept { return m_granularity; }
+
+    private:
+        // Solves the blocks of polynomials into their own result stores and calls deliver(blockIndex, first, block, results)
+        // On the thread which has solved the block.
+        template<typename Deliver>
+        void streamBlocks(const PolynomialsView& polynomials, const Deliver& deliver);
+
+    private:
+        mt::ThreadPool* m_threadPool; // Long-lived workers, block runners are submitted to them.
+        GranularityPolicy m_granularity; // Decides count of blocks and inline solving.
+    };
+
+    extern template class BasicParallelPolynomialSolver<float>;
+    extern template class BasicParallelPolynomialSolver<double>;
+    extern template class BasicParallelPolynomialSolver<long double>;
+
+    // Precision selected at build time, see SOLVER_FLOAT_TYPE.
+    using ParallelPolynomialSolver = BasicParallelPolynomialSolver<Solver::Float>;
+} // namespace slv
+
+#endif
@@ -1,7 +1,7 @@
 /**
  * @file ParallelSolver.cpp
  *
- * @brief ParallelSolver class for solving quadratic and linear equations in parallel.
+ * @brief BasicParallelSolver class template for solving quadratic and linear equations in parallel.
  *
  * @author Hovsep Papoyan
  * Contact: papoyanhovsep93@gmail.com
@@ -10,110 +10,526 @@
  */
 
 #include "ParallelSolver.h"
+#include "BlockScheduler.h"
+#include "ResultFormatter.h"
 
-#include <sstream>
+#include <algorithm>
+#include <chrono>
 #include <future>
 
 namespace slv
 {
-    std::vector<Solver::Result>
-        ParallelSolver::BlockSolver::operator()(const std::vector<int>& coeffs, std::size_t first, const std::size_t last) const
+    namespace
     {
-        std::vector<Solver::Result> result;
-        result.reserve(last - first);
-        while (first != last)
+        // Copies coefficients into a, b, c columns.
+        void copyColumns(const CoefficientsView& coeffs, int* const aCoefficients, int* const bCoefficients, int* const cCoefficients)
         {
-            result.emplace_back(Solver::solve(coeffs[first], coeffs[first + 1], coeffs[first + 2])); // Passing a,b,c coefficients.
-            first += 3; // 3 because a,b,c coefficients.
+            for (std::size_t i = 0; i < coeffs.size(); ++i)
+            {
+                aCoefficients[i] = coeffs.a(i);
+                bCoefficients[i] = coeffs.b(i);
+                cCoefficients[i] = coeffs.c(i);
+            }
         }
-        return result;
-    }
 
-    std::ostream& operator<<(std::ostream& os, const ParallelSolver& pSolver)
-    {
-        std::stringstream out;
-        out.setf(std::ios::fixed);
-        size_t currentIndex = 0;
-        for (const std::vector<Solver::Result>& results : pSolver.m_results)
+        // Measures Solver::solveBatch once per type, on a mix of two roots, no roots and linear equations.
+        // It's only the initial estimation for GranularityPolicy, real block timings replace it soon.
+        template<typename T>
+        [[nodiscard]] double calibrateNanosecondsPerEquation()
         {
-            for (const Solver::Result& result : results)
-            {
-                out << "INPUT: (" << pSolver.m_coeffs[currentIndex] << ", "
-                    << pSolver.m_coeffs[currentIndex + 1] << ", "
-                    << pSolver.m_coeffs[currentIndex + 2] << ")\nOUTPUT: ";
-                if (std::holds_alternative<Solver::LinearResult>(result))
+            static const double nanosecondsPerEquation = []
                 {
-                    if (const Solver::LinearResult& r = std::get<Solver::LinearResult>(result))
+                    static constexpr std::size_t count = 256;
+                    static constexpr int rounds = 16;
+                    int a[count];
+                    int b[count];
+                    int c[count];
+                    for (std::size_t i = 0; i < count; ++i)
                     {
-                        out << '(' << r.value() << "). GLOBAL MIN(MAX) = " << r.value();
+                        const int k = static_cast<int>(i);
+                        a[i] = k % 5 - 1;
+                        b[i] = k * 7 % 13 - 6;
+                        c[i] = k * 11 % 17 - 8;
                     }
-                    else
+                    ResultStore<T> results;
+                    results.resize(count);
+                    BasicSolver<T>::solveBatch(a, b, c, count, results.getColumns()); // Warm-up.
+                    const auto start = std::chrono::steady_clock::now();
+                    for (int round = 0; round < rounds; ++round)
                     {
-                        out << (pSolver.m_coeffs[currentIndex + 2] == 0 ? "AN IDENTITY" : "NOT CORRECT");
+                        BasicSolver<T>::solveBatch(a, b, c, count, results.getColumns());
                     }
+                    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+                    return elapsed.count() / (count * rounds);
+                }();
+            return nanosecondsPerEquation;
+        }
+    } // namespace
+
+    template<typename T>
+    void BasicParallelSolver<T>::BlockSolver::operator()(const CoefficientsView& coeffs, const typename Solver::ResultColumns& results) const
+    {
+        // Interleaved (a1, b1, c1, a2, ...) coefficients are split into a, b, c columns chunk by chunk,
+        // So that Solver::solveBatch can process them in SIMD lanes. Chunk buffers stay in L1 cache.
+        // Columnar coefficients are passed to Solver::solveBatch as they are.
+        int aCoefficients[chunkSize];
+        int bCoefficients[chunkSize];
+        int cCoefficients[chunkSize];
+
+        const std::size_t sz = coeffs.size();
+        for (std::size_t first = 0; first != sz; )
+        {
+            const std::size_t count = std::min(chunkSize, sz - first);
+            const int* a = coeffs.aData() + first;
+            const int* b = coeffs.bData() + first;
+            const int* c = coeffs.cData() + first;
+            if (!coeffs.isColumnar())
+            {
+                copyColumns(coeffs.subview(first, count), aCoefficients, bCoefficients, cCoefficients);
+                a = aCoefficients;
+                b = bCoefficients;
+                c = cCoefficients;
+            }
+            const typename Solver::ResultColumns chunkResults{ results.m_firstRoots + first, results.m_secondRoots + first,
+                results.m_extremums + first, results.m_criticalPoints + first, results.m_kinds + first };
+            if (m_cache)
+            {
+                solveCached(a, b, c, count, chunkResults);
+            }
+            else
+            {
+                Solver::solveBatch(a, b, c, count, chunkResults);
+            }
+            first += count;
+        }
+    }
+
+    template<typename T>
+    void BasicParallelSolver<T>::BlockSolver::solveCached(const int* const aCoefficients, const int* const bCoefficients,
+        const int* const cCoefficients, const std::size_t count, const typename Solver::ResultColumns& results) const
+    {
+        int aMissed[chunkSize];
+        int bMissed[chunkSize];
+        int cMissed[chunkSize];
+        std::size_t missedRows[chunkSize];
+        std::size_t missedCount = 0;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if (!m_cache->lookup(aCoefficients[i], bCoefficients[i], cCoefficients[i], results, i))
+            {
+                aMissed[missedCount] = aCoefficients[i];
+                bMissed[missedCount] = bCoefficients[i];
+                cMissed[missedCount] = cCoefficients[i];
+                missedRows[missedCount++] = i;
+            }
+        }
+        if (missedCount == 0)
+        {
+            return;
+        }
+
+        T firstRoots[chunkSize];
+        T secondRoots[chunkSize];
+        T extremums[chunkSize];
+        T criticalPoints[chunkSize];
+        ResultKind kinds[chunkSize];
+        const typename Solver::ResultColumns missed{ firstRoots, secondRoots, extremums, criticalPoints, kinds };
+        Solver::solveBatch(aMissed, bMissed, cMissed, missedCount, missed);
+        for (std::size_t j = 0; j < missedCount; ++j)
+        {
+            const std::size_t i = missedRows[j];
+            results.m_firstRoots[i] = firstRoots[j];
+            results.m_secondRoots[i] = secondRoots[j];
+            results.m_extremums[i] = extremums[j];
+            results.m_criticalPoints[i] = criticalPoints[j];
+            results.m_kinds[i] = kinds[j];
+            m_cache->insert(aMissed[j], bMissed[j], cMissed[j], missed, j);
+        }
+    }
+
+    template<typename T>
+    std::ostream& operator<<(std::ostream& os, const BasicParallelSolver<T>& pSolver)
+    {
+        ResultFormatter::write(os, pSolver.format());
+        return os;
+    }
+
+    template<typename T>
+    BasicParallelSolver<T>::BasicParallelSolver(mt::ThreadPool& threadPool)
+        : m_threadPool(&threadPool)
+        // Coefficients and results of an equation. The calling thread also executes blocks, unless the pool has an affinity.
+        , m_granularity(3 * sizeof(int) + 4 * sizeof(T) + sizeof(ResultKind), getBlockThreadsCount(threadPool), calibrateNanosecondsPerEquation<T>())
+    { }
+
+    template<typename T>
+    template<typename Callable>
+    auto BasicParallelSolver<T>::submitBlock(const std::size_t blockIndex, Callable callable) const
+    {
+        // The same block index is used by solving and formatting, so a block is usually formatted on the node where it was solved.
+        if (m_threadPool->getAffinity() != mt::ThreadPool::Affinity::None)
+        {
+            return m_threadPool->submitTo(blockIndex, std::move(callable));
+        }
+        return m_threadPool->submit(std::move(callable));
+    }
+
+    template<typename T>
+    BasicParallelSolver<T>::BatchHandle::BatchHandle(const BasicParallelSolver& solver, std::shared_ptr<BatchState> state) noexcept
+        : m_solver(&solver)
+        , m_state(std::move(state))
+    { }
+
+    template<typename T>
+    bool BasicParallelSolver<T>::BatchHandle::isReady() const
+    {
+        return m_state->m_future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+
+    template<typename T>
+    void BasicParallelSolver<T>::BatchHandle::wait() const
+    {
+        m_solver->m_threadPool->waitFor(m_state->m_future);
+    }
+
+    template<typename T>
+    const ResultStore<T>& BasicParallelSolver<T>::BatchHandle::getResults() const
+    {
+        wait();
+        m_state->m_future.get();
+        return m_state->m_batch.m_results;
+    }
+
+    template<typename T>
+    std::vector<std::string> BasicParallelSolver<T>::BatchHandle::format() const
+    {
+        wait();
+        m_state->m_future.get();
+        return m_solver->format(m_state->m_batch);
+    }
+
+    template<typename T>
+    void BasicParallelSolver<T>::BatchHandle::write(std::FILE* const file) const
+    {
+        ResultFormatter::write(file, format());
+    }
+
+    template<typename T>
+    bool BasicParallelSolver<T>::BatchHandle::await_suspend(const std::coroutine_handle<> continuation) const
+    {
+        std::lock_guard<std::mutex> lock(m_state->m_mutex);
+        if (m_state->m_completed)
+        {
+            // Solved meanwhile, the coroutine continues right away.
+            return false;
+        }
+        m_state->m_continuation = continuation;
+        return true;
+    }
+
+    template<typename T>
+    std::vector<std::string> BasicParallelSolver<T>::format() const
+    {
+        return format(m_batch);
+    }
+
+    template<typename T>
+    std::vector<std::string> BasicParallelSolver<T>::format(const Batch& batch) const
+    {
+        if (batch.m_blockSizes.size() <= 1)
+        {
+            // A batch solved inline is formatted inline too.
+            std::vector<std::string> buffers(batch.m_blockSizes.size());
+            if (!buffers.empty())
+            {
+                formatBlock(batch.m_view, batch.m_results.getColumns(), buffers.front());
+            }
+            return buffers;
+        }
+        std::vector<std::future<std::string>> futures;
+        futures.reserve(batch.m_blockSizes.size());
+        std::size_t blockStart = 0;
+        for (const std::size_t blockSize : batch.m_blockSizes)
+        {
+            futures.push_back(submitBlock(futures.size(), [block = batch.m_view.subview(blockStart, blockSize), results = batch.m_results.getColumns(blockStart)]
+                {
+                    std::string buffer;
+                    formatBlock(block, results, buffer);
+                    return buffer;
+                }));
+            blockStart += blockSize;
+        }
+        for (const std::future<std::string>& future : futures)
+        {
+            m_threadPool->waitFor(future);
+        }
+        std::vector<std::string> buffers;
+        buffers.reserve(futures.size());
+        for (std::future<std::string>& future : futures)
+        {
+            buffers.push_back(future.get());
+        }
+        return buffers;
+    }
+
+    template<typename T>
+    void BasicParallelSolver<T>::write(std::FILE* const file) const
+    {
+        ResultFormatter::write(file, format());
+    }
+
+    template<typename T>
+    void BasicParallelSolver<T>::stream(const CoefficientsView& coeffs, const BlockSink& sink, const mt::Ordering ordering)
+    {
+        struct StreamedBlock
+        {
+            std::size_t m_first;
+            CoefficientsView m_coeffs;
+            ResultStore<T> m_results;
+        };
+        mt::Sequencer<StreamedBlock> sequencer(ordering);
+        const auto passToSink = [&sink](const StreamedBlock& block)
+            {
+                sink(SolvedBlock{ block.m_first, block.m_coeffs, block.m_results });
+            };
+        streamBlocks(coeffs, [&](const std::size_t blockIndex, const std::size_t first, const CoefficientsView& block, ResultStore<T> results)
+            {
+                sequencer.deliver(blockIndex, StreamedBlock{ first, block, std::move(results) }, passToSink);
+            });
+    }
+
+    template<typename T>
+    void BasicParallelSolver<T>::stream(const CoefficientsView& coeffs, std::FILE* const file)
+    {
+        mt::Sequencer<std::string> sequencer(mt::Ordering::Input);
+        const auto writeText = [file](std::string text)
+            {
+                std::vector<std::string> buffers;
+                buffers.push_back(std::move(text));
+                ResultFormatter::write(file, buffers);
+            };
+        streamBlocks(coeffs, [&](const std::size_t blockIndex, std::size_t, const CoefficientsView& block, ResultStore<T> results)
+            {
+                std::string text;
+                formatBlock(block, results.getColumns(), text);
+                // Only the text waits for the blocks before it.
+                results.clear();
+                sequencer.deliver(blockIndex, std::move(text), writeText);
+            });
+    }
+
+    template<typename T>
+    template<typename Deliver>
+    void BasicParallelSolver<T>::streamBlocks(const CoefficientsView& coeffs, const Deliver& deliver)
+    {
+        runBlocks(*m_threadPool, m_granularity, coeffs.size(), [&](const std::size_t blockIndex, const std::size_t first, const std::size_t count)
+            {
+                const CoefficientsView block = coeffs.subview(first, count);
+                const auto start = std::chrono::steady_clock::now();
+                // Allocated by the solving thread, so with an affinity the results are on its node.
+                ResultStore<T> results;
+                results.resize(count, m_threadPool->getAffinity() != mt::ThreadPool::Affinity::None);
+                BlockSolver{ m_cache }(block, results.getColumns());
+                const auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+                recordSolvedBlock(count, time);
+                deliver(blockIndex, first, block, std::move(results));
+                return time;
+            });
+    }
+
+    template<typename T>
+    void BasicParallelSolver<T>::operator()(std::vector<int> items)
+    {
+        m_batch.m_coeffs = std::move(items);
+        // At this point m_coeffs.size() >= 3 && m_coeffs.size() % 3 == 0. Validated by InputValidator.
+        (*this)(CoefficientsView::fromInterleaved(m_batch.m_coeffs.data(), m_batch.m_coeffs.size() / 3)); // 3 because a,b,c coefficients.
+    }
+
+    template<typename T>
+    void BasicParallelSolver<T>::operator()(const CoefficientsView& coeffs)
+    {
+        // The batch is solved as an asynchronous one and waited for. Its buffers are lent to it and taken back,
+        // So that the next batch reuses them.
+        const auto state = std::make_shared<BatchState>();
+        state->m_batch = std::move(m_batch);
+        start(state, coeffs);
+        // The calling thread helps with pending blocks instead of sleeping.
+        // Every block has finished when the future is ready, even if one has thrown.
+        m_threadPool->waitFor(state->m_future);
+        m_batch = std::move(state->m_batch);
+        state->m_future.get();
+    }
+
+    template<typename T>
+    typename BasicParallelSolver<T>::BatchHandle BasicParallelSolver<T>::solveAsync(std::vector<int> items)
+    {
+        const auto state = std::make_shared<BatchState>();
+        state->m_batch.m_coeffs = std::move(items);
+        const std::vector<int>& coeffs = state->m_batch.m_coeffs;
+        start(state, CoefficientsView::fromInterleaved(coeffs.data(), coeffs.size() / 3));
+        return BatchHandle(*this, state);
+    }
+
+    template<typename T>
+    typename BasicParallelSolver<T>::BatchHandle BasicParallelSolver<T>::solveAsync(const CoefficientsView& coeffs)
+    {
+        const auto state = std::make_shared<BatchState>();
+        start(state, coeffs);
+        return BatchHandle(*this, state);
+    }
+
+    template<typename T>
+    void BasicParallelSolver<T>::start(const std::shared_ptr<BatchState>& state, const CoefficientsView& coeffs)
+    {
+        Batch& batch = state->m_batch;
+        const std::size_t equationsCount = coeffs.size();
+        const GranularityPolicy::Plan plan = m_granularity.plan(equationsCount);
+        const std::size_t numBlocks = equationsCount != 0 ? plan.m_blocksCount : 0;
+        // The work is divided equally, first (equationsCount % numBlocks) blocks get one more equation.
+        const std::size_t blockSize = numBlocks != 0 ? equationsCount / numBlocks : 0;
+        const std::size_t remainder = numBlocks != 0 ? equationsCount % numBlocks : 0;
+
+        // With an affinity every block first copies its coefficients into the columnar m_localCoeffs.
+        // Fresh pages of m_localCoeffs and m_results are first touched by the worker running the block and so are placed on its node,
+        // Wherever the input was written. Solving and formatting then read local memory, unless a worker of another node steals the block.
+        const bool placeBlocks = m_threadPool->getAffinity() != mt::ThreadPool::Affinity::None && !plan.m_inline;
+        state->m_placeBlocks = placeBlocks;
+        int* localCoeffs = nullptr;
+        if (placeBlocks)
+        {
+            batch.m_localCoeffs = mt::PageBuffer{};
+            batch.m_localCoeffs = mt::PageBuffer(3 * equationsCount * sizeof(int));
+            localCoeffs = static_cast<int*>(batch.m_localCoeffs.data());
+            batch.m_view = CoefficientsView::fromColumns(localCoeffs, localCoeffs + equationsCount, localCoeffs + 2 * equationsCount, equationsCount);
+        }
+        else
+        {
+            batch.m_view = coeffs;
+        }
+
+        // Every block writes its own slice of the store and its own time slot,
+        // No synchronization is needed besides counting the finished blocks.
+        batch.m_results.resize(equationsCount, placeBlocks);
+        batch.m_blockSizes.resize(numBlocks);
+        state->m_blockTimes.assign(numBlocks, std::chrono::nanoseconds{ 0 });
+        state->m_pendingBlocksCount = numBlocks;
+        const auto makeBlockTask = [&](const std::size_t blockStart, const std::size_t blockCount, const std::size_t blockIndex)
+            {
+                return [this, state, source = coeffs.subview(blockStart, blockCount), block = batch.m_view.subview(blockStart, blockCount),
+                    results = batch.m_results.getColumns(blockStart), cache = m_cache,
+                    local = placeBlocks ? localCoeffs + blockStart : nullptr, equationsCount, blockIndex]
+                    {
+                        try
+                        {
+                            const auto start = std::chrono::steady_clock::now();
+                            if (local != nullptr)
+                            {
+                                copyColumns(source, local, local + equationsCount, local + 2 * equationsCount);
+                            }
+                            BlockSolver{ cache }(block, results);
+                            const auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+                            state->m_blockTimes[blockIndex] = time;
+                            recordSolvedBlock(block.size(), time);
+                        }
+                        catch (...)
+                        {
+                            std::lock_guard<std::mutex> lock(state->m_mutex);
+                            if (!state->m_error)
+                            {
+                                state->m_error = std::current_exception();
+                            }
+                        }
+                        if (state->m_pendingBlocksCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                        {
+                            finish(*state);
+                        }
+                    };
+            };
+
+        if (numBlocks == 0)
+        {
+            finish(*state);
+        }
+        else if (plan.m_inline)
+        {
+            // Too little work to pay for waking a worker.
+            batch.m_blockSizes.front() = equationsCount;
+            makeBlockTask(0, equationsCount, 0)();
+        }
+        else
+        {
+            std::size_t blockStart = 0;
+            for (std::size_t i = 0; i < numBlocks; ++i)
+            {
+                const std::size_t blockCount = blockSize + (i < remainder ? 1 : 0);
+                batch.m_blockSizes[i] = blockCount;
+                blockStart += blockCount;
+            }
+            // Sizes are set before any block is submitted, the last block may finish before this loop does.
+            blockStart = 0;
+            for (std::size_t i = 0; i < numBlocks; ++i)
+            {
+                try
+                {
+                    static_cast<void>(submitBlock(i, makeBlockTask(blockStart, batch.m_blockSizes[i], i)));
                 }
-                else
+                catch (...)
                 {
-                    const Solver::QuadraticResult& r = std::get<Solver::QuadraticResult>(result);
-                    if (r.m_roots)
+                    // Blocks which were not submitted count as finished, so the batch still completes, with the error.
                     {
-                        out << '(' << r.m_roots.value().first << ", " << r.m_roots.value().second << ')';
+                        std::lock_guard<std::mutex> lock(state->m_mutex);
+                        state->m_error = std::current_exception();
                     }
-                    else
+                    if (state->m_pendingBlocksCount.fetch_sub(numBlocks - i, std::memory_order_acq_rel) == numBlocks - i)
                     {
-                        out << "NO REAL ROOTS";
+                        finish(*state);
                     }
-                    out << ". GLOBAL " << (pSolver.m_coeffs[currentIndex] > 0 ? "MIN" : "MAX")
-                        << " = " << r.m_extremum << " AT x = " << r.m_criticalPoint;
+                    return;
                 }
-                currentIndex += 3; // 3 because a,b,c coefficients.
-                out << "\n\n";
+                blockStart += batch.m_blockSizes[i];
             }
         }
-        os << out.rdbuf();
-        return os;
     }
 
-    void ParallelSolver::operator()(std::vector<int> items)
+    template<typename T>
+    void BasicParallelSolver<T>::finish(BatchState& state)
     {
-        m_coeffs = std::move(items);
-        // At this point sz >= 3 && sz % 3 == 0. Validated by InputValidator.
-        const std::size_t sz = m_coeffs.size();
-        // minCoeffsCountPerThread must be chosen >= 3 && minCoeffsCountPerThread % 3 == 0.
-        static constexpr std::size_t minCoeffsCountPerThread = 24;
-        const std::size_t maxThreads = (sz + minCoeffsCountPerThread - 1) / minCoeffsCountPerThread;
-        static const std::size_t hardwareThreads = std::jthread::hardware_concurrency();
-        // In case of hardwareThreads == 0, the value 2 chosen hypothetically,
-        // Taking into account that in this application 4 threads already can be started
-        // (2 threads per consumer and 2 threads per producer).
-        const std::size_t numThreads = std::min(hardwareThreads != 0 ? hardwareThreads : 2, maxThreads);
-        // The work is divided almost equally between numThreads (except the last thread).
-        const std::size_t blockSize = sz / numThreads / 3 * 3;
-        const std::size_t numThreadsMinusOne = numThreads - 1;
-
-        std::vector<std::future<std::vector<Solver::Result>>> futures(numThreadsMinusOne);
-        // In case of exception or normal finish of execution threads will be automatically joined.
-        std::vector<std::jthread> threads(numThreadsMinusOne);
-
-        std::size_t blockStart = 0;
-        for (std::size_t i = 0; i < numThreadsMinusOne; ++i)
+        std::chrono::nanoseconds busyTime{ 0 };
+        for (const std::chrono::nanoseconds time : state.m_blockTimes)
+        {
+            busyTime += time;
+        }
+        m_granularity.record(state.m_batch.m_results.size(), busyTime);
+        if (state.m_placeBlocks)
         {
-            std::size_t blockEnd = blockStart;
-            blockEnd += blockSize; // every spawn thread will process blockSize coefficients.
-            std::packaged_task<
-                std::vector<Solver::Result>(
-                    const std::vector<int>&, std::size_t, const std::size_t)> task(BlockSolver{});
-            futures[i] = task.get_future();
-            threads[i] = std::jthread(std::move(task), std::cref(m_coeffs), blockStart, blockEnd);
-            blockStart = blockEnd;
+            // Coefficients are kept in m_localCoeffs now.
+            state.m_batch.m_coeffs = std::vector<int>{};
         }
 
-        m_results.resize(numThreads);
-        for (std::size_t i = 0; i < numThreadsMinusOne; ++i)
+        std::coroutine_handle<> continuation;
         {
-            m_results[i] = futures[i].get();
+            std::lock_guard<std::mutex> lock(state.m_mutex);
+            state.m_completed = true;
+            continuation = state.m_continuation;
+            if (state.m_error)
+            {
+                state.m_promise.set_exception(state.m_error);
+            }
+            else
+            {
+                state.m_promise.set_value();
+            }
+        }
+        if (continuation)
+        {
+            continuation.resume();
         }
-        // The last portion of work done by current thread.
-        m_results[numThreadsMinusOne] = BlockSolver{}(m_coeffs, blockStart, sz);
     }
+
+    template class BasicParallelSolver<float>;
+    template class BasicParallelSolver<double>;
+    template class BasicParallelSolver<long double>;
+
+    template std::ostream& operator<<(std::ostream& os, const BasicParallelSolver<float>& pSolver);
+    template std::ostream& operator<<(std::ostream& os, const BasicParallelSolver<double>& pSolver);
+    template std::ostream& operator<<(std::ostream& os, const BasicParallelSolver<long double>& pSolver);
 } // namespace slv
@@ -1,7 +1,7 @@
 /**
  * @file ParallelSolver.h
  *
- * @brief ParallelSolver class for solving quadratic and linear equations in parallel.
+ * @brief BasicParallelSolver class template for solving quadratic and linear equations in parallel.
  *
  * @author Hovsep Papoyan
  * Contact: papoyanhovsep93@gmail.com
@@ -12,32 +12,190 @@
 #ifndef PARALLEL_SOLVER_H
 #define PARALLEL_SOLVER_H
 
+#include "CoefficientsView.h"
+#include "GranularityPolicy.h"
+#include "ResultCache.h"
+#include "ResultStore.h"
+#include "Sequencer.h"
 #include "Solver.h"
+#include "ThreadPool.h"
+#include "Topology.h"
 
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstdio>
+#include <exception>
+#include <functional>
+#include <future>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <vector>
 
 namespace slv
 {
-    class ParallelSolver
+    // T is the floating type of results: float, double or long double.
+    // If the thread pool has an affinity (see mt::ThreadPool::Affinity), block i is queued to worker i % threadsCount, which usually runs it,
+    // And the block's coefficients and results are placed on the NUMA node of the worker that runs it. A block stolen by another node's worker
+    // Is still solved correctly, only its memory is remote.
+    template<typename T>
+    class BasicParallelSolver
     {
-        // Each worker thread generates collection of results by
-        // Executing operator() for BlockSolver instance.
+    public:
+        using Solver = BasicSolver<T>;
+
+    private:
+        // Each worker thread solves its block by executing operator() for BlockSolver instance.
+        // Results are written to the block's own slice of the result store.
         struct BlockSolver
         {
-            [[nodiscard]] std::vector<Solver::Result> operator()(const std::vector<int>& coeffs, std::size_t first, const std::size_t last) const;
+            static constexpr std::size_t chunkSize = 256;
+
+            ResultCache<T>* m_cache;
+
+            void operator()(const CoefficientsView& coeffs, const typename Solver::ResultColumns& results) const;
+
+        private:
+            // Solves only the equations missing in m_cache, as one smaller batch, and caches them.
+            void solveCached(const int* aCoefficients, const int* bCoefficients, const int* cCoefficients,
+                const std::size_t count, const typename Solver::ResultColumns& results) const;
+        };
+
+        // Coefficients and results of one batch. Formatting uses the same blocks as solving.
+        struct Batch
+        {
+            std::vector<int> m_coeffs; // Vector of coefficients from input (a1, b1, c1, a2, b2, c2, ...), if it was passed by value.
+            mt::PageBuffer m_localCoeffs; // Columnar copy of the coefficients made by the block workers, only with an affinity.
+            CoefficientsView m_view; // Coefficients of the batch: m_coeffs, m_localCoeffs or external memory.
+            ResultStore<T> m_results; // Results of all blocks, in order.
+            std::vector<std::size_t> m_blockSizes; // Count of equations of every block. One block is inline.
+        };
+
+        // A batch in flight. Its last block, on whichever thread it finishes, completes the batch,
+        // So no thread waits for a batch unless someone asks for its results.
+        struct BatchState
+        {
+            Batch m_batch;
+            std::vector<std::chrono::nanoseconds> m_blockTimes;
+            std::atomic<std::size_t> m_pendingBlocksCount{ 0 };
+            bool m_placeBlocks = false;
+            std::mutex m_mutex; // Guards the fields below.
+            std::exception_ptr m_error; // The first exception of a block.
+            bool m_completed = false;
+            std::coroutine_handle<> m_continuation; // Coroutine awaiting the batch.
+            std::promise<void> m_promise;
+            std::shared_future<void> m_future = m_promise.get_future().share();
         };
 
     public:
+        // Handle of a batch submitted with solveAsync. The batch is solved in the background by the thread pool,
+        // The handle can be polled, waited for or co_awaited. co_await resumes the coroutine on the thread
+        // Which finishes the batch's last block (or doesn't suspend if the batch is already solved).
+        // The solver must outlive its handles. Copies of a handle refer to the same batch.
+        class BatchHandle
+        {
+        private:
+            const BasicParallelSolver* m_solver;
+            std::shared_ptr<BatchState> m_state;
+
+        public:
+            BatchHandle(const BasicParallelSolver& solver, std::shared_ptr<BatchState> state) noexcept;
+
+            [[nodiscard]] bool isReady() const;
+            // Blocks until the batch is solved, executing pending tasks of the pool in the meantime.
+            void wait() const;
+            // Waits for the batch and returns its results, row i belongs to equation i. Rethrows the exception of a failed block.
+            [[nodiscard]] const ResultStore<T>& getResults() const;
+            // Same as BasicParallelSolver::format and write, for this batch.
+            [[nodiscard]] std::vector<std::string> format() const;
+            void write(std::FILE* const file) const;
+
+            [[nodiscard]] bool await_ready() const { return isReady(); }
+            [[nodiscard]] bool await_suspend(const std::coroutine_handle<> continuation) const;
+            const ResultStore<T>& await_resume() const { return getResults(); }
+        };
+
+        // Results of one block of a streamed batch. They are valid only during the sink call, then their memory is released.
+        struct SolvedBlock
+        {
+            std::size_t m_first; // Index of the block's first equation in the batch.
+            CoefficientsView m_coeffs; // Coefficients of the block.
+            const ResultStore<T>& m_results; // Row i belongs to equation m_coeffs[i].
+        };
+        using BlockSink = std::function<void(const SolvedBlock&)>;
+
+        explicit BasicParallelSolver(mt::ThreadPool& threadPool = mt::ThreadPool::getDefault());
+
         void operator()(std::vector<int> items);
+        // Solves coefficients in place, without copying them (e.g. a memory mapped binary file).
+        // The viewed memory must stay valid as long as results are printed.
+        void operator()(const CoefficientsView& coeffs);
+
+        // Submits the batch and returns at once (batches too small for the pool are solved before returning).
+        // Any number of batches may be in flight, each keeps its own results. The last batch of operator() is not affected.
+        [[nodiscard]] BatchHandle solveAsync(std::vector<int> items);
+        // The viewed memory must stay valid as long as the handle is used.
+        [[nodiscard]] BatchHandle solveAsync(const CoefficientsView& coeffs);
+
+        // Solves the batch without keeping its results: every block gets its own result memory, which is released
+        // As soon as sink has got the block. The sink is never called concurrently. In Ordering::Input mode a finished block
+        // Waits only for the blocks before it. Returns when every block has been delivered. The last batch of operator() is not affected.
+        void stream(const CoefficientsView& coeffs, const BlockSink& sink, const mt::Ordering ordering = mt::Ordering::Input);
+        // Formats every block on its worker and writes it as soon as the blocks before it are written. Same text as write.
+        void stream(const CoefficientsView& coeffs, std::FILE* const file);
+
+        // Formats results of every block into its own buffer, blocks are formatted in parallel.
+        [[nodiscard]] std::vector<std::string> format() const;
+        // Writes formatted results with as few system calls as possible. Same text as operator<<.
+        void write(std::FILE* const file) const;
+
+        // Block workers look equations up in cache before solving them and remember new ones.
+        // The cache may be shared by several solvers and must outlive them, nullptr disables caching.
+        void setCache(ResultCache<T>* const cache) noexcept { m_cache = cache; }
+
+        // Results of the last solved batch, row i belongs to equation i.
+        [[nodiscard]] const ResultStore<T>& getResults() const noexcept { return m_batch.m_results; }
+
+        // Block sizing of the next batches, tuned by the timings of the previous ones.
+        [[nodiscard]] const GranularityPolicy& getGranularity() const noexcept { return m_granularity; }
+
+    private:
+        // Submits a block task, to its fixed worker if the pool has an affinity.
+        template<typename Callable>
+        auto submitBlock(const std::size_t blockIndex, Callable callable) const;
+        // Plans the batch of state and submits its blocks, an inline batch is solved before returning.
+        // state->m_batch.m_coeffs must already hold the coefficients if coeffs views them.
+        void start(const std::shared_ptr<BatchState>& state, const CoefficientsView& coeffs);
+        // Called by the last finished block of state.
+        void finish(BatchState& state);
+        [[nodiscard]] std::vector<std::string> format(const Batch& batch) const;
+        // Solves the blocks of coeffs into their own result stores, in increasing order, and calls deliver(blockIndex, first, block, results)
+        // On the thread which has solved the block. Returns when every deliver call has returned, rethrows the first exception.
+        template<typename Deliver>
+        void streamBlocks(const CoefficientsView& coeffs, const Deliver& deliver);
 
     private:
-        friend std::ostream& operator<<(std::ostream& os, const ParallelSolver& pSolver);
+        template<typename U>
+        friend std::ostream& operator<<(std::ostream& os, const BasicParallelSolver<U>& pSolver);
 
     private:
-        std::vector<int> m_coeffs; // Vector of coefficients from input (a1, b1, c1, a2, b2, c2, ...).
-        std::vector<std::vector<Solver::Result>> m_results; // Every element represents work done by one thread.
+        mt::ThreadPool* m_threadPool; // Long-lived workers, block tasks are submitted to them.
+        ResultCache<T>* m_cache = nullptr; // Optional cross-batch cache.
+        GranularityPolicy m_granularity; // Decides count of blocks and inline solving.
+        Batch m_batch; // The last batch of operator(), its buffers are reused by the next one.
     };
+
+    template<typename T>
+    std::ostream& operator<<(std::ostream& os, const BasicParallelSolver<T>& pSolver);
+
+    extern template class BasicParallelSolver<float>;
+    extern template class BasicParallelSolver<double>;
+    extern template class BasicParallelSolver<long double>;
+
+    // Precision selected at build time, see SOLVER_FLOAT_TYPE.
+    using ParallelSolver = BasicParallelSolver<Solver::Float>;
 } // namespace slv
 
 #endif
@@ -0,0 +1,548 @@
+/**
+ * @file PolynomialSolver.cpp
+ *
+ * @brief BasicPolynomialSolver class template for finding real roots of polynomials up to degree 4 in batches.
+ *
+ * @author Hovsep Papoyan
+ * Contact: papoyanhovsep93@gmail.com
+ * @Date 2024-03-28
+ *
+ */
+
+#include "PolynomialSolver.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+
+namespace slv
+{
+    namespace
+    {
+        template<typename W>
+        constexpr W pi = static_cast<W>(3.141592653589793238462643383279502884L);
+
+        // Real roots of x^2 + bx + c, counted with multiplicity. Returns 0 or 2.
+        template<typename W>
+        std::size_t solveMonicQuadratic(const W b, const W c, W* const roots)
+        {
+            const W discriminant = b * b - 4 * c;
+            if (discriminant < 0)
+            {
+                return 0;
+            }
+            // The root farther from 0 doesn't subtract close values, the other one is c / t (Vieta).
+            const W t = -(b + std::copysign(std::sqrt(discriminant), b)) / 2;
+            roots[0] = t;
+            roots[1] = t != 0 ? c / t : 0;
+            return 2;
+        }
+
+        // Real roots of x^3 + bx^2 + cx + d, counted with multiplicity. Returns 1 or 3. Used for the resolvent of quartics.
+        template<typename W>
+        std::size_t solveMonicCubic(const W b, const W c, const W d, W* const roots)
+        {
+            const W q = (b * b - 3 * c) / 9;
+            const W r = (b * (2 * b * b - 9 * c) + 27 * d) / 54;
+            const W shift = b / 3;
+            const W qCubed = q * q * q;
+            if (r * r <= qCubed)
+            {
+                // Three real roots, trigonometric form. q is 0 only for a triple root.
+                if (q == 0)
+                {
+                    std::fill(roots, roots + 3, -shift);
+                    return 3;
+                }
+                const W sqrtQ = std::sqrt(q);
+                const W theta = std::acos(std::clamp(r / (q * sqrtQ), W(-1), W(1)));
+                roots[0] = -2 * sqrtQ * std::cos(theta / 3) - shift;
+                roots[1] = -2 * sqrtQ * std::cos((theta + 2 * pi<W>) / 3) - shift;
+                roots[2] = -2 * sqrtQ * std::cos((theta - 2 * pi<W>) / 3) - shift;
+                return 3;
+            }
+            // One real root, Cardano's formula. The sign of the cube root is chosen against cancellation.
+            const W u = -std::copysign(std::cbrt(std::abs(r) + std::sqrt(r * r - qCubed)), r);
+            roots[0] = u + (u != 0 ? q / u : 0) - shift;
+            return 1;
+        }
+
+        // Residues modulo m < 2^32, or modulo 2^64 for m == 0 (wrapping unsigned arithmetic). Two residues multiply without overflow.
+        class Residues
+        {
+        private:
+            std::uint64_t m_modulus;
+
+        public:
+            explicit constexpr Residues(const std::uint64_t modulus) noexcept
+                : m_modulus(modulus)
+            { }
+
+            [[nodiscard]] std::uint64_t operator()(const std::int64_t x) const noexcept
+            {
+                if (m_modulus == 0)
+                {
+                    return static_cast<std::uint64_t>(x);
+                }
+                const std::int64_t modulus = static_cast<std::int64_t>(m_modulus);
+                return static_cast<std::uint64_t>(x % modulus + modulus) % m_modulus;
+            }
+
+            [[nodiscard]] std::uint64_t add(const std::initializer_list<std::uint64_t> terms) const noexcept
+            {
+                std::uint64_t sum = 0;
+                for (const std::uint64_t term : terms)
+                {
+                    sum = reduce(sum + term);
+                }
+                return sum;
+            }
+
+            // x + (m - y) is x - y modulo m, also for m == 0.
+            [[nodiscard]] std::uint64_t subtract(const std::uint64_t x, const std::uint64_t y) const noexcept { return reduce(x + (m_modulus - y)); }
+
+            [[nodiscard]] std::uint64_t multiply(const std::initializer_list<std::uint64_t> factors) const noexcept
+            {
+                std::uint64_t product = 1;
+                for (const std::uint64_t factor : factors)
+                {
+                    product = reduce(product * factor);
+                }
+                return product;
+            }
+
+        private:
+            [[nodiscard]] std::uint64_t reduce(const std::uint64_t x) const noexcept { return m_modulus != 0 ? x % m_modulus : x; }
+        };
+
+        // Tests an integer expression of int coefficients below 2^220 in magnitude (e.g. a discriminant) for 0 exactly,
+        // Without big integers: it is 0 iff it is 0 modulo 2^64 and modulo five primes below 2^32, whose product exceeds 2^223.
+        // expression(residues) computes it with the arithmetic of residues, its constant factors must be below 2^32.
+        template<typename Expression>
+        [[nodiscard]] bool isExactlyZero(const Expression& expression) noexcept
+        {
+            static constexpr std::uint64_t moduli[] = { 0, 4294967291, 4294967279, 4294967231, 4294967197, 4294967189 }; // 0 stands for 2^64.
+            return std::all_of(std::begin(moduli), std::end(moduli), [&expression](const std::uint64_t m) { return expression(Residues(m)) == 0; });
+        }
+
+        // 18abcd - 4b^3d + b^2c^2 - 4ac^3 - 27a^2d^2, up to 2^130.
+        [[nodiscard]] bool isCubicDiscriminantZero(const int a, const int b, const int c, const int d) noexcept
+        {
+            return isExactlyZero([=](const Residues& z)
+                {
+                    const std::uint64_t ra = z(a);
+                    const std::uint64_t rb = z(b);
+                    const std::uint64_t rc = z(c);
+                    const std::uint64_t rd = z(d);
+                    return z.subtract(z.add({ z.multiply({ 18, ra, rb, rc, rd }), z.multiply({ rb, rb, rc, rc }) }),
+                        z.add({ z.multiply({ 4, rb, rb, rb, rd }), z.multiply({ 4, ra, rc, rc, rc }), z.multiply({ 27, ra, ra, rd, rd }) }));
+                });
+        }
+
+        // The 16 terms of the quartic discriminant, up to 2^197.
+        [[nodiscard]] bool isQuarticDiscriminantZero(const int a, const int b, const int c, const int d, const int e) noexcept
+        {
+            return isExactlyZero([=](const Residues& z)
+                {
+                    const std::uint64_t ra = z(a);
+                    const std::uint64_t rb = z(b);
+                    const std::uint64_t rc = z(c);
+                    const std::uint64_t rd = z(d);
+                    const std::uint64_t re = z(e);
+                    const std::uint64_t positive = z.add({ z.multiply({ 256, ra, ra, ra, re, re, re }), z.multiply({ 144, ra, ra, rc, rd, rd, re }),
+                        z.multiply({ 144, ra, rb, rb, rc, re, re }), z.multiply({ 18, ra, rb, rc, rd, rd, rd }), z.multiply({ 16, ra, rc, rc, rc, rc, re }),
+                        z.multiply({ 18, rb, rb, rb, rc, rd, re }), z.multiply({ rb, rb, rc, rc, rd, rd }) });
+                    const std::uint64_t negative = z.add({ z.multiply({ 192, ra, ra, rb, rd, re, re }), z.multiply({ 128, ra, ra, rc, rc, re, re }),
+                        z.multiply({ 27, ra, ra, rd, rd, rd, rd }), z.multiply({ 6, ra, rb, rb, rd, rd, re }), z.multiply({ 80, ra, rb, rc, rc, rd, re }),
+                        z.multiply({ 4, ra, rc, rc, rc, rd, rd }), z.multiply({ 27, rb, rb, rb, rb, re, re }), z.multiply({ 4, rb, rb, rb, rd, rd, rd }),
+                        z.multiply({ 4, rb, rb, rc, rc, rc, re }) });
+                    return z.subtract(positive, negative);
+                });
+        }
+
+        // The sign of 8ac - 3b^2, exactly. 3b^2 < 2^64, but 8ac may not fit, so ac is compared with the quotient of 3b^2 by 8.
+        [[nodiscard]] int getQuarticPSign(const int a, const int b, const int c) noexcept
+        {
+            const std::int64_t ac = static_cast<std::int64_t>(a) * c;
+            const std::uint64_t threeBSquared = 3 * static_cast<std::uint64_t>(static_cast<std::int64_t>(b) * b);
+            const std::uint64_t quotient = threeBSquared / 8;
+            if (ac < 0 || static_cast<std::uint64_t>(ac) < quotient)
+            {
+                return -1;
+            }
+            if (static_cast<std::uint64_t>(ac) > quotient)
+            {
+                return 1;
+            }
+            return threeBSquared % 8 != 0 ? -1 : 0;
+        }
+
+        // Real roots of ax^3 + bx^2 + cx + d of int coefficients, a != 0, counted with multiplicity. Returns 1 or 3.
+        // With D0 = b^2 - 3ac and D1 = 2b^3 - 9abc + 27a^2d the discriminant is (4D0^3 - D1^2) / 27a^2. Its 0 is detected exactly,
+        // Then the double root is the rational (9ad - bc) / 2D0, or -b / 3a is a triple root if D0 = 0 too.
+        template<typename W>
+        std::size_t solveCubic(const int a, const int b, const int c, const int d, W* const roots)
+        {
+            const W floatingA = a;
+            const W floatingB = b;
+            const W floatingC = c;
+            const W floatingD = d;
+            const W shift = floatingB / (3 * floatingA);
+            if (isCubicDiscriminantZero(a, b, c, d))
+            {
+                if (isExactlyZero([=](const Residues& z) { return z.subtract(z.multiply({ z(b), z(b) }), z.multiply({ 3, z(a), z(c) })); }))
+                {
+                    std::fill(roots, roots + 3, -shift);
+                    return 3;
+                }
+                const W doubleRoot = (9 * floatingA * floatingD - floatingB * floatingC) / (2 * (floatingB * floatingB - 3 * floatingA * floatingC));
+                roots[0] = doubleRoot;
+                roots[1] = doubleRoot;
+                roots[2] = -floatingB / floatingA - 2 * doubleRoot; // Vieta.
+                return 3;
+            }
+            const W d0 = floatingB * floatingB - 3 * floatingA * floatingC;
+            const W d1 = floatingB * (2 * floatingB * floatingB - 9 * floatingA * floatingC) + 27 * floatingA * floatingA * floatingD;
+            if (d1 * d1 < 4 * d0 * d0 * d0)
+            {
+                // Three distinct real roots, trigonometric form.
+                const W sqrtD0 = std::sqrt(d0);
+                const W cosine = d1 / (2 * d0 * sqrtD0) * (a < 0 ? -1 : 1);
+                const W theta = std::acos(std::clamp(cosine, W(-1), W(1)));
+                const W amplitude = -2 * sqrtD0 / (3 * std::abs(floatingA));
+                roots[0] = amplitude * std::cos(theta / 3) - shift;
+                roots[1] = amplitude * std::cos((theta + 2 * pi<W>) / 3) - shift;
+                roots[2] = amplitude * std::cos((theta - 2 * pi<W>) / 3) - shift;
+                return 3;
+            }
+            // One real root, Cardano's formula for the monic x^3 + (b / a)x^2 + ..., q and r as in solveMonicCubic.
+            const W q = d0 / (9 * floatingA * floatingA);
+            const W r = d1 / (54 * floatingA * floatingA * floatingA);
+            const W u = -std::copysign(std::cbrt(std::abs(r) + std::sqrt(std::max(r * r - q * q * q, W(0)))), r);
+            roots[0] = u + (u != 0 ? q / u : 0) - shift;
+            return 1;
+        }
+
+        // Real roots of x^4 + bx^3 + cx^2 + dx + e, counted with multiplicity (Ferrari's method). Returns 0, 2 or 4.
+        template<typename W>
+        std::size_t solveMonicQuartic(const W b, const W c, const W d, const W e, W* const roots)
+        {
+            // x = y - b / 4 gives the depressed quartic y^4 + py^2 + qy + r.
+            const W shift = b / 4;
+            const W bSquared = b * b;
+            const W p = c - 3 * bSquared / 8;
+            const W q = d - b * c / 2 + bSquared * b / 8;
+            const W r = e - b * d / 4 + bSquared * c / 16 - 3 * bSquared * bSquared / 256;
+
+            // m is the largest root of the resolvent cubic m^3 + pm^2 + (p^2 / 4 - r)m - q^2 / 8, it is positive if q != 0.
+            // Then y^4 + py^2 + qy + r = (y^2 + sy + p / 2 + m - q / 2s)(y^2 - sy + p / 2 + m + q / 2s), s = sqrt(2m).
+            W m = 0;
+            if (q != 0)
+            {
+                W resolventRoots[3];
+                const std::size_t resolventCount = solveMonicCubic(p, p * p / 4 - r, -q * q / 8, resolventRoots);
+                m = *std::max_element(resolventRoots, resolventRoots + resolventCount);
+            }
+            std::size_t count = 0;
+            if (m > 0)
+            {
+                const W s = std::sqrt(2 * m);
+                count += solveMonicQuadratic(s, p / 2 + m - q / (2 * s), roots);
+                count += solveMonicQuadratic(-s, p / 2 + m + q / (2 * s), roots + count);
+            }
+            else
+            {
+                // Biquadratic (q is 0 or too small to be told apart from it): z = y^2, z^2 + pz + r = 0.
+                W z[2];
+                if (solveMonicQuadratic(p, r, z) != 0)
+                {
+                    for (const W root : z)
+                    {
+                        if (root >= 0)
+                        {
+                            roots[count++] = std::sqrt(root);
+                            roots[count++] = -std::sqrt(root);
+                        }
+                    }
+                }
+            }
+            for (std::size_t j = 0; j < count; ++j)
+            {
+                roots[j] -= shift;
+            }
+            return count;
+        }
+
+        // Real roots of ax^4 + bx^3 + cx^2 + dx + e of int coefficients, a != 0 and e != 0, counted with multiplicity. Returns 0, 2 or 4.
+        // Ferrari's method, unless the discriminant is exactly 0. Then, with D0 = c^2 - 3bd + 12ae, D = 64a^3e - 16a^2c^2 + 16ab^2c - 16a^2bd - 3b^4,
+        // P = 8ac - 3b^2 and R = b^3 + 8a^2d - 4abc (all tested exactly):
+        // - D = D0 = 0: a quadruple root -b / 4a.
+        // - D = 0 and P < 0, or D = 0, P > 0 and R = 0: the quartic is a(x^2 + ux + v)^2, two double roots (or two complex double ones).
+        // - Otherwise one real root t is repeated (a triple one if D0 = 0), and the rest are roots of the quartic divided by a(x - t)^2.
+        template<typename W>
+        std::size_t solveQuartic(const int a, const int b, const int c, const int d, const int e, W* const roots)
+        {
+            const W floatingA = a;
+            const W floatingB = b / floatingA;
+            const W floatingC = c / floatingA;
+            const W floatingD = d / floatingA;
+            const W floatingE = e / floatingA;
+            if (!isQuarticDiscriminantZero(a, b, c, d, e))
+            {
+                return solveMonicQuartic(floatingB, floatingC, floatingD, floatingE, roots);
+            }
+            const bool isD0Zero = isExactlyZero([=](const Residues& z)
+                {
+                    return z.subtract(z.add({ z.multiply({ z(c), z(c) }), z.multiply({ 12, z(a), z(e) }) }), z.multiply({ 3, z(b), z(d) }));
+                });
+            const bool isDZero = isExactlyZero([=](const Residues& z)
+                {
+                    const std::uint64_t ra = z(a);
+                    const std::uint64_t rb = z(b);
+                    const std::uint64_t rc = z(c);
+                    return z.subtract(z.add({ z.multiply({ 64, ra, ra, ra, z(e) }), z.multiply({ 16, ra, rb, rb, rc }) }),
+                        z.add({ z.multiply({ 16, ra, ra, rc, rc }), z.multiply({ 16, ra, ra, rb, z(d) }), z.multiply({ 3, rb, rb, rb, rb }) }));
+                });
+            if (isDZero && isD0Zero)
+            {
+                std::fill(roots, roots + 4, -floatingB / 4);
+                return 4;
+            }
+            const int pSign = isDZero ? getQuarticPSign(a, b, c) : 0;
+            const bool isSquare = pSign < 0 || (pSign > 0 && isExactlyZero([=](const Residues& z)
+                {
+                    const std::uint64_t ra = z(a);
+                    const std::uint64_t rb = z(b);
+                    return z.subtract(z.add({ z.multiply({ rb, rb, rb }), z.multiply({ 8, ra, ra, z(d) }) }), z.multiply({ 4, ra, rb, z(c) }));
+                }));
+            if (isSquare)
+            {
+                const W u = floatingB / 2;
+                const W v = (floatingC - u * u) / 2;
+                W squareRoots[2];
+                if (solveMonicQuadratic(u, v, squareRoots) == 0)
+                {
+                    return 0;
+                }
+                std::fill(roots, roots + 2, squareRoots[0]);
+                std::fill(roots + 2, roots + 4, squareRoots[1]);
+                return 4;
+            }
+
+            // A double root is a root of the derivative, a triple one of the second derivative as well.
+            // Of their roots t is the one where the quartic is closest to 0.
+            W candidates[3];
+            const std::size_t candidatesCount = isD0Zero ? solveMonicQuadratic(floatingB / 2, floatingC / 6, candidates)
+                : solveMonicCubic(3 * floatingB / 4, floatingC / 2, floatingD / 4, candidates);
+            const auto getAbsValue = [&](const W x) { return std::abs((((x + floatingB) * x + floatingC) * x + floatingD) * x + floatingE); };
+            if (candidatesCount == 0)
+            {
+                return solveMonicQuartic(floatingB, floatingC, floatingD, floatingE, roots);
+            }
+            const W t = *std::min_element(candidates, candidates + candidatesCount, [&getAbsValue](const W x, const W y) { return getAbsValue(x) < getAbsValue(y); });
+            // x^4 + Bx^3 + Cx^2 + Dx + E = (x - t)^2 (x^2 + beta x + gamma).
+            const W beta = floatingB + 2 * t;
+            const W gamma = floatingC + 2 * t * beta - t * t;
+            roots[0] = t;
+            roots[1] = t;
+            return 2 + solveMonicQuadratic(beta, gamma, roots + 2);
+        }
+
+        [[nodiscard]] PolynomialKind toPolynomialKind(const ResultKind kind) noexcept
+        {
+            switch (kind)
+            {
+            case ResultKind::Linear:
+                return PolynomialKind::OneRoot;
+            case ResultKind::Identity:
+                return PolynomialKind::Identity;
+            case ResultKind::Incorrect:
+                return PolynomialKind::Incorrect;
+            case ResultKind::NoRealRoots:
+                return PolynomialKind::NoRealRoots;
+            default:
+                return PolynomialKind::TwoRoots;
+            }
+        }
+    } // namespace
+
+    template<typename T>
+    typename BasicPolynomialSolver<T>::Result BasicPolynomialSolver<T>::solve(const int* const coefficients, const std::size_t degree)
+    {
+        T roots[maxDegree];
+        PolynomialKind kind;
+        const ResultColumns results{ { roots, roots + 1, roots + 2, roots + 3 }, &kind };
+        solveBatch(PolynomialsView(coefficients, 1, degree), results);
+        return toResult(results, 0);
+    }
+
+    template<typename T>
+    void BasicPolynomialSolver<T>::solveBatch(const PolynomialsView& polynomials, const ResultColumns& results)
+    {
+        // Closed forms and polishing are computed in at least double precision.
+        using W = std::common_type_t<T, double>;
+
+        // Chunk columns, coefficients are padded with leading zeros to maxDegree, so that every row has the same Horner scheme.
+        // Rows which aren't polished get zero coefficients, Newton's steps leave their roots as they are.
+        W coefficients[maxDegree + 1][chunkSize];
+        W roots[maxDegree][chunkSize];
+        PolynomialKind kinds[chunkSize];
+        // Rows of degree 2 and less, solved together by BasicSolver::solveBatch.
+        int aQuadratic[chunkSize];
+        int bQuadratic[chunkSize];
+        int cQuadratic[chunkSize];
+        std::size_t quadraticRows[chunkSize];
+        std::size_t quadraticZerosCounts[chunkSize];
+        T firstRoots[chunkSize];
+        T secondRoots[chunkSize];
+        T extremums[chunkSize];
+        T criticalPoints[chunkSize];
+        ResultKind quadraticKinds[chunkSize];
+        const typename BasicSolver<T>::ResultColumns quadraticResults{ firstRoots, secondRoots, extremums, criticalPoints, quadraticKinds };
+
+        const std::size_t degree = polynomials.getDegree();
+        const std::size_t padding = maxDegree - degree;
+        const std::size_t sz = polynomials.size();
+        for (std::size_t first = 0; first != sz; )
+        {
+            const std::size_t count = std::min(chunkSize, sz - first);
+
+            // Closed forms, row by row.
+            std::size_t quadraticCount = 0;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                int row[maxDegree + 1] = {};
+                for (std::size_t k = 0; k <= degree; ++k)
+                {
+                    row[padding + k] = polynomials.coefficient(first + i, k);
+                }
+                const bool polish = row[0] != 0 || row[1] != 0;
+                for (std::size_t k = 0; k <= maxDegree; ++k)
+                {
+                    coefficients[k][i] = polish ? row[k] : 0;
+                }
+                // Zero roots of cubics and quartics are taken out exactly, the rest are the roots of row / x^zerosCount.
+                W rowRoots[maxDegree] = {};
+                std::size_t zerosCount = 0;
+                while ((row[0] != 0 || row[1] != 0) && row[maxDegree] == 0)
+                {
+                    std::copy_backward(row, row + maxDegree, row + maxDegree + 1);
+                    row[0] = 0;
+                    ++zerosCount;
+                }
+                std::size_t rootsCount = zerosCount;
+                if (row[0] != 0)
+                {
+                    rootsCount += solveQuartic<W>(row[0], row[1], row[2], row[3], row[4], rowRoots + zerosCount);
+                }
+                else if (row[1] != 0)
+                {
+                    rootsCount += solveCubic<W>(row[1], row[2], row[3], row[4], rowRoots + zerosCount);
+                }
+                else
+                {
+                    aQuadratic[quadraticCount] = row[2];
+                    bQuadratic[quadraticCount] = row[3];
+                    cQuadratic[quadraticCount] = row[4];
+                    quadraticZerosCounts[quadraticCount] = zerosCount;
+                    quadraticRows[quadraticCount++] = i;
+                }
+                kinds[i] = static_cast<PolynomialKind>(rootsCount);
+                for (std::size_t j = 0; j < maxDegree; ++j)
+                {
+                    roots[j][i] = rowRoots[j];
+                }
+            }
+            if (quadraticCount != 0)
+            {
+                BasicSolver<T>::solveBatch(aQuadratic, bQuadratic, cQuadratic, quadraticCount, quadraticResults);
+                for (std::size_t j = 0; j < quadraticCount; ++j)
+                {
+                    // A quadratic left after taking out zeros has a != 0, so it has 0 or 2 roots.
+                    const std::size_t i = quadraticRows[j];
+                    const std::size_t zerosCount = quadraticZerosCounts[j];
+                    const PolynomialKind kind = toPolynomialKind(quadraticKinds[j]);
+                    kinds[i] = zerosCount == 0 ? kind : static_cast<PolynomialKind>(zerosCount + getRootsCount(kind));
+                    if (getRootsCount(kind) != 0)
+                    {
+                        roots[zerosCount][i] = firstRoots[j];
+                    }
+                    if (getRootsCount(kind) == 2)
+                    {
+                        roots[zerosCount + 1][i] = secondRoots[j];
+                    }
+                }
+            }
+
+            // Newton's method on the whole chunk. A step is taken only if it brings the value closer to 0,
+            // So roots already at the rounding noise of the evaluation stay. Unused root slots hold 0 and are polished in vain,
+            // Which keeps the loop free of branches, so that it is vectorized over rows (full vector width with -O3 or /O2).
+            static_assert(maxDegree == 4, "Horner schemes below are written for quartics");
+            for (int iteration = 0; iteration < polishIterations; ++iteration)
+            {
+                for (std::size_t j = 0; j < maxDegree; ++j)
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        const W c0 = coefficients[0][i];
+                        const W c1 = coefficients[1][i];
+                        const W c2 = coefficients[2][i];
+                        const W c3 = coefficients[3][i];
+                        const W c4 = coefficients[4][i];
+                        const W x = roots[j][i];
+                        const W value = (((c0 * x + c1) * x + c2) * x + c3) * x + c4;
+                        const W derivative = ((4 * c0 * x + 3 * c1) * x + 2 * c2) * x + c3;
+                        const W step = value / (derivative != 0 ? derivative : W(1));
+                        const W candidate = derivative != 0 ? x - step : x;
+                        const W candidateValue = (((c0 * candidate + c1) * candidate + c2) * candidate + c3) * candidate + c4;
+                        roots[j][i] = std::abs(candidateValue) < std::abs(value) ? candidate : x;
+                    }
+                }
+            }
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const std::size_t rootsCount = getRootsCount(kinds[i]);
+                // Insertion sort, there are at most maxDegree roots.
+                W rowRoots[maxDegree];
+                for (std::size_t j = 0; j < rootsCount; ++j)
+                {
+                    std::size_t k = j;
+                    for (; k > 0 && rowRoots[k - 1] > roots[j][i]; --k)
+                    {
+                        rowRoots[k] = rowRoots[k - 1];
+                    }
+                    rowRoots[k] = roots[j][i];
+                }
+                for (std::size_t j = 0; j < rootsCount; ++j)
+                {
+                    // -0 is printed as 0.
+                    const T root = static_cast<T>(rowRoots[j]);
+                    results.m_roots[j][first + i] = root != 0 ? root : T(0);
+                }
+                results.m_kinds[first + i] = kinds[i];
+            }
+            first += count;
+        }
+    }
+
+    template<typename T>
+    typename BasicPolynomialSolver<T>::Result BasicPolynomialSolver<T>::toResult(const ResultColumns& results, const std::size_t i)
+    {
+        Result result{ results.m_kinds[i], {} };
+        const std::size_t rootsCount = getRootsCount(result.m_kind);
+        result.m_roots.reserve(rootsCount);
+        for (std::size_t j = 0; j < rootsCount; ++j)
+        {
+            result.m_roots.push_back(results.m_roots[j][i]);
+        }
+        return result;
+    }
+
+    template class BasicPolynomialSolver<float>;
+    template class BasicPolynomialSolver<double>;
+    template class BasicPolynomialSolver<long double>;
+} // namespace slv
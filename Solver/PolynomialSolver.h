@@ -0,0 +1,219 @@
+/**
+ * @file PolynomialSolver.h
+ *
+ * @brief BasicPolynomialSolver class template for finding real roots of polynomials up to degree 4 in batches.
+ *
+ * @author Hovsep Papoyan
+ * Contact: papoyanhovsep93@gmail.com
+ * @Date 2024-03-28
+ *
+ */
+
+#ifndef POLYNOMIAL_SOLVER_H
+#define POLYNOMIAL_SOLVER_H
+
+#include "ResultStore.h"
+#include "Solver.h"
+#include "Topology.h"
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace slv
+{
+    // Classification of one polynomial, produced by BasicPolynomialSolver::solveBatch.
+    // Values up to FourRoots are the counts of real roots, multiple roots are counted with their multiplicity
+    // (Same as ResultKind::TwoRoots for D = 0).
+    enum class PolynomialKind : unsigned char
+    {
+        NoRealRoots,
+        OneRoot,
+        TwoRoots,
+        ThreeRoots,
+        FourRoots,
+        Identity,  // All coefficients are 0.
+        Incorrect  // Only the constant term isn't 0.
+    };
+
+    [[nodiscard]] constexpr std::size_t getRootsCount(const PolynomialKind kind) noexcept
+    {
+        return kind <= PolynomialKind::FourRoots ? static_cast<std::size_t>(kind) : 0;
+    }
+
+    // Polynomials of the same degree, interleaved with the highest power first: (a1, b1, ..., a2, b2, ...).
+    // Polynomial i has degree + 1 coefficients starting at m_data[i * (degree + 1)].
+    class PolynomialsView
+    {
+    private:
+        const int* m_data = nullptr;
+        std::size_t m_count = 0;
+        std::size_t m_degree = 0;
+
+    public:
+        constexpr PolynomialsView() noexcept = default;
+        constexpr PolynomialsView(const int* const coeffs, const std::size_t count, const std::size_t degree) noexcept
+            : m_data(coeffs)
+            , m_count(count)
+            , m_degree(degree)
+        { }
+
+        // Coefficient k of polynomial i, the one of x^(degree - k).
+        [[nodiscard]] constexpr int coefficient(const std::size_t i, const std::size_t k) const noexcept { return m_data[i * (m_degree + 1) + k]; }
+        [[nodiscard]] constexpr const int* data() const noexcept { return m_data; }
+
+        // Count of polynomials.
+        [[nodiscard]] constexpr std::size_t size() const noexcept { return m_count; }
+        [[nodiscard]] constexpr std::size_t getDegree() const noexcept { return m_degree; }
+
+        // Polynomials [first, first + count).
+        [[nodiscard]] constexpr PolynomialsView subview(const std::size_t first, const std::size_t count) const noexcept
+        {
+            return PolynomialsView(m_data + first * (m_degree + 1), count, m_degree);
+        }
+    };
+
+    // Cubic and quartic rows are solved in two passes over chunks of rows:
+    // - Closed form: Cardano's formula (trigonometric form for three real roots) and Ferrari's method through the resolvent cubic.
+    // - Newton polishing of all roots of the chunk in lockstep, on coefficient and root columns (structure of arrays),
+    //   So the loop is vectorized and recovers the accuracy the closed forms lose to cancellation.
+    // Rows whose leading coefficients are 0 are solved as lower degree ones, rows of degree 2 and less go to BasicSolver::solveBatch
+    // Together, so they get its exact integer discriminant and the BatchKernel of the CPU.
+    // Instantiated for float, double and long double (see PolynomialSolver.cpp), float is computed in double.
+    template<typename T>
+    class BasicPolynomialSolver
+    {
+    public:
+        using Float = T;
+
+        static constexpr std::size_t maxDegree = 4;
+        static constexpr std::size_t chunkSize = 256;
+        static constexpr int polishIterations = 2;
+
+        // Output columns of solveBatch. Every pointer must address at least count elements.
+        // m_roots[j][i] is the root j of row i, meaningful for j < getRootsCount(m_kinds[i]). Roots of a row are ascending.
+        struct ResultColumns
+        {
+            T* m_roots[maxDegree];
+            PolynomialKind* m_kinds;
+        };
+
+        struct Result
+        {
+            PolynomialKind m_kind;
+            std::vector<T> m_roots; // Ascending.
+
+            friend bool operator==(const Result&, const Result&) = default;
+        };
+
+        // Solves one polynomial of degree <= maxDegree, same results as solveBatch.
+        [[nodiscard]] static Result solve(const int* const coefficients, const std::size_t degree);
+
+        // Solves polynomials.size() polynomials of degree <= maxDegree.
+        static void solveBatch(const PolynomialsView& polynomials, const ResultColumns& results);
+
+        // Converts row i of solveBatch output into the Result representation.
+        [[nodiscard]] static Result toResult(const ResultColumns& results, const std::size_t i);
+    };
+
+    extern template class BasicPolynomialSolver<float>;
+    extern template class BasicPolynomialSolver<double>;
+    extern template class BasicPolynomialSolver<long double>;
+
+    // Same as ResultStore, with maxDegree root columns (maxDegree * sizeof(T) + 1 bytes per row).
+    template<typename T>
+    class PolynomialResultStore
+    {
+    public:
+        using Solver = BasicPolynomialSolver<T>;
+        using ResultColumns = typename Solver::ResultColumns;
+
+        static constexpr std::size_t minPlacedBytes = ResultStore<T>::minPlacedBytes;
+
+    private:
+        static constexpr std::size_t maxDegree = Solver::maxDegree;
+        static constexpr std::size_t rowBytes = maxDegree * sizeof(T) + sizeof(PolynomialKind);
+
+        std::unique_ptr<T[]> m_heap;
+        mt::PageBuffer m_pages;
+        T* m_columns = nullptr; // maxDegree root columns of m_capacity rows, then kinds.
+        std::size_t m_size = 0;
+        std::size_t m_capacity = 0;
+
+    public:
+        PolynomialResultStore() = default;
+        PolynomialResultStore(const PolynomialResultStore&) = delete;
+        PolynomialResultStore(PolynomialResultStore&& rhs) noexcept
+            : m_heap(std::move(rhs.m_heap))
+            , m_pages(std::move(rhs.m_pages))
+            , m_columns(std::exchange(rhs.m_columns, nullptr))
+            , m_size(std::exchange(rhs.m_size, 0))
+            , m_capacity(std::exchange(rhs.m_capacity, 0))
+        { }
+        PolynomialResultStore& operator=(const PolynomialResultStore&) = delete;
+        PolynomialResultStore& operator=(PolynomialResultStore&& rhs) noexcept
+        {
+            m_heap = std::move(rhs.m_heap);
+            m_pages = std::move(rhs.m_pages);
+            m_columns = std::exchange(rhs.m_columns, nullptr);
+            m_size = std::exchange(rhs.m_size, 0);
+            m_capacity = std::exchange(rhs.m_capacity, 0);
+            return *this;
+        }
+        ~PolynomialResultStore() = default;
+
+        // Makes room for count rows, as ResultStore::resize does.
+        void resize(const std::size_t count, const bool placePages = false)
+        {
+            const std::size_t bytes = count * rowBytes;
+            const bool place = placePages && bytes >= minPlacedBytes;
+            if (count > m_capacity || place)
+            {
+                *this = PolynomialResultStore{};
+                if (place)
+                {
+                    m_pages = mt::PageBuffer(bytes);
+                    m_columns = static_cast<T*>(m_pages.data());
+                }
+                else
+                {
+                    m_heap = std::make_unique_for_overwrite<T[]>((bytes + sizeof(T) - 1) / sizeof(T));
+                    m_columns = m_heap.get();
+                }
+                m_capacity = count;
+            }
+            m_size = count;
+        }
+
+        // Frees the memory.
+        void clear() noexcept
+        {
+            *this = PolynomialResultStore{};
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept { return m_size; }
+
+        // Columns starting at row first.
+        [[nodiscard]] ResultColumns getColumns(const std::size_t first = 0) const noexcept
+        {
+            ResultColumns result{};
+            for (std::size_t j = 0; j < maxDegree; ++j)
+            {
+                result.m_roots[j] = m_columns + j * m_capacity + first;
+            }
+            result.m_kinds = reinterpret_cast<PolynomialKind*>(m_columns + maxDegree * m_capacity) + first;
+            return result;
+        }
+
+        [[nodiscard]] PolynomialKind getKind(const std::size_t i) const noexcept { return getColumns().m_kinds[i]; }
+
+        // Row i in the Result representation.
+        [[nodiscard]] typename Solver::Result operator[](const std::size_t i) const
+        {
+            return Solver::toResult(getColumns(), i);
+        }
+    };
+} // namespace slv
+
+#endif
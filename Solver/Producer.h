@@ -14,69 +14,105 @@
 
 #include "ProducerConsumerBase.h"
 
+#include <chrono>
+
 namespace mt
 {
-    template<typename Adapter>
-    class Producer : public ProducerConsumerBase<Adapter>
+    // When the shared container is full (see ThreadSafeSTLAdapter::setCapacity) the worker thread waits for the consumers,
+    // And pushed batches wait in the producer. With pendingBatchesCapacity push itself waits, so memory stays bounded end to end.
+    template<typename Adapter, typename WaitPolicy = SpinThenParkWaitPolicy<>>
+    class Producer : public ProducerConsumerBase<Adapter, WaitPolicy>
     {
     private:
-        using Super = ProducerConsumerBase<Adapter>;
+        using Super = ProducerConsumerBase<Adapter, WaitPolicy>;
         using Elem = typename Adapter::Elem;
+        // A worker blocked by a full shared container rechecks this often whether it is being stopped.
+        static constexpr std::chrono::milliseconds backpressureCheckInterval{ 10 };
+
         decltype(createThreadSafeSTLAdapterFrom(std::queue<std::vector<Elem>>{})) m_vectorItemsQueue;
+        // The batch being pushed by the worker thread, a stopped worker leaves the rest of it to the next one.
+        std::vector<Elem> m_pendingItems;
+        std::size_t m_pushedItemsCount;
 
     public:
-        explicit Producer(Adapter& sharedContainer);
+        // pendingBatchesCapacity bounds the count of batches waiting for the worker thread, 0 means unbounded.
+        explicit Producer(Adapter& sharedContainer, const std::size_t pendingBatchesCapacity = 0);
         Producer(const Producer&) = default;
         Producer(Producer&&) = default;
         Producer& operator=(const Producer&) = default;
         Producer& operator=(Producer&) = default;
         ~Producer() override;
 
+        // Waits while pendingBatchesCapacity batches are waiting.
         void push(std::vector<Elem> items);
+        // Ends the input. The worker thread pushes the remaining items, then closes the shared container
+        // And resolves the completion future. push must not be called after close.
+        void close();
 
     private:
         void workerThreadWork() override;
+        void wakeUpWorkerThread() override;
     };
 
-    template<typename Adapter>
-    Producer<Adapter>::Producer(Adapter& sharedContainer)
+    template<typename Adapter, typename WaitPolicy>
+    Producer<Adapter, WaitPolicy>::Producer(Adapter& sharedContainer, const std::size_t pendingBatchesCapacity)
         : Super(Super::Type::Producer, sharedContainer)
         , m_vectorItemsQueue(createThreadSafeSTLAdapterFrom(std::queue<std::vector<Elem>>{}))
+        , m_pushedItemsCount(0)
     {
+        m_vectorItemsQueue.setCapacity(pendingBatchesCapacity);
         this->runMainThread();
     }
 
-    template<typename Adapter>
-    Producer<Adapter>::~Producer()
+    template<typename Adapter, typename WaitPolicy>
+    Producer<Adapter, WaitPolicy>::~Producer()
     {
         this->shutdownMainThread();
     }
 
-    template<typename Adapter>
-    void Producer<Adapter>::push(std::vector<Elem> items)
+    template<typename Adapter, typename WaitPolicy>
+    void Producer<Adapter, WaitPolicy>::push(std::vector<Elem> items)
     {
         m_vectorItemsQueue.push(std::move(items));
     }
 
-    template<typename Adapter>
-    void Producer<Adapter>::workerThreadWork()
+    template<typename Adapter, typename WaitPolicy>
+    void Producer<Adapter, WaitPolicy>::close()
+    {
+        m_vectorItemsQueue.close();
+    }
+
+    template<typename Adapter, typename WaitPolicy>
+    void Producer<Adapter, WaitPolicy>::workerThreadWork()
     {
         while (this->m_workerThreadEnabled)
         {
-            std::vector<Elem> vectorItem;
-            if (m_vectorItemsQueue.tryPop(vectorItem))
+            if (m_pushedItemsCount != m_pendingItems.size())
             {
-                for (auto& item : vectorItem)
-                {
-                    this->m_sharedContainer.push(std::move(item));
-                }
+                // The batch goes to the shared container in runs, as large as the room in it allows.
+                const auto first = m_pendingItems.begin() + static_cast<std::ptrdiff_t>(m_pushedItemsCount);
+                const auto pushedEnd = this->m_sharedContainer.pushBulkFor(first, m_pendingItems.end(), backpressureCheckInterval);
+                m_pushedItemsCount = static_cast<std::size_t>(pushedEnd - m_pendingItems.begin());
             }
-            else
+            else if (this->waitForWork(m_vectorItemsQueue, [&] { return m_vectorItemsQueue.tryPop(m_pendingItems); }))
             {
-                std::this_thread::yield();
+                m_pushedItemsCount = 0;
+            }
+            else if (m_vectorItemsQueue.isDrained())
+            {
+                this->m_sharedContainer.close();
+                this->complete();
+                return;
             }
         }
     }
+
+    template<typename Adapter, typename WaitPolicy>
+    void Producer<Adapter, WaitPolicy>::wakeUpWorkerThread()
+    {
+        // The producer's worker parks on its own queue, not on the shared container.
+        m_vectorItemsQueue.notifyAll();
+    }
 } // namespace mt
 
 #endif
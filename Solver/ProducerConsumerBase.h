@@ -13,13 +13,22 @@
 #define PRODUCER_CONSUMER_BASE_H
 
 #include "ThreadSafeSTLAdapter.h"
+#include "WaitPolicy.h"
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <future>
 #include <iostream>
+#include <mutex>
 #include <queue>
+#include <thread>
+#include <vector>
 
 namespace mt
 {
-    template<typename Adapter>
+    // WaitPolicy decides what an idle worker thread does (see WaitPolicy.h).
+    template<typename Adapter, typename WaitPolicy = SpinThenParkWaitPolicy<>>
     class ProducerConsumerBase
     {
     protected:
@@ -42,13 +51,22 @@ namespace mt
 
     protected:
         Adapter& m_sharedContainer;
-        std::unique_ptr<std::jthread> m_workerThread;
+        std::vector<std::jthread> m_workerThreads;
         std::mutex m_workerThreadMutex;
         std::atomic<bool> m_workerThreadEnabled;
         std::string_view m_name;
+        WaitPolicy m_waitPolicy;
+
+    private:
+        std::promise<void> m_completionPromise;
+        std::shared_future<void> m_completionFuture;
+        std::atomic<bool> m_completed;
+        const std::size_t m_workersCount;
+        std::atomic<std::size_t> m_runningWorkersCount;
 
     public:
-        explicit ProducerConsumerBase(const Type type, Adapter& sharedContainer);
+        // workersCount worker threads run workerThreadWork() concurrently while enabled.
+        explicit ProducerConsumerBase(const Type type, Adapter& sharedContainer, const std::size_t workersCount = 1);
         ProducerConsumerBase(const ProducerConsumerBase&) = default;
         ProducerConsumerBase(ProducerConsumerBase&&) = default;
         ProducerConsumerBase& operator=(const ProducerConsumerBase&) = default;
@@ -58,38 +76,57 @@ namespace mt
         void enableWorkerThread();
         void disableWorkerThread();
 
+        // Becomes ready when the worker thread has processed its whole input, after the input has been closed.
+        // Holds the exception if the worker thread has failed.
+        [[nodiscard]] std::shared_future<void> getCompletionFuture() const { return m_completionFuture; }
+
     protected:
         void runMainThread();
         void shutdownMainThread();
 
+        // Tries tryFn() according to the wait policy, parking on queue when there is nothing to do.
+        // Returns false if tryFn() has not succeeded, the caller should recheck m_workerThreadEnabled and retry.
+        template<typename Queue, typename TryFn>
+        [[nodiscard]] bool waitForWork(Queue& queue, TryFn&& tryFn);
+
+        // Called by a worker thread which has finished its input. The completion future is resolved
+        // When every worker thread has called it, or at once with error. Only the first resolution has an effect.
+        void complete(std::exception_ptr error = nullptr);
+
     private:
         virtual void workerThreadWork() = 0;
+        // Wakes the worker thread if it is parked. Called after m_workerThreadEnabled is reset.
+        virtual void wakeUpWorkerThread();
         void interruptWorkerThread();
         void mainThreadWork();
     };
 
-    template<typename Adapter>
-    ProducerConsumerBase<Adapter>::ProducerConsumerBase(const Type type, Adapter& sharedContainer)
+    template<typename Adapter, typename WaitPolicy>
+    ProducerConsumerBase<Adapter, WaitPolicy>::ProducerConsumerBase(const Type type, Adapter& sharedContainer, const std::size_t workersCount)
         : m_commandQueue(createThreadSafeSTLAdapterFrom(std::queue<Command>{}))
         , m_sharedContainer(sharedContainer)
         , m_workerThreadEnabled(false)
         , m_name(Names[static_cast<unsigned char>(type)])
+        , m_completionFuture(m_completionPromise.get_future().share())
+        , m_completed(false)
+        , m_workersCount(std::max<std::size_t>(workersCount, 1))
+        , m_runningWorkersCount(0)
     { }
 
-    template<typename Adapter>
-    void ProducerConsumerBase<Adapter>::enableWorkerThread()
+    template<typename Adapter, typename WaitPolicy>
+    void ProducerConsumerBase<Adapter, WaitPolicy>::enableWorkerThread()
     {
         m_commandQueue.pushAndNotify(Command::EnableWorkerThread);
     }
 
-    template<typename Adapter>
-    void ProducerConsumerBase<Adapter>::disableWorkerThread()
+    template<typename Adapter, typename WaitPolicy>
+    void ProducerConsumerBase<Adapter, WaitPolicy>::disableWorkerThread()
     {
         m_commandQueue.pushAndNotify(Command::DisableWorkerThread);
     }
 
-    template<typename Adapter>
-    void ProducerConsumerBase<Adapter>::runMainThread()
+    template<typename Adapter, typename WaitPolicy>
+    void ProducerConsumerBase<Adapter, WaitPolicy>::runMainThread()
     {
         try
         {
@@ -105,8 +142,8 @@ namespace mt
         }
     }
 
-    template<typename Adapter>
-    void ProducerConsumerBase<Adapter>::shutdownMainThread()
+    template<typename Adapter, typename WaitPolicy>
+    void ProducerConsumerBase<Adapter, WaitPolicy>::shutdownMainThread()
     {
         try
         {
@@ -126,19 +163,62 @@ namespace mt
         }
     }
 
-    template<typename Adapter>
-    void ProducerConsumerBase<Adapter>::interruptWorkerThread()
+    template<typename Adapter, typename WaitPolicy>
+    void ProducerConsumerBase<Adapter, WaitPolicy>::interruptWorkerThread()
     {
         std::lock_guard<std::mutex> lock(m_workerThreadMutex);
         m_workerThreadEnabled = false;
-        if (m_workerThread->joinable())
+        wakeUpWorkerThread();
+        for (std::jthread& workerThread : m_workerThreads)
         {
-            m_workerThread->join();
+            if (workerThread.joinable())
+            {
+                workerThread.join();
+            }
         }
+        m_workerThreads.clear();
     }
 
-    template<typename Adapter>
-    void ProducerConsumerBase<Adapter>::mainThreadWork()
+    template<typename Adapter, typename WaitPolicy>
+    template<typename Queue, typename TryFn>
+    bool ProducerConsumerBase<Adapter, WaitPolicy>::waitForWork(Queue& queue, TryFn&& tryFn)
+    {
+        return m_waitPolicy.wait(std::forward<TryFn>(tryFn), [&](const auto timeout)
+            {
+                queue.waitFor(timeout, [&] { return !m_workerThreadEnabled; });
+            });
+    }
+
+    template<typename Adapter, typename WaitPolicy>
+    void ProducerConsumerBase<Adapter, WaitPolicy>::complete(const std::exception_ptr error)
+    {
+        // Worker threads still running may be processing their last elements.
+        if (!error && m_runningWorkersCount.fetch_sub(1) != 1)
+        {
+            return;
+        }
+        if (m_completed.exchange(true))
+        {
+            return;
+        }
+        if (error)
+        {
+            m_completionPromise.set_exception(error);
+        }
+        else
+        {
+            m_completionPromise.set_value();
+        }
+    }
+
+    template<typename Adapter, typename WaitPolicy>
+    void ProducerConsumerBase<Adapter, WaitPolicy>::wakeUpWorkerThread()
+    {
+        m_sharedContainer.notifyAll();
+    }
+
+    template<typename Adapter, typename WaitPolicy>
+    void ProducerConsumerBase<Adapter, WaitPolicy>::mainThreadWork()
     {
         try
         {
@@ -153,21 +233,28 @@ namespace mt
                     {
                         std::lock_guard<std::mutex> lock(m_workerThreadMutex);
                         m_workerThreadEnabled = true;
-                        m_workerThread = std::make_unique<std::jthread>([&]
-                            {
-                                try
-                                {
-                                    workerThreadWork();
-                                }
-                                catch (const std::exception& ex)
-                                {
-                                    std::cerr << m_name << " -> " << ex.what() << std::endl;
-                                }
-                                catch (...)
+                        // Interrupted worker threads have been joined, only the new ones can complete.
+                        m_runningWorkersCount = m_workersCount;
+                        for (std::size_t i = 0; i < m_workersCount; ++i)
+                        {
+                            m_workerThreads.emplace_back([&]
                                 {
-                                    std::cerr << m_name << " -> Unknown exception" << std::endl;
-                                }
-                            });
+                                    try
+                                    {
+                                        workerThreadWork();
+                                    }
+                                    catch (const std::exception& ex)
+                                    {
+                                        std::cerr << m_name << " -> " << ex.what() << std::endl;
+                                        complete(std::current_exception());
+                                    }
+                                    catch (...)
+                                    {
+                                        std::cerr << m_name << " -> Unknown exception" << std::endl;
+                                        complete(std::current_exception());
+                                    }
+                                });
+                        }
                     }
                 }
                 else if (currentCommand == Command::DisableWorkerThread)
@@ -0,0 +1,150 @@
+/**
+ * @file ResultCache.cpp
+ *
+ * @brief ResultCache class template for reusing results of repeated equations across batches.
+ *
+ * @author Hovsep Papoyan
+ * Contact: papoyanhovsep93@gmail.com
+ * @Date 2024-03-28
+ *
+ */
+
+#include "ResultCache.h"
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+namespace slv
+{
+    template<typename T>
+    std::uint64_t ResultCache<T>::KeyHash::mix(const Key& key) noexcept
+    {
+        // Multiply-xorshift mixing. Bits 40 and above select the shard, the low bits are left to the hash table.
+        std::uint64_t hash = static_cast<std::uint64_t>(key.m_a) * 0x9E3779B97F4A7C15ull;
+        hash = (hash ^ (hash >> 29) ^ static_cast<std::uint64_t>(key.m_b)) * 0xBF58476D1CE4E5B9ull;
+        hash = (hash ^ (hash >> 32) ^ static_cast<std::uint64_t>(key.m_c)) * 0x94D049BB133111EBull;
+        return hash ^ (hash >> 31);
+    }
+
+    template<typename T>
+    std::size_t ResultCache<T>::KeyHash::operator()(const Key& key) const noexcept
+    {
+        return static_cast<std::size_t>(mix(key));
+    }
+
+    template<typename T>
+    ResultCache<T>::ResultCache(const std::size_t capacity, const std::size_t shardsCount)
+    {
+        const std::size_t count = std::bit_ceil(std::max<std::size_t>(shardsCount, 1));
+        m_shardCapacity = std::max<std::size_t>((capacity + count - 1) / count, 1);
+        m_shards.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            m_shards.push_back(std::make_unique<Shard>());
+            m_shards.back()->m_index.reserve(m_shardCapacity);
+            m_shards.back()->m_entries.reserve(m_shardCapacity);
+        }
+    }
+
+    template<typename T>
+    bool ResultCache<T>::lookup(const int a, const int b, const int c, const ResultColumns& results, const std::size_t i)
+    {
+        if (!isCacheable(a, c))
+        {
+            return false;
+        }
+        const Key key{ a, b, c };
+        Shard& shard = getShard(key);
+        Entry entry;
+        {
+            std::lock_guard<std::mutex> lock(shard.m_mutex);
+            const auto it = shard.m_index.find(key);
+            if (it == shard.m_index.end())
+            {
+                ++shard.m_misses;
+                return false;
+            }
+            ++shard.m_hits;
+            Entry& cached = shard.m_entries[it->second];
+            cached.m_referenced = true;
+            entry = cached;
+        }
+        results.m_kinds[i] = entry.m_kind;
+        results.m_firstRoots[i] = entry.m_firstRoot;
+        results.m_secondRoots[i] = entry.m_secondRoot;
+        results.m_extremums[i] = entry.m_extremum;
+        results.m_criticalPoints[i] = entry.m_criticalPoint;
+        return true;
+    }
+
+    template<typename T>
+    void ResultCache<T>::insert(const int a, const int b, const int c, const ResultColumns& results, const std::size_t i)
+    {
+        if (!isCacheable(a, c))
+        {
+            return;
+        }
+        const Key key{ a, b, c };
+        Entry entry{
+            key,
+            results.m_firstRoots[i],
+            results.m_secondRoots[i],
+            results.m_extremums[i],
+            results.m_criticalPoints[i],
+            results.m_kinds[i],
+            false
+        };
+
+        Shard& shard = getShard(key);
+        std::lock_guard<std::mutex> lock(shard.m_mutex);
+        if (shard.m_index.contains(key))
+        {
+            // Another block has solved the same equation meanwhile.
+            return;
+        }
+        if (shard.m_entries.size() < m_shardCapacity)
+        {
+            shard.m_index.emplace(key, shard.m_entries.size());
+            shard.m_entries.push_back(entry);
+            return;
+        }
+        // Second chance: recently hit entries are skipped once, the first one not hit since the last pass is replaced.
+        while (shard.m_entries[shard.m_hand].m_referenced)
+        {
+            shard.m_entries[shard.m_hand].m_referenced = false;
+            shard.m_hand = (shard.m_hand + 1) % shard.m_entries.size();
+        }
+        Entry& victim = shard.m_entries[shard.m_hand];
+        shard.m_index.erase(victim.m_key);
+        shard.m_index.emplace(key, shard.m_hand);
+        victim = entry;
+        shard.m_hand = (shard.m_hand + 1) % shard.m_entries.size();
+        ++shard.m_evictions;
+    }
+
+    template<typename T>
+    typename ResultCache<T>::Statistics ResultCache<T>::getStatistics() const
+    {
+        Statistics statistics;
+        for (const std::unique_ptr<Shard>& shard : m_shards)
+        {
+            std::lock_guard<std::mutex> lock(shard->m_mutex);
+            statistics.m_hits += shard->m_hits;
+            statistics.m_misses += shard->m_misses;
+            statistics.m_evictions += shard->m_evictions;
+            statistics.m_size += shard->m_entries.size();
+        }
+        return statistics;
+    }
+
+    template<typename T>
+    typename ResultCache<T>::Shard& ResultCache<T>::getShard(const Key& key) const noexcept
+    {
+        return *m_shards[static_cast<std::size_t>(KeyHash::mix(key) >> 40) & (m_shards.size() - 1)];
+    }
+
+    template class ResultCache<float>;
+    template class ResultCache<double>;
+    template class ResultCache<long double>;
+} // namespace slv
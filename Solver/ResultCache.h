@@ -0,0 +1,114 @@
+/**
+ * @file ResultCache.h
+ *
+ * @brief ResultCache class template for reusing results of repeated equations across batches.
+ *
+ * @author Hovsep Papoyan
+ * Contact: papoyanhovsep93@gmail.com
+ * @Date 2024-03-28
+ *
+ */
+
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include "Solver.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace slv
+{
+    // Bounded concurrent cache of quadratic equation results.
+    // Equations are keyed by their exact (a, b, c). Multiples aren't merged into one entry: results rescaled from another
+    // Equation may differ from solving it in the last bits, and a hit must give the same output as solveBatch.
+    // Linear equations and equations with c == 0 are not cached, their solution is cheaper than a lookup.
+    // Entries are spread over independently locked shards, each shard evicts with the CLOCK (second chance) policy.
+    template<typename T>
+    class ResultCache
+    {
+    public:
+        using ResultColumns = typename BasicSolver<T>::ResultColumns;
+
+        struct Statistics
+        {
+            std::uint64_t m_hits = 0;
+            std::uint64_t m_misses = 0;
+            std::uint64_t m_evictions = 0;
+            std::size_t m_size = 0;
+        };
+
+        static constexpr std::size_t defaultShardsCount = 64;
+
+    private:
+        struct Key
+        {
+            int m_a;
+            int m_b;
+            int m_c;
+
+            friend bool operator==(const Key&, const Key&) = default;
+        };
+
+        struct KeyHash
+        {
+            [[nodiscard]] static std::uint64_t mix(const Key& key) noexcept;
+            [[nodiscard]] std::size_t operator()(const Key& key) const noexcept;
+        };
+
+        struct Entry
+        {
+            Key m_key;
+            T m_firstRoot;
+            T m_secondRoot;
+            T m_extremum;
+            T m_criticalPoint;
+            ResultKind m_kind;
+            bool m_referenced; // Set on every hit, cleared when the clock hand passes.
+        };
+
+        struct Shard
+        {
+            std::mutex m_mutex;
+            std::unordered_map<Key, std::size_t, KeyHash> m_index; // Key -> position in m_entries.
+            std::vector<Entry> m_entries;
+            std::size_t m_hand = 0;
+            std::uint64_t m_hits = 0;
+            std::uint64_t m_misses = 0;
+            std::uint64_t m_evictions = 0;
+        };
+
+        std::size_t m_shardCapacity;
+        std::vector<std::unique_ptr<Shard>> m_shards;
+
+    public:
+        // capacity is the total count of cached equations. shardsCount is rounded up to a power of two, at most 2^24.
+        explicit ResultCache(const std::size_t capacity, const std::size_t shardsCount = defaultShardsCount);
+        ResultCache(const ResultCache&) = delete;
+        ResultCache(ResultCache&&) = delete;
+        ResultCache& operator=(const ResultCache&) = delete;
+        ResultCache& operator=(ResultCache&&) = delete;
+        ~ResultCache() = default;
+
+        // Writes row i of results if the equation is cached. Returns false on a miss or if it is not cacheable.
+        [[nodiscard]] bool lookup(const int a, const int b, const int c, const ResultColumns& results, const std::size_t i);
+        // Remembers row i of results, which must be the solution of (a, b, c).
+        void insert(const int a, const int b, const int c, const ResultColumns& results, const std::size_t i);
+
+        [[nodiscard]] Statistics getStatistics() const;
+
+    private:
+        [[nodiscard]] static bool isCacheable(const int a, const int c) noexcept { return a != 0 && c != 0; }
+        [[nodiscard]] Shard& getShard(const Key& key) const noexcept;
+    };
+
+    extern template class ResultCache<float>;
+    extern template class ResultCache<double>;
+    extern template class ResultCache<long double>;
+} // namespace slv
+
+#endif
@@ -0,0 +1,241 @@
+/**
+ * @file ResultFormatter.cpp
+ *
+ * @brief ResultFormatter class for fast text formatting and output of solver results.
+ *
+ * @author Hovsep Papoyan
+ * Contact: papoyanhovsep93@gmail.com
+ * @Date 2024-03-28
+ *
+ */
+
+#include "ResultFormatter.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <concepts>
+#include <cstring>
+#include <string_view>
+#include <system_error>
+
+#ifndef _WIN32
+#include <climits>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace slv
+{
+    namespace
+    {
+        // Writes into memory reserved in advance, no bounds checks per character.
+        class RowWriter
+        {
+        private:
+            char* m_pos;
+
+        public:
+            explicit RowWriter(char* const pos) noexcept
+                : m_pos(pos)
+            { }
+
+            [[nodiscard]] char* getPos() const noexcept { return m_pos; }
+
+            RowWriter& operator<<(const std::string_view text) noexcept
+            {
+                std::memcpy(m_pos, text.data(), text.size());
+                m_pos += text.size();
+                return *this;
+            }
+
+            RowWriter& operator<<(const char ch) noexcept
+            {
+                *m_pos++ = ch;
+                return *this;
+            }
+
+            RowWriter& operator<<(const int value) noexcept
+            {
+                m_pos = std::to_chars(m_pos, m_pos + 11, value).ptr;
+                return *this;
+            }
+
+            // Same as iostream insertion with std::ios::fixed and the default precision 6.
+            template<std::floating_point T>
+            RowWriter& operator<<(const T value) noexcept
+            {
+                m_pos = std::to_chars(m_pos, m_pos + 64, value, std::chars_format::fixed, 6).ptr;
+                return *this;
+            }
+        };
+
+        template<typename T>
+        void formatResults(const CoefficientsView& coeffs, const typename BasicSolver<T>::ResultColumns& results, std::string& buffer)
+        {
+            const std::size_t initialSize = buffer.size();
+            buffer.resize(initialSize + coeffs.size() * ResultFormatter::maxRowSize);
+            RowWriter out(buffer.data() + initialSize);
+            for (std::size_t i = 0; i < coeffs.size(); ++i)
+            {
+                out << "INPUT: (" << coeffs.a(i) << ", " << coeffs.b(i) << ", " << coeffs.c(i) << ")\nOUTPUT: ";
+                const ResultKind kind = results.m_kinds[i];
+                switch (kind)
+                {
+                case ResultKind::Linear:
+                    out << '(' << results.m_firstRoots[i] << "). GLOBAL MIN(MAX) = " << results.m_firstRoots[i];
+                    break;
+                case ResultKind::Identity:
+                    out << "AN IDENTITY";
+                    break;
+                case ResultKind::Incorrect:
+                    out << "NOT CORRECT";
+                    break;
+                default:
+                    if (kind == ResultKind::TwoRoots)
+                    {
+                        out << '(' << results.m_firstRoots[i] << ", " << results.m_secondRoots[i] << ')';
+                    }
+                    else
+                    {
+                        out << "NO REAL ROOTS";
+                    }
+                    out << ". GLOBAL " << (coeffs.a(i) > 0 ? "MIN" : "MAX")
+                        << " = " << results.m_extremums[i] << " AT x = " << results.m_criticalPoints[i];
+                    break;
+                }
+                out << "\n\n";
+            }
+            buffer.resize(static_cast<std::size_t>(out.getPos() - buffer.data()));
+        }
+
+        template<typename T>
+        void formatPolynomialResults(const PolynomialsView& polynomials, const typename BasicPolynomialSolver<T>::ResultColumns& results, std::string& buffer)
+        {
+            const std::size_t initialSize = buffer.size();
+            buffer.resize(initialSize + polynomials.size() * ResultFormatter::maxPolynomialRowSize);
+            RowWriter out(buffer.data() + initialSize);
+            const std::size_t degree = polynomials.getDegree();
+            for (std::size_t i = 0; i < polynomials.size(); ++i)
+            {
+                out << "INPUT: (" << polynomials.coefficient(i, 0);
+                for (std::size_t k = 1; k <= degree; ++k)
+                {
+                    out << ", " << polynomials.coefficient(i, k);
+                }
+                out << ")\nOUTPUT: ";
+                const PolynomialKind kind = results.m_kinds[i];
+                switch (kind)
+                {
+                case PolynomialKind::NoRealRoots:
+                    out << "NO REAL ROOTS";
+                    break;
+                case PolynomialKind::Identity:
+                    out << "AN IDENTITY";
+                    break;
+                case PolynomialKind::Incorrect:
+                    out << "NOT CORRECT";
+                    break;
+                default:
+                    out << '(' << results.m_roots[0][i];
+                    for (std::size_t j = 1; j < getRootsCount(kind); ++j)
+                    {
+                        out << ", " << results.m_roots[j][i];
+                    }
+                    out << ')';
+                    break;
+                }
+                out << "\n\n";
+            }
+            buffer.resize(static_cast<std::size_t>(out.getPos() - buffer.data()));
+        }
+    } // namespace
+
+    void ResultFormatter::formatBlock(const CoefficientsView& coeffs, const BasicSolver<float>::ResultColumns& results, std::string& buffer)
+    {
+        formatResults<float>(coeffs, results, buffer);
+    }
+
+    void ResultFormatter::formatBlock(const CoefficientsView& coeffs, const BasicSolver<double>::ResultColumns& results, std::string& buffer)
+    {
+        formatResults<double>(coeffs, results, buffer);
+    }
+
+    void ResultFormatter::formatBlock(const CoefficientsView& coeffs, const BasicSolver<long double>::ResultColumns& results, std::string& buffer)
+    {
+        formatResults<long double>(coeffs, results, buffer);
+    }
+
+    void ResultFormatter::formatBlock(const PolynomialsView& polynomials, const BasicPolynomialSolver<float>::ResultColumns& results, std::string& buffer)
+    {
+        formatPolynomialResults<float>(polynomials, results, buffer);
+    }
+
+    void ResultFormatter::formatBlock(const PolynomialsView& polynomials, const BasicPolynomialSolver<double>::ResultColumns& results, std::string& buffer)
+    {
+        formatPolynomialResults<double>(polynomials, results, buffer);
+    }
+
+    void ResultFormatter::formatBlock(const PolynomialsView& polynomials, const BasicPolynomialSolver<long double>::ResultColumns& results, std::string& buffer)
+    {
+        formatPolynomialResults<long double>(polynomials, results, buffer);
+    }
+
+    void ResultFormatter::write(std::FILE* const file, const std::vector<std::string>& buffers)
+    {
+        // Data already buffered by stdio must go first.
+        std::fflush(file);
+#ifdef _WIN32
+        for (const std::string& buffer : buffers)
+        {
+            std::fwrite(buffer.data(), 1, buffer.size(), file);
+        }
+        std::fflush(file);
+#else
+        const int fd = fileno(file);
+        std::vector<iovec> iovs;
+        iovs.reserve(buffers.size());
+        for (const std::string& buffer : buffers)
+        {
+            if (!buffer.empty())
+            {
+                iovs.push_back(iovec{ const_cast<char*>(buffer.data()), buffer.size() });
+            }
+        }
+        std::size_t first = 0;
+        while (first != iovs.size())
+        {
+            const int count = static_cast<int>(std::min<std::size_t>(iovs.size() - first, IOV_MAX));
+            const ssize_t written = writev(fd, iovs.data() + first, count);
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                throw std::system_error(errno, std::generic_category(), "Can't write results");
+            }
+            // Partial write: skip fully written buffers and advance inside the first unfinished one.
+            std::size_t remaining = static_cast<std::size_t>(written);
+            while (first != iovs.size() && remaining >= iovs[first].iov_len)
+            {
+                remaining -= iovs[first].iov_len;
+                ++first;
+            }
+            if (first != iovs.size())
+            {
+                iovs[first].iov_base = static_cast<char*>(iovs[first].iov_base) + remaining;
+                iovs[first].iov_len -= remaining;
+            }
+        }
+#endif
+    }
+
+    void ResultFormatter::write(std::ostream& os, const std::vector<std::string>& buffers)
+    {
+        for (const std::string& buffer : buffers)
+        {
+            os.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        }
+    }
+} // namespace slv
@@ -0,0 +1,52 @@
+/**
+ * @file ResultFormatter.h
+ *
+ * @brief ResultFormatter class for fast text formatting and output of solver results.
+ *
+ * @author Hovsep Papoyan
+ * Contact: papoyanhovsep93@gmail.com
+ * @Date 2024-03-28
+ *
+ */
+
+#ifndef RESULT_FORMATTER_H
+#define RESULT_FORMATTER_H
+
+#include "CoefficientsView.h"
+#include "PolynomialSolver.h"
+#include "Solver.h"
+
+#include <cstdio>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace slv
+{
+    // Produces exactly the same text as iostream insertion with std::ios::fixed would,
+    // But formats with std::to_chars into a preallocated buffer, so blocks can be formatted independently and in parallel.
+    class ResultFormatter
+    {
+    public:
+        // Upper bound of one formatted equation. Values derived from int coefficients have at most 20 integer digits,
+        // So one row is below 200 characters.
+        static constexpr std::size_t maxRowSize = 256;
+        // Upper bound of one formatted polynomial: up to maxDegree + 1 ints and maxDegree roots of at most 64 characters each.
+        static constexpr std::size_t maxPolynomialRowSize = 512;
+
+        // Appends text of coeffs.size() results to buffer. Row i of results belongs to the equation coeffs[i].
+        static void formatBlock(const CoefficientsView& coeffs, const BasicSolver<float>::ResultColumns& results, std::string& buffer);
+        static void formatBlock(const CoefficientsView& coeffs, const BasicSolver<double>::ResultColumns& results, std::string& buffer);
+        static void formatBlock(const CoefficientsView& coeffs, const BasicSolver<long double>::ResultColumns& results, std::string& buffer);
+        // Same for polynomials: "INPUT: (a, b, ...)" and the ascending real roots, "NO REAL ROOTS", "AN IDENTITY" or "NOT CORRECT".
+        static void formatBlock(const PolynomialsView& polynomials, const BasicPolynomialSolver<float>::ResultColumns& results, std::string& buffer);
+        static void formatBlock(const PolynomialsView& polynomials, const BasicPolynomialSolver<double>::ResultColumns& results, std::string& buffer);
+        static void formatBlock(const PolynomialsView& polynomials, const BasicPolynomialSolver<long double>::ResultColumns& results, std::string& buffer);
+
+        // Writes buffers in order. For file streams with one writev call per up to IOV_MAX buffers, where available.
+        static void write(std::FILE* const file, const std::vector<std::string>& buffers);
+        static void write(std::ostream& os, const std::vector<std::string>& buffers);
+    };
+} // namespace slv
+
+#endif
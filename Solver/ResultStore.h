@@ -0,0 +1,121 @@
+/**
+ * @file ResultStore.h
+ *
+ * @brief ResultStore class template for keeping results of a batch in packed columns.
+ *
+ * @author Hovsep Papoyan
+ * Contact: papoyanhovsep93@gmail.com
+ * @Date 2024-03-28
+ *
+ */
+
+#ifndef RESULT_STORE_H
+#define RESULT_STORE_H
+
+#include "Solver.h"
+#include "Topology.h"
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace slv
+{
+    // One contiguous array per field plus one byte of ResultKind per equation (4 * sizeof(T) + 1 bytes),
+    // Instead of a std::variant with an optional pair per equation. Row i of every column belongs to equation i.
+    // Block workers write disjoint slices (getColumns(first)) directly with Solver::solveBatch.
+    // All columns share one allocation: heap memory by default, an mt::PageBuffer when resize is asked to place pages,
+    // So that pages end up on the NUMA nodes of the workers writing them.
+    template<typename T>
+    class ResultStore
+    {
+    public:
+        using Solver = BasicSolver<T>;
+        using ResultColumns = typename Solver::ResultColumns;
+
+        // Smaller stores span only a few pages, placing them isn't worth a system call.
+        static constexpr std::size_t minPlacedBytes = std::size_t(256) << 10;
+
+    private:
+        static constexpr std::size_t rowBytes = 4 * sizeof(T) + sizeof(ResultKind);
+
+        std::unique_ptr<T[]> m_heap;
+        mt::PageBuffer m_pages;
+        T* m_columns = nullptr; // Columns firstRoots, secondRoots, extremums, criticalPoints of m_capacity rows, then kinds.
+        std::size_t m_size = 0;
+        std::size_t m_capacity = 0;
+
+    public:
+        ResultStore() = default;
+        ResultStore(const ResultStore&) = delete;
+        ResultStore(ResultStore&& rhs) noexcept
+            : m_heap(std::move(rhs.m_heap))
+            , m_pages(std::move(rhs.m_pages))
+            , m_columns(std::exchange(rhs.m_columns, nullptr))
+            , m_size(std::exchange(rhs.m_size, 0))
+            , m_capacity(std::exchange(rhs.m_capacity, 0))
+        { }
+        ResultStore& operator=(const ResultStore&) = delete;
+        ResultStore& operator=(ResultStore&& rhs) noexcept
+        {
+            m_heap = std::move(rhs.m_heap);
+            m_pages = std::move(rhs.m_pages);
+            m_columns = std::exchange(rhs.m_columns, nullptr);
+            m_size = std::exchange(rhs.m_size, 0);
+            m_capacity = std::exchange(rhs.m_capacity, 0);
+            return *this;
+        }
+        ~ResultStore() = default;
+
+        // Makes room for count rows. Contents are left uninitialized, memory is reused if it is big enough,
+        // Unless placePages is set and the store takes at least minPlacedBytes: then fresh untouched pages are taken
+        // From the OS, so the threads writing rows decide their NUMA nodes.
+        void resize(const std::size_t count, const bool placePages = false)
+        {
+            const std::size_t bytes = count * rowBytes;
+            const bool place = placePages && bytes >= minPlacedBytes;
+            if (count > m_capacity || place)
+            {
+                // The old memory is released first, so that both never exist at once.
+                *this = ResultStore{};
+                if (place)
+                {
+                    m_pages = mt::PageBuffer(bytes);
+                    m_columns = static_cast<T*>(m_pages.data());
+                }
+                else
+                {
+                    m_heap = std::make_unique_for_overwrite<T[]>((bytes + sizeof(T) - 1) / sizeof(T));
+                    m_columns = m_heap.get();
+                }
+                m_capacity = count;
+            }
+            m_size = count;
+        }
+
+        // Frees the memory.
+        void clear() noexcept
+        {
+            *this = ResultStore{};
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept { return m_size; }
+
+        // Columns starting at row first.
+        [[nodiscard]] ResultColumns getColumns(const std::size_t first = 0) const noexcept
+        {
+            return ResultColumns{ m_columns + first, m_columns + m_capacity + first, m_columns + 2 * m_capacity + first,
+                m_columns + 3 * m_capacity + first, reinterpret_cast<ResultKind*>(m_columns + 4 * m_capacity) + first };
+        }
+
+        [[nodiscard]] ResultKind getKind(const std::size_t i) const noexcept { return getColumns().m_kinds[i]; }
+
+        // Row i in the Result representation.
+        [[nodiscard]] typename Solver::Result operator[](const std::size_t i) const
+        {
+            return Solver::toResult(getColumns(), i);
+        }
+    };
+} // namespace slv
+
+#endif
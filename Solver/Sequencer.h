@@ -0,0 +1,101 @@
+/**
+ * @file Sequencer.h
+ *
+ * @brief Sequencer class for handing values produced by several threads over to one sink, in input or completion order.
+ *
+ * @author Hovsep Papoyan
+ * Contact: papoyanhovsep93@gmail.com
+ * @Date 2024-03-28
+ *
+ */
+
+#ifndef SEQUENCER_H
+#define SEQUENCER_H
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+
+namespace mt
+{
+    enum class Ordering : unsigned char
+    {
+        Input, // The sink gets values in the order of their sequence numbers.
+        Completion // The sink gets values as soon as they are ready.
+    };
+
+    // Values are delivered concurrently, the sink is never called concurrently.
+    // The thread delivering the next value in order passes it and every following value which is already there to the sink,
+    // The other threads only store their values and return at once. They never wait while the sink runs.
+    // In Ordering::Input mode sequence numbers must be 0, 1, 2, ... without gaps, values wait until their turn comes.
+    // In Ordering::Completion mode sequence numbers are ignored, values are numbered when they are delivered.
+    template<typename Value>
+    class Sequencer
+    {
+    private:
+        const Ordering m_ordering;
+        std::mutex m_mutex;
+        std::map<std::size_t, Value> m_values; // Delivered values waiting for the sink, keyed by sequence number.
+        std::size_t m_deliveredCount;
+        std::size_t m_passedCount; // Values passed to the sink.
+        bool m_passing; // A thread is passing values to the sink.
+
+    public:
+        explicit Sequencer(const Ordering ordering) noexcept;
+        Sequencer(const Sequencer&) = delete;
+        Sequencer& operator=(const Sequencer&) = delete;
+
+        [[nodiscard]] Ordering getOrdering() const noexcept { return m_ordering; }
+
+        // If sink throws, the exception propagates to this caller, the value is lost and later deliveries continue.
+        template<typename Sink>
+        void deliver(const std::size_t sequence, Value value, Sink& sink);
+    };
+
+    template<typename Value>
+    Sequencer<Value>::Sequencer(const Ordering ordering) noexcept
+        : m_ordering(ordering)
+        , m_deliveredCount(0)
+        , m_passedCount(0)
+        , m_passing(false)
+    { }
+
+    template<typename Value>
+    template<typename Sink>
+    void Sequencer<Value>::deliver(const std::size_t sequence, Value value, Sink& sink)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_values.emplace(m_ordering == Ordering::Input ? sequence : m_deliveredCount, std::move(value));
+        ++m_deliveredCount;
+        if (m_passing)
+        {
+            // The passing thread will pass this value too, once its turn comes.
+            return;
+        }
+        m_passing = true;
+        try
+        {
+            for (auto it = m_values.begin(); it != m_values.end() && it->first == m_passedCount; it = m_values.begin())
+            {
+                Value next = std::move(it->second);
+                m_values.erase(it);
+                ++m_passedCount;
+                lock.unlock();
+                sink(std::move(next));
+                lock.lock();
+            }
+        }
+        catch (...)
+        {
+            if (!lock.owns_lock())
+            {
+                lock.lock();
+            }
+            m_passing = false;
+            throw;
+        }
+        m_passing = false;
+    }
+} // namespace mt
+
+#endif
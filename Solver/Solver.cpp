@@ -1,7 +1,7 @@
 /**
  * @file Solver.cpp
  *
- * @brief Solver class for solving quadratic and linear equations.
+ * @brief BasicSolver class template for solving quadratic and linear equations with float, double or long double precision.
  *
  * @author Hovsep Papoyan
  * Contact: papoyanhovsep93@gmail.com
@@ -11,32 +11,527 @@
 
 #include "Solver.h"
 
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define SOLVER_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+// Kernels for instruction sets beyond the build's baseline are compiled with a target attribute on GCC and Clang,
+// MSVC compiles intrinsics of any instruction set without it. Which kernel runs is decided at run time.
+#if defined(__GNUC__) || defined(__clang__)
+#define SOLVER_TARGET(isa) __attribute__((target(isa)))
+#else
+#define SOLVER_TARGET(isa)
+#endif
+
 namespace slv
 {
-    Solver::Result Solver::solve(const long double aCoefficient, const long double bCoefficient, const long double cCoefficient)
+    namespace
     {
-        if (aCoefficient != 0.0)
+        // Roots of ax^2 + bx + c = 0 (a != 0, D >= 0) in the order (-b - sqrt(D)) / 2a, (-b + sqrt(D)) / 2a.
+        // Subtracting sqrt(D) from b of the same magnitude would cancel most digits, so only the root where
+        // b and sqrt(D) are added is computed directly, the other one comes from Vieta's formula x1 * x2 = c / a.
+        // With c == 0 the other root is zero, it gets the sign of 0 / 2a as the textbook formula would give.
+        template<typename T>
+        [[nodiscard]] std::pair<T, T> getStableRoots(const T a, const T b, const T c, const T sqrtDiscriminant)
+        {
+            const T q = -(b + std::copysign(sqrtDiscriminant, b)) / 2;
+            const T largeRoot = q / a;
+            const T smallRoot = c == 0 ? std::copysign(T(0), a) : c / q;
+            return b < 0 ? std::make_pair(smallRoot, largeRoot) : std::make_pair(largeRoot, smallRoot);
+        }
+
+        // D = b^2 - 4ac of int coefficients, exactly, as 4 * m_quarter + m_remainder. D needs up to 66 bits,
+        // But floor(b^2 / 4) - ac fits in 64 and b^2 mod 4 is 0 or 1. So D < 0 iff m_quarter < 0,
+        // And D == 0 iff both are 0. No floating point is involved.
+        struct IntegerDiscriminant
+        {
+            std::int64_t m_quarter;
+            std::uint64_t m_remainder;
+        };
+
+        [[nodiscard]] constexpr IntegerDiscriminant getIntegerDiscriminant(const int a, const int b, const int c) noexcept
+        {
+            const std::uint64_t bSquared = static_cast<std::uint64_t>(static_cast<std::int64_t>(b) * b);
+            return { static_cast<std::int64_t>(bSquared >> 2) - static_cast<std::int64_t>(a) * c, bSquared & 3 };
+        }
+
+        // floor(sqrt(n)) for n < 2^63. The floating estimate is off by at most one, it is corrected in integers.
+        [[nodiscard]] std::uint64_t getIntegerSqrt(const std::uint64_t n) noexcept
+        {
+            std::uint64_t root = static_cast<std::uint64_t>(std::sqrt(static_cast<double>(n)));
+            while (root * root > n)
+            {
+                --root;
+            }
+            while ((root + 1) * (root + 1) <= n)
+            {
+                ++root;
+            }
+            return root;
+        }
+
+        // sqrt(D) if D >= 0 is a perfect square. D = 4m is the square of 2 * sqrt(m),
+        // D = 4m + 1 is the square of an odd 2u + 1 iff m = u(u + 1), and then u = floor(sqrt(m)).
+        [[nodiscard]] std::optional<std::int64_t> getExactSqrt(const IntegerDiscriminant& discriminant) noexcept
+        {
+            const std::uint64_t quarter = static_cast<std::uint64_t>(discriminant.m_quarter);
+            const std::uint64_t root = getIntegerSqrt(quarter);
+            if (discriminant.m_remainder == 0 ? root * root == quarter : root * (root + 1) == quarter)
+            {
+                return static_cast<std::int64_t>(2 * root + discriminant.m_remainder);
+            }
+            return std::nullopt;
+        }
+
+        // D >= 0 as T. Both terms are exact in double and long double, so only their sum is rounded (float is rounded from double).
+        template<typename T>
+        [[nodiscard]] T toFloating(const IntegerDiscriminant& discriminant) noexcept
+        {
+            using Wide = std::common_type_t<T, double>;
+            const std::uint64_t quarter = static_cast<std::uint64_t>(discriminant.m_quarter);
+            return static_cast<T>(static_cast<Wide>(quarter >> 32) * Wide(17179869184.0) // 2^34.
+                + static_cast<Wide>((quarter & 0xFFFFFFFF) << 2 | discriminant.m_remainder));
+        }
+
+        // getStableRoots for a perfect square D: q = -(b + sign(b) * sqrt(D)) / 2 is an exact integer (b and sqrt(D) have the same parity),
+        // So the roots are single roundings of q / a and c / q. q == 0 becomes -0, as getStableRoots gives it.
+        template<typename T>
+        [[nodiscard]] std::pair<T, T> getExactRoots(const int a, const int b, const int c, const std::int64_t sqrtDiscriminant)
+        {
+            const std::int64_t q = -(b + (b < 0 ? -sqrtDiscriminant : sqrtDiscriminant)) / 2;
+            const T floatingQ = q == 0 ? -T(0) : static_cast<T>(q);
+            const T largeRoot = floatingQ / static_cast<T>(a);
+            const T smallRoot = c == 0 ? std::copysign(T(0), static_cast<T>(a)) : static_cast<T>(c) / floatingQ;
+            return b < 0 ? std::make_pair(smallRoot, largeRoot) : std::make_pair(largeRoot, smallRoot);
+        }
+
+        // Builds the kind of one row from its zero/sign flags. Same decision tree as in solve().
+        [[nodiscard]] constexpr ResultKind classify(const bool aIsZero, const bool bIsZero, const bool cIsZero, const bool discriminantIsNegative) noexcept
+        {
+            if (!aIsZero)
+            {
+                return discriminantIsNegative ? ResultKind::NoRealRoots : ResultKind::TwoRoots;
+            }
+            if (!bIsZero)
+            {
+                return ResultKind::Linear;
+            }
+            return cIsZero ? ResultKind::Identity : ResultKind::Incorrect;
+        }
+
+        // Exact integer path: the kind and perfect square roots are decided in integers, floating point is used only for the final values.
+        template<typename T>
+        void solveBatchScalar(const int* const aCoefficients, const int* const bCoefficients, const int* const cCoefficients,
+            std::size_t first, const std::size_t last, const typename BasicSolver<T>::ResultColumns& results)
+        {
+            for (; first != last; ++first)
+            {
+                const int a = aCoefficients[first];
+                const int b = bCoefficients[first];
+                const int c = cCoefficients[first];
+                const IntegerDiscriminant discriminant = getIntegerDiscriminant(a, b, c);
+                results.m_kinds[first] = classify(a == 0, b == 0, c == 0, discriminant.m_quarter < 0);
+                const T floatingA = static_cast<T>(a);
+                const T floatingB = static_cast<T>(b);
+                const T floatingC = static_cast<T>(c);
+                if (a != 0)
+                {
+                    const T criticalPoint = -floatingB / (2 * floatingA);
+                    results.m_extremums[first] = floatingA * criticalPoint * criticalPoint + floatingB * criticalPoint + floatingC;
+                    results.m_criticalPoints[first] = criticalPoint;
+                    if (discriminant.m_quarter >= 0)
+                    {
+                        const std::optional<std::int64_t> sqrtDiscriminant = getExactSqrt(discriminant);
+                        const std::pair<T, T> roots = sqrtDiscriminant ? getExactRoots<T>(a, b, c, *sqrtDiscriminant)
+                            : getStableRoots(floatingA, floatingB, floatingC, std::sqrt(toFloating<T>(discriminant)));
+                        results.m_firstRoots[first] = roots.first;
+                        results.m_secondRoots[first] = roots.second;
+                    }
+                }
+                else
+                {
+                    results.m_firstRoots[first] = b != 0 ? -floatingC / floatingB : 0;
+                }
+            }
+        }
+
+        // The vector kernels compute D exactly as getIntegerDiscriminant does, in 64-bit lanes, and round D >= 0 to double
+        // As toFloating does, so they classify and solve like solveBatchScalar for any int coefficients.
+        // They don't look for perfect squares: for D = s^2 (s < 2^33) rounding moves sqrt(D) by less than half an ulp of s,
+        // So the rounded sqrt is exactly s, q = -(b + sign(b) * s) / 2 is an exact integer and getStableRoots gives getExactRoots.
+        constexpr double twoTo34 = 17179869184.0;
+        constexpr double twoTo52 = 4503599627370496.0;
+        constexpr long long twoTo52Bits = 0x4330000000000000; // Bits of double 2^52.
+
+#if defined(SOLVER_X86)
+        // Negation flips the sign bit, as unary minus does (0 - x would turn -0 into +0). Integer xor keeps it within AVX-512F.
+        // Helpers are functions rather than lambdas, lambdas don't inherit the target of the enclosing function.
+        SOLVER_TARGET("avx512f") inline __m512d negate(const __m512d x)
+        {
+            return _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(x), _mm512_castpd_si512(_mm512_set1_pd(-0.0))));
+        }
+
+        // |magnitude| with the sign of x, magnitude must not be negative.
+        SOLVER_TARGET("avx512f") inline __m512d withSignOf(const __m512d magnitude, const __m512d x)
+        {
+            return _mm512_castsi512_pd(_mm512_or_si512(_mm512_castpd_si512(magnitude),
+                _mm512_and_si512(_mm512_castpd_si512(x), _mm512_castpd_si512(_mm512_set1_pd(-0.0)))));
+        }
+
+        // Exact doubles of 64-bit lanes below 2^52: a lane becomes the mantissa of 2^52 + x, then 2^52 is subtracted.
+        // AVX-512F, AVX2 and SSE2 have no int64 to double conversion.
+        SOLVER_TARGET("avx512f") inline __m512d toDouble(const __m512i x)
+        {
+            return _mm512_sub_pd(_mm512_castsi512_pd(_mm512_or_si512(x, _mm512_set1_epi64(twoTo52Bits))), _mm512_set1_pd(twoTo52));
+        }
+
+        // The kernels solve whole vectors of equations and return the count of solved ones, the caller solves the tail.
+        // Quadratic formulas are evaluated for every lane, linear ones are blended in where a == 0.
+        // Divisions by zero in masked out lanes are harmless, their values are never selected.
+        // The unmasked forms of cvtepi32_pd, cvtepi32_epi64, mul_epi32, shifts and sqrt_pd merge into _mm512_undefined_*(),
+        // Which GCC reports as maybe uninitialized, so the zero-masked forms are used with all lanes selected.
+        SOLVER_TARGET("avx512f") std::size_t solveBatchAvx512(const int* const aCoefficients, const int* const bCoefficients, const int* const cCoefficients,
+            const std::size_t count, const BasicSolver<double>::ResultColumns& results)
+        {
+            std::size_t i = 0;
+            constexpr __mmask8 allLanes = 0xFF;
+            const __m512d zero = _mm512_setzero_pd();
+            const __m512d minusHalf = _mm512_set1_pd(-0.5);
+            const __m512i three = _mm512_set1_epi64(3);
+            const __m512i lowHalf = _mm512_set1_epi64(0xFFFFFFFF);
+            for (; i + 8 <= count; i += 8)
+            {
+                const __m256i aInts = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(aCoefficients + i));
+                const __m256i bInts = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bCoefficients + i));
+                const __m256i cInts = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cCoefficients + i));
+                const __m512d a = _mm512_maskz_cvtepi32_pd(allLanes, aInts);
+                const __m512d b = _mm512_maskz_cvtepi32_pd(allLanes, bInts);
+                const __m512d c = _mm512_maskz_cvtepi32_pd(allLanes, cInts);
+                const __m512i bWide = _mm512_maskz_cvtepi32_epi64(allLanes, bInts);
+                const __m512i bSquared = _mm512_maskz_mul_epi32(allLanes, bWide, bWide);
+                const __m512i quarter = _mm512_sub_epi64(_mm512_maskz_srli_epi64(allLanes, bSquared, 2),
+                    _mm512_maskz_mul_epi32(allLanes, _mm512_maskz_cvtepi32_epi64(allLanes, aInts), _mm512_maskz_cvtepi32_epi64(allLanes, cInts)));
+                const __mmask8 discriminantIsNegative = _mm512_cmplt_epi64_mask(quarter, _mm512_setzero_si512());
+                const __m512d discriminant = _mm512_add_pd(_mm512_mul_pd(toDouble(_mm512_maskz_srli_epi64(allLanes, quarter, 32)), _mm512_set1_pd(twoTo34)),
+                    toDouble(_mm512_or_si512(_mm512_maskz_slli_epi64(allLanes, _mm512_and_si512(quarter, lowHalf), 2), _mm512_and_si512(bSquared, three))));
+                const __m512d sqrtDiscriminant = _mm512_maskz_sqrt_pd(static_cast<__mmask8>(~discriminantIsNegative), discriminant);
+
+                const __m512d minusB = negate(b);
+                const __m512d doubleA = _mm512_add_pd(a, a);
+                const __m512d criticalPoint = _mm512_div_pd(minusB, doubleA);
+                const __m512d extremum = _mm512_add_pd(_mm512_add_pd(
+                    _mm512_mul_pd(_mm512_mul_pd(a, criticalPoint), criticalPoint), _mm512_mul_pd(b, criticalPoint)), c);
+                const __mmask8 aIsZero = _mm512_cmp_pd_mask(a, zero, _CMP_EQ_OQ);
+                const __mmask8 bIsZero = _mm512_cmp_pd_mask(b, zero, _CMP_EQ_OQ);
+                const __mmask8 cIsZero = _mm512_cmp_pd_mask(c, zero, _CMP_EQ_OQ);
+                const __mmask8 bIsNegative = _mm512_cmp_pd_mask(b, zero, _CMP_LT_OQ);
+                const __m512d linearRoot = _mm512_maskz_div_pd(static_cast<__mmask8>(~bIsZero), negate(c), b);
+                // Same as getStableRoots.
+                const __m512d q = _mm512_mul_pd(_mm512_add_pd(b, withSignOf(sqrtDiscriminant, b)), minusHalf);
+                const __m512d largeRoot = _mm512_div_pd(q, a);
+                const __m512d smallRoot = _mm512_mask_blend_pd(cIsZero, _mm512_div_pd(c, q), withSignOf(zero, a));
+                _mm512_storeu_pd(results.m_firstRoots + i,
+                    _mm512_mask_blend_pd(aIsZero, _mm512_mask_blend_pd(bIsNegative, largeRoot, smallRoot), linearRoot));
+                _mm512_storeu_pd(results.m_secondRoots + i, _mm512_mask_blend_pd(bIsNegative, smallRoot, largeRoot));
+                _mm512_storeu_pd(results.m_extremums + i, extremum);
+                _mm512_storeu_pd(results.m_criticalPoints + i, criticalPoint);
+                for (unsigned lane = 0; lane < 8; ++lane)
+                {
+                    results.m_kinds[i + lane] = classify((aIsZero >> lane) & 1, (bIsZero >> lane) & 1,
+                        (cIsZero >> lane) & 1, (discriminantIsNegative >> lane) & 1);
+                }
+            }
+            return i;
+        }
+
+        SOLVER_TARGET("avx2") inline __m256d toDouble(const __m256i x)
+        {
+            return _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(x, _mm256_set1_epi64x(twoTo52Bits))), _mm256_set1_pd(twoTo52));
+        }
+
+        SOLVER_TARGET("avx2") std::size_t solveBatchAvx2(const int* const aCoefficients, const int* const bCoefficients, const int* const cCoefficients,
+            const std::size_t count, const BasicSolver<double>::ResultColumns& results)
+        {
+            std::size_t i = 0;
+            const __m256d zero = _mm256_setzero_pd();
+            const __m256d signBit = _mm256_set1_pd(-0.0); // Negation flips the sign bit, as unary minus does (0 - x would turn -0 into +0).
+            const __m256d minusHalf = _mm256_set1_pd(-0.5);
+            const __m256i three = _mm256_set1_epi64x(3);
+            const __m256i lowHalf = _mm256_set1_epi64x(0xFFFFFFFF);
+            for (; i + 4 <= count; i += 4)
+            {
+                const __m128i aInts = _mm_loadu_si128(reinterpret_cast<const __m128i*>(aCoefficients + i));
+                const __m128i bInts = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bCoefficients + i));
+                const __m128i cInts = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cCoefficients + i));
+                const __m256d a = _mm256_cvtepi32_pd(aInts);
+                const __m256d b = _mm256_cvtepi32_pd(bInts);
+                const __m256d c = _mm256_cvtepi32_pd(cInts);
+                const __m256i bWide = _mm256_cvtepi32_epi64(bInts);
+                const __m256i bSquared = _mm256_mul_epi32(bWide, bWide);
+                const __m256i quarter = _mm256_sub_epi64(_mm256_srli_epi64(bSquared, 2),
+                    _mm256_mul_epi32(_mm256_cvtepi32_epi64(aInts), _mm256_cvtepi32_epi64(cInts)));
+                const __m256d discriminantIsNegative = _mm256_castsi256_pd(_mm256_cmpgt_epi64(_mm256_setzero_si256(), quarter));
+                const __m256d discriminant = _mm256_add_pd(_mm256_mul_pd(toDouble(_mm256_srli_epi64(quarter, 32)), _mm256_set1_pd(twoTo34)),
+                    toDouble(_mm256_or_si256(_mm256_slli_epi64(_mm256_and_si256(quarter, lowHalf), 2), _mm256_and_si256(bSquared, three))));
+                const __m256d sqrtDiscriminant = _mm256_sqrt_pd(_mm256_andnot_pd(discriminantIsNegative, discriminant));
+
+                const __m256d minusB = _mm256_xor_pd(b, signBit);
+                const __m256d doubleA = _mm256_add_pd(a, a);
+                const __m256d criticalPoint = _mm256_div_pd(minusB, doubleA);
+                const __m256d extremum = _mm256_add_pd(_mm256_add_pd(
+                    _mm256_mul_pd(_mm256_mul_pd(a, criticalPoint), criticalPoint), _mm256_mul_pd(b, criticalPoint)), c);
+                const __m256d aIsZero = _mm256_cmp_pd(a, zero, _CMP_EQ_OQ);
+                const __m256d bIsZero = _mm256_cmp_pd(b, zero, _CMP_EQ_OQ);
+                const __m256d cIsZero = _mm256_cmp_pd(c, zero, _CMP_EQ_OQ);
+                const __m256d bIsNegative = _mm256_cmp_pd(b, zero, _CMP_LT_OQ);
+                const __m256d linearRoot = _mm256_andnot_pd(bIsZero, _mm256_div_pd(_mm256_xor_pd(c, signBit), b));
+                // Same as getStableRoots. Or-ing the sign bit of x into a non-negative value is copysign.
+                const __m256d q = _mm256_mul_pd(_mm256_add_pd(b, _mm256_or_pd(sqrtDiscriminant, _mm256_and_pd(b, signBit))), minusHalf);
+                const __m256d largeRoot = _mm256_div_pd(q, a);
+                const __m256d smallRoot = _mm256_blendv_pd(_mm256_div_pd(c, q), _mm256_and_pd(a, signBit), cIsZero);
+                _mm256_storeu_pd(results.m_firstRoots + i,
+                    _mm256_blendv_pd(_mm256_blendv_pd(largeRoot, smallRoot, bIsNegative), linearRoot, aIsZero));
+                _mm256_storeu_pd(results.m_secondRoots + i, _mm256_blendv_pd(smallRoot, largeRoot, bIsNegative));
+                _mm256_storeu_pd(results.m_extremums + i, extremum);
+                _mm256_storeu_pd(results.m_criticalPoints + i, criticalPoint);
+                const int aMask = _mm256_movemask_pd(aIsZero);
+                const int bMask = _mm256_movemask_pd(bIsZero);
+                const int cMask = _mm256_movemask_pd(cIsZero);
+                const int discriminantMask = _mm256_movemask_pd(discriminantIsNegative);
+                for (unsigned lane = 0; lane < 4; ++lane)
+                {
+                    results.m_kinds[i + lane] = classify((aMask >> lane) & 1, (bMask >> lane) & 1,
+                        (cMask >> lane) & 1, (discriminantMask >> lane) & 1);
+                }
+            }
+            return i;
+        }
+
+        // Lanes of x where mask is set, lanes of y elsewhere (SSE2 has no blend instruction).
+        SOLVER_TARGET("sse2") inline __m128d select(const __m128d mask, const __m128d x, const __m128d y)
+        {
+            return _mm_or_pd(_mm_and_pd(mask, x), _mm_andnot_pd(mask, y));
+        }
+
+        SOLVER_TARGET("sse2") inline __m128d toDouble(const __m128i x)
+        {
+            return _mm_sub_pd(_mm_castsi128_pd(_mm_or_si128(x, _mm_set1_epi64x(twoTo52Bits))), _mm_set1_pd(twoTo52));
+        }
+
+        // Two ints sign-extended into 64-bit lanes (SSE2 has no cvtepi32_epi64).
+        SOLVER_TARGET("sse2") inline __m128i widen(const __m128i x)
+        {
+            return _mm_unpacklo_epi32(x, _mm_srai_epi32(x, 31));
+        }
+
+        // Signed products of the sign-extended 64-bit lanes x and y (SSE2 multiplies only unsigned ints).
+        // As unsigned, a negative int is x + 2^32, so the unsigned product exceeds xy by 2^32 * (y if x < 0, + x if y < 0), modulo 2^64.
+        SOLVER_TARGET("sse2") inline __m128i multiplySigned(const __m128i x, const __m128i y)
+        {
+            const __m128i excess = _mm_add_epi64(_mm_and_si128(_mm_srli_epi64(x, 32), y), _mm_and_si128(_mm_srli_epi64(y, 32), x));
+            return _mm_sub_epi64(_mm_mul_epu32(x, y), _mm_slli_epi64(excess, 32));
+        }
+
+        // D of solveBatchSse2 and its sign mask. The emulated 64-bit products cost more than the rest of the kernel,
+        // So vectors whose b^2 and |4ac| are below 2^52, where double D is exact, skip them.
+        SOLVER_TARGET("sse2") inline __m128d getDiscriminant(const __m128i aInts, const __m128i bInts, const __m128i cInts,
+            const __m128d a, const __m128d b, const __m128d c, __m128d& discriminantIsNegative)
+        {
+            const __m128d zero = _mm_setzero_pd();
+            const __m128d bSquaredFloating = _mm_mul_pd(b, b);
+            const __m128d fourAC = _mm_mul_pd(_mm_mul_pd(_mm_set1_pd(4.0), a), c);
+            if (_mm_movemask_pd(_mm_cmpge_pd(_mm_max_pd(bSquaredFloating, _mm_andnot_pd(_mm_set1_pd(-0.0), fourAC)), _mm_set1_pd(twoTo52))) == 0)
+            {
+                const __m128d discriminant = _mm_sub_pd(bSquaredFloating, fourAC);
+                discriminantIsNegative = _mm_cmplt_pd(discriminant, zero);
+                return discriminant;
+            }
+            const __m128i bWide = widen(bInts);
+            const __m128i bSquared = multiplySigned(bWide, bWide);
+            const __m128i quarter = _mm_sub_epi64(_mm_srli_epi64(bSquared, 2), multiplySigned(widen(aInts), widen(cInts)));
+            // The sign of the high half, copied to both halves of the lane.
+            discriminantIsNegative = _mm_castsi128_pd(_mm_shuffle_epi32(_mm_srai_epi32(quarter, 31), _MM_SHUFFLE(3, 3, 1, 1)));
+            return _mm_add_pd(_mm_mul_pd(toDouble(_mm_srli_epi64(quarter, 32)), _mm_set1_pd(twoTo34)),
+                toDouble(_mm_or_si128(_mm_slli_epi64(_mm_and_si128(quarter, _mm_set1_epi64x(0xFFFFFFFF)), 2), _mm_and_si128(bSquared, _mm_set1_epi64x(3)))));
+        }
+
+        SOLVER_TARGET("sse2") std::size_t solveBatchSse2(const int* const aCoefficients, const int* const bCoefficients, const int* const cCoefficients,
+            const std::size_t count, const BasicSolver<double>::ResultColumns& results)
+        {
+            std::size_t i = 0;
+            const __m128d zero = _mm_setzero_pd();
+            const __m128d signBit = _mm_set1_pd(-0.0); // Negation flips the sign bit, as unary minus does (0 - x would turn -0 into +0).
+            const __m128d minusHalf = _mm_set1_pd(-0.5);
+            for (; i + 2 <= count; i += 2)
+            {
+                const __m128i aInts = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(aCoefficients + i));
+                const __m128i bInts = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(bCoefficients + i));
+                const __m128i cInts = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(cCoefficients + i));
+                const __m128d a = _mm_cvtepi32_pd(aInts);
+                const __m128d b = _mm_cvtepi32_pd(bInts);
+                const __m128d c = _mm_cvtepi32_pd(cInts);
+                __m128d discriminantIsNegative;
+                const __m128d discriminant = getDiscriminant(aInts, bInts, cInts, a, b, c, discriminantIsNegative);
+                const __m128d sqrtDiscriminant = _mm_sqrt_pd(_mm_andnot_pd(discriminantIsNegative, discriminant));
+
+                const __m128d minusB = _mm_xor_pd(b, signBit);
+                const __m128d doubleA = _mm_add_pd(a, a);
+                const __m128d criticalPoint = _mm_div_pd(minusB, doubleA);
+                const __m128d extremum = _mm_add_pd(_mm_add_pd(
+                    _mm_mul_pd(_mm_mul_pd(a, criticalPoint), criticalPoint), _mm_mul_pd(b, criticalPoint)), c);
+                const __m128d aIsZero = _mm_cmpeq_pd(a, zero);
+                const __m128d bIsZero = _mm_cmpeq_pd(b, zero);
+                const __m128d cIsZero = _mm_cmpeq_pd(c, zero);
+                const __m128d bIsNegative = _mm_cmplt_pd(b, zero);
+                const __m128d linearRoot = _mm_andnot_pd(bIsZero, _mm_div_pd(_mm_xor_pd(c, signBit), b));
+                // Same as getStableRoots. Or-ing the sign bit of x into a non-negative value is copysign.
+                const __m128d q = _mm_mul_pd(_mm_add_pd(b, _mm_or_pd(sqrtDiscriminant, _mm_and_pd(b, signBit))), minusHalf);
+                const __m128d largeRoot = _mm_div_pd(q, a);
+                const __m128d smallRoot = select(cIsZero, _mm_and_pd(a, signBit), _mm_div_pd(c, q));
+                _mm_storeu_pd(results.m_firstRoots + i, select(aIsZero, linearRoot, select(bIsNegative, smallRoot, largeRoot)));
+                _mm_storeu_pd(results.m_secondRoots + i, select(bIsNegative, largeRoot, smallRoot));
+                _mm_storeu_pd(results.m_extremums + i, extremum);
+                _mm_storeu_pd(results.m_criticalPoints + i, criticalPoint);
+                const int aMask = _mm_movemask_pd(aIsZero);
+                const int bMask = _mm_movemask_pd(bIsZero);
+                const int cMask = _mm_movemask_pd(cIsZero);
+                const int discriminantMask = _mm_movemask_pd(discriminantIsNegative);
+                for (unsigned lane = 0; lane < 2; ++lane)
+                {
+                    results.m_kinds[i + lane] = classify((aMask >> lane) & 1, (bMask >> lane) & 1,
+                        (cMask >> lane) & 1, (discriminantMask >> lane) & 1);
+                }
+            }
+            return i;
+        }
+#endif
+
+        // Bit i is set if BatchKernel(i) can run on this CPU and OS.
+        [[nodiscard]] unsigned detectSupportedKernels() noexcept
+        {
+            unsigned supported = 1u << static_cast<unsigned>(BatchKernel::Scalar);
+#if defined(SOLVER_X86)
+#if defined(__GNUC__) || defined(__clang__)
+            // Features are reported only if the OS also saves their registers (XCR0).
+            __builtin_cpu_init();
+            const bool sse2 = __builtin_cpu_supports("sse2");
+            const bool avx2 = __builtin_cpu_supports("avx2");
+            const bool avx512 = __builtin_cpu_supports("avx512f");
+#else
+            int info[4];
+            __cpuid(info, 0);
+            const int maxLeaf = info[0];
+            __cpuid(info, 1);
+            const bool sse2 = (info[3] >> 26) & 1;
+            const bool osSavesVectorRegisters = (info[2] >> 27) & 1; // OSXSAVE.
+            const unsigned long long xcr0 = osSavesVectorRegisters ? _xgetbv(0) : 0;
+            bool avx2 = false;
+            bool avx512 = false;
+            if (maxLeaf >= 7)
+            {
+                __cpuidex(info, 7, 0);
+                // AVX needs the YMM state (XCR0 bits 1, 2), AVX-512 also the opmask and ZMM states (bits 5, 6, 7).
+                avx2 = ((info[1] >> 5) & 1) && (xcr0 & 0x6) == 0x6;
+                avx512 = ((info[1] >> 16) & 1) && (xcr0 & 0xe6) == 0xe6;
+            }
+#endif
+            supported |= (sse2 ? 1u : 0u) << static_cast<unsigned>(BatchKernel::Sse2);
+            supported |= (avx2 ? 1u : 0u) << static_cast<unsigned>(BatchKernel::Avx2);
+            supported |= (avx512 ? 1u : 0u) << static_cast<unsigned>(BatchKernel::Avx512);
+#endif
+            return supported;
+        }
+
+        [[nodiscard]] unsigned getSupportedKernels() noexcept
+        {
+            static const unsigned supported = detectSupportedKernels();
+            return supported;
+        }
+
+        [[nodiscard]] std::atomic<BatchKernel>& getActiveKernel() noexcept
+        {
+            static std::atomic<BatchKernel> kernel(getBestBatchKernel());
+            return kernel;
+        }
+    } // namespace
+
+    BatchKernel getBestBatchKernel() noexcept
+    {
+        for (const BatchKernel kernel : { BatchKernel::Avx512, BatchKernel::Avx2, BatchKernel::Sse2 })
+        {
+            if (isBatchKernelSupported(kernel))
+            {
+                return kernel;
+            }
+        }
+        return BatchKernel::Scalar;
+    }
+
+    BatchKernel getBatchKernel() noexcept
+    {
+        return getActiveKernel().load(std::memory_order_relaxed);
+    }
+
+    bool setBatchKernel(const BatchKernel kernel) noexcept
+    {
+        if (!isBatchKernelSupported(kernel))
+        {
+            return false;
+        }
+        getActiveKernel().store(kernel, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool isBatchKernelSupported(const BatchKernel kernel) noexcept
+    {
+        return (getSupportedKernels() >> static_cast<unsigned>(kernel)) & 1;
+    }
+
+    std::string_view getBatchKernelName(const BatchKernel kernel) noexcept
+    {
+        switch (kernel)
+        {
+        case BatchKernel::Sse2:
+            return "sse2";
+        case BatchKernel::Avx2:
+            return "avx2";
+        case BatchKernel::Avx512:
+            return "avx512";
+        default:
+            return "scalar";
+        }
+    }
+
+    template<typename T>
+    typename BasicSolver<T>::Result BasicSolver<T>::solve(const T aCoefficient, const T bCoefficient, const T cCoefficient)
+    {
+        if (aCoefficient != 0)
         {
             // Quadratic: ax^2 + bx + c = 0.
             // D = b^2 - 4ac.
             // In case of D < 0.0 no real roots exists,
-            // Otherwise x1,x2 = (-b +- sqrt(D)) / 2a.
+            // Otherwise x1,x2 = (-b +- sqrt(D)) / 2a, evaluated by getStableRoots.
             // In both cases we can provide criticalPoint(-b/2a) and extremum(by putting criticalPoint into equation).
-            const long double minusBCoefficient = -bCoefficient;
-            const long double doubleACoefficient = 2 * aCoefficient;
-            const long double criticalPoint = minusBCoefficient / doubleACoefficient;
-            const long double extremum = aCoefficient * criticalPoint * criticalPoint + bCoefficient * criticalPoint + cCoefficient;
+            const T criticalPoint = -bCoefficient / (2 * aCoefficient);
+            const T extremum = aCoefficient * criticalPoint * criticalPoint + bCoefficient * criticalPoint + cCoefficient;
 
-            if (const long double discriminant = bCoefficient * bCoefficient - 4 * aCoefficient * cCoefficient; discriminant < 0.0)
+            if (const T discriminant = bCoefficient * bCoefficient - 4 * aCoefficient * cCoefficient; discriminant < 0)
             {
                 return QuadraticResult{ std::nullopt, extremum, criticalPoint };
             }
             else
             {
-                const long double sqrtDiscriminant = sqrtl(discriminant);
                 return QuadraticResult{
-                    std::make_pair((minusBCoefficient - sqrtDiscriminant) / doubleACoefficient,
-                                   (minusBCoefficient + sqrtDiscriminant) / doubleACoefficient),
+                    getStableRoots(aCoefficient, bCoefficient, cCoefficient, std::sqrt(discriminant)),
                     extremum, criticalPoint
                 };
             }
@@ -46,6 +541,73 @@ namespace slv
         // In case of b == 0 && c != 0 the equation is not correct.
         // In case of b == 0 && c == 0 the equation is an identity.
         // In case of b != 0, x = -c/b and extremum = x, at every point.
-        return bCoefficient == 0.0 ? LinearResult{ std::nullopt } : LinearResult{ -cCoefficient / bCoefficient };
+        return bCoefficient == 0 ? LinearResult{ std::nullopt } : LinearResult{ -cCoefficient / bCoefficient };
     }
+
+    template<typename T>
+    typename BasicSolver<T>::Result BasicSolver<T>::solve(const int aCoefficient, const int bCoefficient, const int cCoefficient)
+    {
+        // The exact integer path of solveBatch, for one row. Columns unused by the kind are never read.
+        T firstRoot, secondRoot, extremum, criticalPoint;
+        ResultKind kind;
+        const ResultColumns columns{ &firstRoot, &secondRoot, &extremum, &criticalPoint, &kind };
+        solveBatchScalar<T>(&aCoefficient, &bCoefficient, &cCoefficient, 0, 1, columns);
+        return toResult(columns, 0);
+    }
+
+    template<typename T>
+    void BasicSolver<T>::solveBatch(const int* const aCoefficients, const int* const bCoefficients, const int* const cCoefficients,
+        const std::size_t count, const ResultColumns& results)
+    {
+        solveBatchScalar<T>(aCoefficients, bCoefficients, cCoefficients, 0, count, results);
+    }
+
+    template<>
+    void BasicSolver<double>::solveBatch(const int* const aCoefficients, const int* const bCoefficients, const int* const cCoefficients,
+        const std::size_t count, const ResultColumns& results)
+    {
+        std::size_t i = 0;
+#if defined(SOLVER_X86)
+        switch (getBatchKernel())
+        {
+        case BatchKernel::Avx512:
+            i = solveBatchAvx512(aCoefficients, bCoefficients, cCoefficients, count, results);
+            break;
+        case BatchKernel::Avx2:
+            i = solveBatchAvx2(aCoefficients, bCoefficients, cCoefficients, count, results);
+            break;
+        case BatchKernel::Sse2:
+            i = solveBatchSse2(aCoefficients, bCoefficients, cCoefficients, count, results);
+            break;
+        default:
+            break;
+        }
+#endif
+        // Scalar kernel and tail of the vector kernels.
+        solveBatchScalar<double>(aCoefficients, bCoefficients, cCoefficients, i, count, results);
+    }
+
+    template<typename T>
+    typename BasicSolver<T>::Result BasicSolver<T>::toResult(const ResultColumns& results, const std::size_t i)
+    {
+        switch (results.m_kinds[i])
+        {
+        case ResultKind::Linear:
+            return LinearResult{ results.m_firstRoots[i] };
+        case ResultKind::Identity:
+        case ResultKind::Incorrect:
+            return LinearResult{ std::nullopt };
+        case ResultKind::NoRealRoots:
+            return QuadraticResult{ std::nullopt, results.m_extremums[i], results.m_criticalPoints[i] };
+        default:
+            return QuadraticResult{
+                std::make_pair(results.m_firstRoots[i], results.m_secondRoots[i]),
+                results.m_extremums[i], results.m_criticalPoints[i]
+            };
+        }
+    }
+
+    template class BasicSolver<float>;
+    template class BasicSolver<double>;
+    template class BasicSolver<long double>;
 } // namespace slv
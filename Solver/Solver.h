@@ -1,7 +1,7 @@
 /**
  * @file Solver.h
  *
- * @brief Solver class for solving quadratic and linear equations.
+ * @brief BasicSolver class template for solving quadratic and linear equations with float, double or long double precision.
  *
  * @author Hovsep Papoyan
  * Contact: papoyanhovsep93@gmail.com
@@ -12,24 +12,108 @@
 #ifndef SOLVER_H
 #define SOLVER_H
 
+#include <concepts>
+#include <cstddef>
 #include <optional>
+#include <string_view>
+#include <utility>
 #include <variant>
 
+// Floating type of slv::Solver and slv::ParallelSolver, e.g. /D "SOLVER_FLOAT_TYPE=double".
+// long double keeps the output of the original Solver. double is opt-in (also --precision double), solveBatch vectorizes it.
+#ifndef SOLVER_FLOAT_TYPE
+#define SOLVER_FLOAT_TYPE long double
+#endif
+
 namespace slv
 {
-    class Solver
+    // Classification of one equation, produced by solveBatch.
+    enum class ResultKind : unsigned char
+    {
+        Linear,      // bx + c = 0, b != 0. Root is in m_firstRoots.
+        Identity,    // 0 = 0.
+        Incorrect,   // a = 0, b = 0 and c != 0.
+        NoRealRoots, // D < 0. Only m_extremums and m_criticalPoints are meaningful.
+        TwoRoots     // D >= 0. All columns are meaningful.
+    };
+
+    // Instruction sets of the double version of solveBatch. The best one the CPU and the OS support is picked on first use,
+    // So one binary uses the full vector width of AVX-512 hosts and still runs on SSE2-only ones. All kernels give identical results.
+    enum class BatchKernel : unsigned char
+    {
+        Scalar,
+        Sse2,
+        Avx2,
+        Avx512
+    };
+
+    [[nodiscard]] BatchKernel getBestBatchKernel() noexcept;
+    // The kernel solveBatch uses now.
+    [[nodiscard]] BatchKernel getBatchKernel() noexcept;
+    // Overrides the choice, e.g. for testing. Returns false and keeps the current kernel if the CPU doesn't support this one.
+    bool setBatchKernel(const BatchKernel kernel) noexcept;
+    [[nodiscard]] bool isBatchKernelSupported(const BatchKernel kernel) noexcept;
+    // "scalar", "sse2", "avx2" or "avx512".
+    [[nodiscard]] std::string_view getBatchKernelName(const BatchKernel kernel) noexcept;
+
+    // Instantiated for float, double and long double (see Solver.cpp).
+    template<typename T>
+    class BasicSolver
     {
     public:
+        using Float = T;
+        using ResultKind = slv::ResultKind;
+
         struct QuadraticResult
         {
-            std::optional<std::pair<long double, long double>> m_roots;
-            long double m_extremum;
-            long double m_criticalPoint;
+            std::optional<std::pair<T, T>> m_roots;
+            T m_extremum;
+            T m_criticalPoint;
+
+            friend bool operator==(const QuadraticResult&, const QuadraticResult&) = default;
         };
-        using LinearResult = std::optional<long double>;
+        using LinearResult = std::optional<T>;
         using Result = std::variant<LinearResult, QuadraticResult>;
-        static [[nodiscard]] Result solve(const long double aCoefficient, const long double bCoefficient, const long double cCoefficient);
+
+        // Output columns of solveBatch. Every pointer must address at least count elements.
+        struct ResultColumns
+        {
+            T* m_firstRoots;
+            T* m_secondRoots;
+            T* m_extremums;
+            T* m_criticalPoints;
+            ResultKind* m_kinds;
+        };
+
+        [[nodiscard]] static Result solve(const T aCoefficient, const T bCoefficient, const T cCoefficient);
+        // Same results as solveBatch: D = b^2 - 4ac is computed in 64-bit integers, so the kind is exact
+        // And perfect square discriminants give exact roots. Floating point is used only for the final values.
+        [[nodiscard]] static Result solve(const int aCoefficient, const int bCoefficient, const int cCoefficient);
+        // Other floating types are converted to T, e.g. solve(1.0, 2.0, 1.0) isn't ambiguous between the two above when T isn't double.
+        template<std::floating_point U>
+        [[nodiscard]] static Result solve(const U aCoefficient, const U bCoefficient, const U cCoefficient)
+        {
+            return solve(static_cast<T>(aCoefficient), static_cast<T>(bCoefficient), static_cast<T>(cCoefficient));
+        }
+
+        // Solves count equations given as separate a, b, c columns (structure of arrays), same results as solve for ints.
+        // The double version uses the lanes of the BatchKernel chosen at run time, other types use scalar code.
+        static void solveBatch(const int* aCoefficients, const int* bCoefficients, const int* cCoefficients,
+            const std::size_t count, const ResultColumns& results);
+
+        // Converts row i of solveBatch output into the Result representation.
+        [[nodiscard]] static Result toResult(const ResultColumns& results, const std::size_t i);
     };
+
+    template<>
+    void BasicSolver<double>::solveBatch(const int* aCoefficients, const int* bCoefficients, const int* cCoefficients,
+        const std::size_t count, const ResultColumns& results);
+
+    extern template class BasicSolver<float>;
+    extern template class BasicSolver<double>;
+    extern template class BasicSolver<long double>;
+
+    using Solver = BasicSolver<SOLVER_FLOAT_TYPE>;
 } // namespace slv
 
 #endif
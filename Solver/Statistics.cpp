@@ -0,0 +1,328 @@
+/**
+ * @file Statistics.cpp
+ *
+ * @brief Statistics class for process-wide pipeline counters and latency histograms.
+ *
+ * @author Hovsep Papoyan
+ * Contact: papoyanhovsep93@gmail.com
+ * @Date 2024-03-28
+ *
+ */
+
+#include "Statistics.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mt
+{
+    namespace
+    {
+        // Single-writer increment, cheaper than fetch_add which locks the cache line.
+        void increase(std::atomic<std::uint64_t>& value, const std::uint64_t delta) noexcept
+        {
+            value.store(value.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+        }
+
+        struct ThreadShard
+        {
+            std::array<std::atomic<std::uint64_t>, Statistics::countersCount> m_counters{};
+            std::array<Histogram, Statistics::distributionsCount> m_distributions;
+        };
+
+        // Shards of all threads ever recorded. A finished thread's shard is reused by the next new thread,
+        // So short-lived threads don't grow memory. Shards are never freed, their counts stay in the totals.
+        class ShardRegistry
+        {
+        private:
+            std::mutex m_mutex;
+            std::vector<std::unique_ptr<ThreadShard>> m_shards;
+            std::vector<ThreadShard*> m_freeShards;
+
+        public:
+            [[nodiscard]] ThreadShard* acquire()
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (!m_freeShards.empty())
+                {
+                    ThreadShard* const shard = m_freeShards.back();
+                    m_freeShards.pop_back();
+                    return shard;
+                }
+                m_shards.push_back(std::make_unique<ThreadShard>());
+                return m_shards.back().get();
+            }
+
+            void release(ThreadShard* const shard)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_freeShards.push_back(shard);
+            }
+
+            template<typename Visitor>
+            void forEach(Visitor visitor)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                for (const std::unique_ptr<ThreadShard>& shard : m_shards)
+                {
+                    visitor(*shard);
+                }
+            }
+        };
+
+        // Never destroyed: threads may still record or exit after static destruction has begun.
+        ShardRegistry& getRegistry()
+        {
+            static ShardRegistry* const registry = new ShardRegistry;
+            return *registry;
+        }
+
+        // Returns the thread's shard to the registry when the thread exits.
+        struct ShardHolder
+        {
+            ThreadShard* m_shard = nullptr;
+
+            ~ShardHolder()
+            {
+                if (m_shard != nullptr)
+                {
+                    getRegistry().release(m_shard);
+                }
+            }
+        };
+
+        thread_local ShardHolder shardHolder;
+
+        [[nodiscard]] ThreadShard& getThreadShard()
+        {
+            if (shardHolder.m_shard == nullptr)
+            {
+                shardHolder.m_shard = getRegistry().acquire();
+            }
+            return *shardHolder.m_shard;
+        }
+
+        std::atomic<bool> enabled{ false };
+        std::atomic<std::uint64_t> sharedContainerHighWaterMark{ 0 };
+        // Lock-free, so setting it is safe in a signal handler.
+        std::atomic<bool> dumpRequested{ false };
+
+        void requestDump(int)
+        {
+            dumpRequested.store(true, std::memory_order_relaxed);
+        }
+
+        void dumpToStderr()
+        {
+            std::cerr << Statistics::getSnapshot() << std::flush;
+        }
+
+        void printDistribution(std::ostream& os, const char* const name, const Histogram::Snapshot& histogram)
+        {
+            os << "STATS: " << name << ": count " << histogram.getCount() << ", mean " << static_cast<std::uint64_t>(histogram.getMean())
+                << ", p50 " << histogram.getPercentile(0.5) << ", p90 " << histogram.getPercentile(0.9)
+                << ", p99 " << histogram.getPercentile(0.99) << ", p99.9 " << histogram.getPercentile(0.999)
+                << ", max " << histogram.getMax() << '\n';
+        }
+    } // namespace
+
+    double Histogram::Snapshot::getMean() const noexcept
+    {
+        return m_count != 0 ? static_cast<double>(m_sum) / static_cast<double>(m_count) : 0.0;
+    }
+
+    std::uint64_t Histogram::Snapshot::getPercentile(const double p) const noexcept
+    {
+        if (m_count == 0)
+        {
+            return 0;
+        }
+        const double clamped = std::clamp(p, 0.0, 1.0);
+        const std::uint64_t rank = std::max<std::uint64_t>(static_cast<std::uint64_t>(std::ceil(clamped * static_cast<double>(m_count))), 1);
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < bucketsCount; ++i)
+        {
+            seen += m_counts[i];
+            if (seen >= rank)
+            {
+                return std::min(getBucketUpperBound(i), m_max);
+            }
+        }
+        return m_max;
+    }
+
+    void Histogram::record(const std::uint64_t value) noexcept
+    {
+        increase(m_counts[getBucketIndex(value)], 1);
+        increase(m_count, 1);
+        increase(m_sum, value);
+        if (value < m_min.load(std::memory_order_relaxed))
+        {
+            m_min.store(value, std::memory_order_relaxed);
+        }
+        if (value > m_max.load(std::memory_order_relaxed))
+        {
+            m_max.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    void Histogram::addTo(Snapshot& snapshot) const noexcept
+    {
+        for (std::size_t i = 0; i < bucketsCount; ++i)
+        {
+            snapshot.m_counts[i] += m_counts[i].load(std::memory_order_relaxed);
+        }
+        snapshot.m_count += m_count.load(std::memory_order_relaxed);
+        snapshot.m_sum += m_sum.load(std::memory_order_relaxed);
+        snapshot.m_min = std::min(snapshot.m_min, m_min.load(std::memory_order_relaxed));
+        snapshot.m_max = std::max(snapshot.m_max, m_max.load(std::memory_order_relaxed));
+    }
+
+    std::size_t Histogram::getBucketIndex(const std::uint64_t value) noexcept
+    {
+        if (value < 2 * subBucketsCount)
+        {
+            return static_cast<std::size_t>(value);
+        }
+        // value = mantissa * 2^shift, mantissa in [subBucketsCount, 2 * subBucketsCount).
+        const std::size_t shift = static_cast<std::size_t>(std::bit_width(value)) - std::bit_width(subBucketsCount);
+        const std::size_t mantissa = static_cast<std::size_t>(value >> shift);
+        return 2 * subBucketsCount + (shift - 1) * subBucketsCount + (mantissa - subBucketsCount);
+    }
+
+    std::uint64_t Histogram::getBucketUpperBound(const std::size_t index) noexcept
+    {
+        if (index < 2 * subBucketsCount)
+        {
+            return index;
+        }
+        const std::size_t shift = (index - 2 * subBucketsCount) / subBucketsCount + 1;
+        const std::uint64_t mantissa = (index - 2 * subBucketsCount) % subBucketsCount + subBucketsCount;
+        return ((mantissa + 1) << shift) - 1;
+    }
+
+    std::uint64_t Statistics::Snapshot::getSharedContainerDepth() const noexcept
+    {
+        // Shards are read one by one, a pop may be seen without its push.
+        const std::uint64_t pushes = get(Counter::SharedContainerPushes);
+        const std::uint64_t pops = get(Counter::SharedContainerPops);
+        return pushes > pops ? pushes - pops : 0;
+    }
+
+    void Statistics::setEnabled(const bool isEnabled) noexcept
+    {
+        enabled.store(isEnabled, std::memory_order_relaxed);
+    }
+
+    bool Statistics::isEnabled() noexcept
+    {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    void Statistics::add(const Counter counter, const std::uint64_t value) noexcept
+    {
+        if (isEnabled())
+        {
+            increase(getThreadShard().m_counters[static_cast<std::size_t>(counter)], value);
+        }
+    }
+
+    void Statistics::record(const Distribution distribution, const std::uint64_t value) noexcept
+    {
+        if (isEnabled())
+        {
+            getThreadShard().m_distributions[static_cast<std::size_t>(distribution)].record(value);
+        }
+    }
+
+    void Statistics::updateSharedContainerHighWaterMark(const std::uint64_t depth) noexcept
+    {
+        if (!isEnabled())
+        {
+            return;
+        }
+        // Shared by all threads, but written only when a new maximum is reached.
+        std::uint64_t current = sharedContainerHighWaterMark.load(std::memory_order_relaxed);
+        while (depth > current && !sharedContainerHighWaterMark.compare_exchange_weak(current, depth, std::memory_order_relaxed))
+        { }
+    }
+
+    Statistics::Snapshot Statistics::getSnapshot()
+    {
+        Snapshot snapshot;
+        getRegistry().forEach([&](const ThreadShard& shard)
+            {
+                for (std::size_t i = 0; i < countersCount; ++i)
+                {
+                    snapshot.m_counters[i] += shard.m_counters[i].load(std::memory_order_relaxed);
+                }
+                for (std::size_t i = 0; i < distributionsCount; ++i)
+                {
+                    shard.m_distributions[i].addTo(snapshot.m_distributions[i]);
+                }
+                ++snapshot.m_threadsCount;
+            });
+        snapshot.m_sharedContainerHighWaterMark = sharedContainerHighWaterMark.load(std::memory_order_relaxed);
+        return snapshot;
+    }
+
+    void Statistics::installDumpHandlers()
+    {
+        static std::once_flag installed;
+        std::call_once(installed, []
+            {
+                // Printing is not allowed in a signal handler, the watcher thread does it.
+                static std::jthread watcher([](const std::stop_token stopToken)
+                    {
+                        std::mutex mutex;
+                        std::condition_variable_any sleepCondVar;
+                        std::unique_lock<std::mutex> lock(mutex);
+                        while (!stopToken.stop_requested())
+                        {
+                            // Returns early only when stop is requested.
+                            sleepCondVar.wait_for(lock, stopToken, std::chrono::milliseconds(100), [] { return false; });
+                            if (dumpRequested.exchange(false, std::memory_order_relaxed))
+                            {
+                                dumpToStderr();
+                            }
+                        }
+                    });
+#ifdef _WIN32
+                std::signal(SIGBREAK, requestDump);
+#else
+                std::signal(SIGUSR1, requestDump);
+#endif
+                std::atexit(dumpToStderr);
+            });
+    }
+
+    std::ostream& operator<<(std::ostream& os, const Statistics::Snapshot& snapshot)
+    {
+        using Counter = Statistics::Counter;
+        using Distribution = Statistics::Distribution;
+        os << "STATS: shared container: pushes " << snapshot.get(Counter::SharedContainerPushes)
+            << ", pops " << snapshot.get(Counter::SharedContainerPops)
+            << ", depth " << snapshot.getSharedContainerDepth()
+            << ", high-water mark " << snapshot.m_sharedContainerHighWaterMark << '\n';
+        os << "STATS: solver: blocks " << snapshot.get(Counter::SolvedBlocks)
+            << ", equations " << snapshot.get(Counter::SolvedEquations)
+            << ", formatted blocks " << snapshot.get(Counter::FormattedBlocks)
+            << ", threads " << snapshot.m_threadsCount << '\n';
+        printDistribution(os, "queue wait ns", snapshot.get(Distribution::QueueWaitNs));
+        printDistribution(os, "block solve ns", snapshot.get(Distribution::BlockSolveNs));
+        printDistribution(os, "block rows", snapshot.get(Distribution::BlockRows));
+        printDistribution(os, "format ns", snapshot.get(Distribution::FormatNs));
+        printDistribution(os, "push blocked ns", snapshot.get(Distribution::PushBlockedNs));
+        return os;
+    }
+} // namespace mt
@@ -0,0 +1,137 @@
+/**
+ * @file Statistics.h
+ *
+ * @brief Statistics class for process-wide pipeline counters and latency histograms.
+ *
+ * @author Hovsep Papoyan
+ * Contact: papoyanhovsep93@gmail.com
+ * @Date 2024-03-28
+ *
+ */
+
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+namespace mt
+{
+    // HDR-style log-linear histogram of non-negative integer values (e.g. nanoseconds).
+    // Values below 2 * subBucketsCount are counted exactly, every greater power of two range [2^k, 2^(k+1))
+    // Is split into subBucketsCount equal buckets, so a value is known with relative error below 1 / subBucketsCount.
+    // One thread records at a time (plain relaxed loads and stores, no read-modify-write), any thread may read.
+    class Histogram
+    {
+    public:
+        static constexpr std::size_t subBucketsCount = 16;
+        static constexpr std::size_t bucketsCount = 2 * subBucketsCount + (64 - 5) * subBucketsCount;
+
+        // Plain copy of one or more merged histograms.
+        class Snapshot
+        {
+        private:
+            std::array<std::uint64_t, bucketsCount> m_counts{};
+            std::uint64_t m_count = 0;
+            std::uint64_t m_sum = 0;
+            std::uint64_t m_min = UINT64_MAX;
+            std::uint64_t m_max = 0;
+
+            friend class Histogram;
+
+        public:
+            [[nodiscard]] std::uint64_t getCount() const noexcept { return m_count; }
+            [[nodiscard]] std::uint64_t getSum() const noexcept { return m_sum; }
+            [[nodiscard]] std::uint64_t getMin() const noexcept { return m_count != 0 ? m_min : 0; }
+            [[nodiscard]] std::uint64_t getMax() const noexcept { return m_max; }
+            [[nodiscard]] double getMean() const noexcept;
+            // The smallest bucket bound which at least fraction p (0..1) of values don't exceed, capped by getMax().
+            [[nodiscard]] std::uint64_t getPercentile(const double p) const noexcept;
+        };
+
+    private:
+        std::array<std::atomic<std::uint64_t>, bucketsCount> m_counts{};
+        std::atomic<std::uint64_t> m_count{ 0 };
+        std::atomic<std::uint64_t> m_sum{ 0 };
+        std::atomic<std::uint64_t> m_min{ UINT64_MAX };
+        std::atomic<std::uint64_t> m_max{ 0 };
+
+    public:
+        void record(const std::uint64_t value) noexcept;
+        // Adds the current values to snapshot.
+        void addTo(Snapshot& snapshot) const noexcept;
+
+        [[nodiscard]] static std::size_t getBucketIndex(const std::uint64_t value) noexcept;
+        // The greatest value counted in the bucket.
+        [[nodiscard]] static std::uint64_t getBucketUpperBound(const std::size_t index) noexcept;
+    };
+
+    // Process-wide statistics of the solving pipeline, collected only after setEnabled(true).
+    // Every thread records into its own shard, so recording is a few relaxed stores without contention.
+    // getSnapshot() merges the shards, including those of finished threads, so nothing recorded is lost.
+    class Statistics
+    {
+    public:
+        enum class Counter : std::size_t
+        {
+            SharedContainerPushes, // Items pushed to adapters marked with enableStatistics().
+            SharedContainerPops,
+            SolvedBlocks, // Block tasks of ParallelSolver.
+            SolvedEquations,
+            FormattedBlocks,
+            Count
+        };
+
+        enum class Distribution : std::size_t
+        {
+            QueueWaitNs, // Time from push to pop of an item in a marked FIFO adapter.
+            BlockSolveNs, // Time of a ParallelSolver worker solving one block.
+            BlockRows, // Equations per solved block.
+            FormatNs, // Time of formatting one block.
+            PushBlockedNs, // Time a push to a marked, bounded adapter has waited for room.
+            Count
+        };
+
+        static constexpr std::size_t countersCount = static_cast<std::size_t>(Counter::Count);
+        static constexpr std::size_t distributionsCount = static_cast<std::size_t>(Distribution::Count);
+
+        struct Snapshot
+        {
+            std::array<std::uint64_t, countersCount> m_counters{};
+            std::array<Histogram::Snapshot, distributionsCount> m_distributions{};
+            std::uint64_t m_sharedContainerHighWaterMark = 0;
+            std::size_t m_threadsCount = 0; // Threads which have recorded anything.
+
+            [[nodiscard]] std::uint64_t get(const Counter counter) const noexcept { return m_counters[static_cast<std::size_t>(counter)]; }
+            [[nodiscard]] const Histogram::Snapshot& get(const Distribution distribution) const noexcept
+            {
+                return m_distributions[static_cast<std::size_t>(distribution)];
+            }
+            // Items pushed but not popped yet.
+            [[nodiscard]] std::uint64_t getSharedContainerDepth() const noexcept;
+        };
+
+        static void setEnabled(const bool enabled) noexcept;
+        [[nodiscard]] static bool isEnabled() noexcept;
+
+        // Recording functions do nothing while statistics are disabled.
+        static void add(const Counter counter, const std::uint64_t value = 1) noexcept;
+        static void record(const Distribution distribution, const std::uint64_t value) noexcept;
+        // Called with the depth of a marked adapter after every push.
+        static void updateSharedContainerHighWaterMark(const std::uint64_t depth) noexcept;
+
+        [[nodiscard]] static Snapshot getSnapshot();
+
+        // Prints getSnapshot() to stderr at exit and every time the process gets SIGUSR1 (SIGBREAK, Ctrl+Break, on Windows).
+        // The signal handler only sets a flag, a background thread notices it within 100 ms and prints.
+        static void installDumpHandlers();
+    };
+
+    // One "STATS: ..." line per group, the same text the dump handlers print.
+    std::ostream& operator<<(std::ostream& os, const Statistics::Snapshot& snapshot);
+} // namespace mt
+
+#endif
@@ -0,0 +1,193 @@
+/**
+ * @file ThreadPool.cpp
+ *
+ * @brief ThreadPool class for running tasks on long-lived worker threads with work stealing.
+ *
+ * @author Hovsep Papoyan
+ * Contact: papoyanhovsep93@gmail.com
+ * @Date 2024-03-28
+ *
+ */
+
+#include "ThreadPool.h"
+#include "Topology.h"
+
+#include <algorithm>
+
+namespace mt
+{
+    namespace
+    {
+        // Identifies the pool and the worker the current thread belongs to (if any).
+        thread_local const ThreadPool* currentPool = nullptr;
+        thread_local std::size_t currentWorkerIndex = 0;
+    } // namespace
+
+    ThreadPool::ThreadPool(const std::size_t threadsCount, const Affinity affinity)
+        : m_affinity(affinity)
+        , m_pendingTasksCount(0)
+        , m_nextWorker(0)
+    {
+        const std::size_t count = threadsCount != 0 ? threadsCount : 1;
+        m_workers.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            m_workers.push_back(std::make_unique<Worker>());
+        }
+        if (m_affinity != Affinity::None)
+        {
+            // Round-robin over nodes, so that a pool smaller than the machine still uses the memory bandwidth of every node.
+            const std::vector<Topology::Node>& nodes = Topology::get().getNodes();
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const std::size_t node = i % nodes.size();
+                const std::vector<std::size_t>& cpus = nodes[node].m_cpus;
+                m_workers[i]->m_node = node;
+                m_workers[i]->m_cpu = cpus[(i / nodes.size()) % cpus.size()];
+            }
+        }
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            // Victims in order i + 1, i + 2, ..., workers of the same node first.
+            std::vector<std::size_t>& victims = m_workers[i]->m_victims;
+            for (std::size_t j = 1; j < count; ++j)
+            {
+                victims.push_back((i + j) % count);
+            }
+            std::ranges::stable_partition(victims, [&](const std::size_t victim) { return m_workers[victim]->m_node == m_workers[i]->m_node; });
+        }
+        m_threads.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            m_threads.emplace_back([this, i](const std::stop_token stopToken) { workerThreadWork(stopToken, i); });
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        for (std::jthread& thread : m_threads)
+        {
+            thread.request_stop();
+        }
+        // Threads are joined by their destructors, the wakeup is done by condition_variable_any stop_token support.
+        m_threads.clear();
+    }
+
+    bool ThreadPool::runPendingTask()
+    {
+        if (m_affinity != Affinity::None && currentPool != this)
+        {
+            return false;
+        }
+        Task task;
+        const std::size_t workerIndex = currentPool == this
+            ? currentWorkerIndex : m_nextWorker.load(std::memory_order_relaxed) % m_workers.size();
+        if (!tryPopTask(workerIndex, task))
+        {
+            return false;
+        }
+        task();
+        return true;
+    }
+
+    std::size_t ThreadPool::getThreadsCount() const noexcept
+    {
+        return m_threads.size();
+    }
+
+    std::size_t ThreadPool::getWorkerNode(const std::size_t workerIndex) const noexcept
+    {
+        return m_workers[workerIndex]->m_node;
+    }
+
+    std::size_t ThreadPool::getDefaultThreadsCount() noexcept
+    {
+        const std::size_t hardwareThreads = std::jthread::hardware_concurrency();
+        // In case of hardwareThreads == 0, the value 2 chosen hypothetically,
+        // Taking into account that in this application 4 threads already can be started
+        // (2 threads per consumer and 2 threads per producer).
+        return hardwareThreads != 0 ? hardwareThreads : 2;
+    }
+
+    ThreadPool& ThreadPool::getDefault()
+    {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    void ThreadPool::pushTask(Task task)
+    {
+        // Tasks spawned by a worker stay in its own deque, others are spread round-robin.
+        const std::size_t workerIndex = currentPool == this
+            ? currentWorkerIndex : m_nextWorker.fetch_add(1, std::memory_order_relaxed) % m_workers.size();
+        pushTask(workerIndex, std::move(task));
+    }
+
+    void ThreadPool::pushTask(const std::size_t workerIndex, Task task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_workers[workerIndex]->m_mutex);
+            m_workers[workerIndex]->m_tasks.push_back(std::move(task));
+        }
+        m_pendingTasksCount.fetch_add(1);
+        {
+            // Taking the mutex orders this notification after a sleeping worker has checked its predicate.
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+        }
+        m_sleepCondVar.notify_one();
+    }
+
+    bool ThreadPool::tryPopTask(const std::size_t workerIndex, Task& task)
+    {
+        {
+            Worker& own = *m_workers[workerIndex];
+            std::lock_guard<std::mutex> lock(own.m_mutex);
+            if (!own.m_tasks.empty())
+            {
+                task = std::move(own.m_tasks.back());
+                own.m_tasks.pop_back();
+                m_pendingTasksCount.fetch_sub(1);
+                return true;
+            }
+        }
+        for (const std::size_t victimIndex : m_workers[workerIndex]->m_victims)
+        {
+            Worker& victim = *m_workers[victimIndex];
+            std::lock_guard<std::mutex> lock(victim.m_mutex);
+            if (!victim.m_tasks.empty())
+            {
+                task = std::move(victim.m_tasks.front());
+                victim.m_tasks.pop_front();
+                m_pendingTasksCount.fetch_sub(1);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void ThreadPool::workerThreadWork(const std::stop_token stopToken, const std::size_t workerIndex)
+    {
+        currentPool = this;
+        currentWorkerIndex = workerIndex;
+        // Pinning is best effort, a refused request leaves the worker wherever the OS puts it.
+        if (m_affinity == Affinity::Core)
+        {
+            Topology::pinCurrentThreadToCpu(m_workers[workerIndex]->m_cpu);
+        }
+        else if (m_affinity == Affinity::Node)
+        {
+            Topology::get().pinCurrentThreadToNode(m_workers[workerIndex]->m_node);
+        }
+        while (!stopToken.stop_requested())
+        {
+            if (Task task; tryPopTask(workerIndex, task))
+            {
+                // Exceptions are delivered through the futures of packaged tasks.
+                task();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(m_sleepMutex);
+            m_sleepCondVar.wait(lock, stopToken, [&] { return m_pendingTasksCount.load() != 0; });
+        }
+    }
+} // namespace mt
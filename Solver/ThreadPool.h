@@ -0,0 +1,135 @@
+/**
+ * @file ThreadPool.h
+ *
+ * @brief ThreadPool class for running tasks on long-lived worker threads with work stealing.
+ *
+ * @author Hovsep Papoyan
+ * Contact: papoyanhovsep93@gmail.com
+ * @Date 2024-03-28
+ *
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace mt
+{
+    // Every worker owns a deque of tasks. A worker pops its own tasks from the back (LIFO, cache friendly)
+    // And steals tasks of other workers from the front (FIFO, oldest and usually biggest work first).
+    // Tasks submitted from outside the pool are distributed round-robin among the workers.
+    // Optionally workers are pinned to CPUs or NUMA nodes (see Affinity), then they steal from their own node first.
+    class ThreadPool
+    {
+    public:
+        enum class Affinity
+        {
+            None, // The OS places workers anywhere.
+            Core, // Every worker is pinned to one CPU.
+            Node  // Every worker is pinned to the CPUs of one NUMA node.
+        };
+
+    private:
+        using Task = std::function<void()>;
+
+        struct Worker
+        {
+            std::mutex m_mutex;
+            std::deque<Task> m_tasks;
+            std::size_t m_node = 0; // Index into Topology::getNodes().
+            std::size_t m_cpu = 0; // Used by Affinity::Core.
+            std::vector<std::size_t> m_victims; // Workers to steal from, the same node first.
+        };
+
+        std::vector<std::unique_ptr<Worker>> m_workers;
+        Affinity m_affinity;
+        std::atomic<std::size_t> m_pendingTasksCount;
+        std::atomic<std::size_t> m_nextWorker;
+        std::mutex m_sleepMutex;
+        std::condition_variable_any m_sleepCondVar;
+        std::vector<std::jthread> m_threads; // Declared last, so threads are joined before the deques are destroyed.
+
+    public:
+        // With an affinity workers are spread round-robin over the NUMA nodes of Topology::get().
+        explicit ThreadPool(const std::size_t threadsCount = getDefaultThreadsCount(), const Affinity affinity = Affinity::None);
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool(ThreadPool&&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+        ThreadPool& operator=(ThreadPool&&) = delete;
+        ~ThreadPool();
+
+        template<typename Callable>
+        [[nodiscard]] std::future<std::invoke_result_t<Callable>> submit(Callable callable);
+        // Queues the task to the given worker, e.g. to run it on a known NUMA node. Idle workers may still steal it.
+        template<typename Callable>
+        [[nodiscard]] std::future<std::invoke_result_t<Callable>> submitTo(const std::size_t workerIndex, Callable callable);
+
+        // Blocks until the future (std::future or std::shared_future) becomes ready, executing pending tasks
+        // Of the pool in the meantime. This way the calling thread takes part in the work instead of sleeping.
+        template<typename Future>
+        void waitFor(const Future& future);
+
+        // Executes one pending task on the calling thread. Returns false if there was no task.
+        // With an affinity only workers execute tasks, a foreign thread would run them on an unknown node.
+        bool runPendingTask();
+
+        [[nodiscard]] std::size_t getThreadsCount() const noexcept;
+        [[nodiscard]] Affinity getAffinity() const noexcept { return m_affinity; }
+        // NUMA node (index into Topology::getNodes()) the worker is pinned to, 0 for Affinity::None.
+        [[nodiscard]] std::size_t getWorkerNode(const std::size_t workerIndex) const noexcept;
+
+        [[nodiscard]] static std::size_t getDefaultThreadsCount() noexcept;
+        // Process-wide pool, created on first use.
+        [[nodiscard]] static ThreadPool& getDefault();
+
+    private:
+        void pushTask(Task task);
+        void pushTask(const std::size_t workerIndex, Task task);
+        [[nodiscard]] bool tryPopTask(const std::size_t workerIndex, Task& task);
+        void workerThreadWork(const std::stop_token stopToken, const std::size_t workerIndex);
+    };
+
+    template<typename Callable>
+    std::future<std::invoke_result_t<Callable>> ThreadPool::submit(Callable callable)
+    {
+        // std::function requires copyable callables, so the move-only packaged_task is shared.
+        auto task = std::make_shared<std::packaged_task<std::invoke_result_t<Callable>()>>(std::move(callable));
+        std::future<std::invoke_result_t<Callable>> future = task->get_future();
+        pushTask([task = std::move(task)] { (*task)(); });
+        return future;
+    }
+
+    template<typename Callable>
+    std::future<std::invoke_result_t<Callable>> ThreadPool::submitTo(const std::size_t workerIndex, Callable callable)
+    {
+        auto task = std::make_shared<std::packaged_task<std::invoke_result_t<Callable>()>>(std::move(callable));
+        std::future<std::invoke_result_t<Callable>> future = task->get_future();
+        pushTask(workerIndex % m_workers.size(), [task = std::move(task)] { (*task)(); });
+        return future;
+    }
+
+    template<typename Future>
+    void ThreadPool::waitFor(const Future& future)
+    {
+        while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            if (!runPendingTask())
+            {
+                // Nothing left to help with, remaining tasks are already running on workers.
+                future.wait();
+            }
+        }
+    }
+} // namespace mt
+
+#endif
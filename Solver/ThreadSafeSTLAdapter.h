@@ -12,9 +12,17 @@
 #ifndef THREAD_SAFE_STL_ADAPTER_H
 #define THREAD_SAFE_STL_ADAPTER_H
 
+#include "Statistics.h"
+
 #include <algorithm>
+#include <chrono>
 #include <condition_variable>
+#include <cstddef>
+#include <deque>
 #include <iterator>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace mt
 {
@@ -23,10 +31,15 @@ namespace mt
         [[nodiscard]] const char* what() const noexcept override { return "Exception: The adapter is empty"; }
     };
 
+    struct ClosedAdapter : std::exception
+    {
+        [[nodiscard]] const char* what() const noexcept override { return "Exception: The adapter is closed"; }
+    };
+
     template<typename Adapter>
     [[nodiscard]] constexpr auto detectTopMethodImpl(const Adapter* const p) noexcept -> decltype(p->top(), void(), true) { return true; }
 
-    [[nodiscard]] constexpr bool detectTopMethodImpl(const void* const p) noexcept { return false; }
+    [[nodiscard]] constexpr bool detectTopMethodImpl(const void* const) noexcept { return false; }
 
     template<typename Adapter>
     [[nodiscard]] constexpr bool detectTopMethod() noexcept { return detectTopMethodImpl(static_cast<const Adapter* const>(nullptr)); }
@@ -44,6 +57,12 @@ namespace mt
         }
     }
 
+    template<template<typename...> typename Adapt,
+        typename AdaptElem, template<typename...> typename Cont,
+        typename ContElem, template<typename> typename Alloc,
+        typename AllocElem, typename... Ts>
+    [[nodiscard]] const Cont<ContElem, Alloc<AllocElem>>& getProtectedContainer(const Adapt<AdaptElem, Cont<ContElem, Alloc<AllocElem>>, Ts...>& adapter);
+
     template<template<typename...> typename Adapt,
         typename AdaptElem, template<typename...> typename Cont,
         typename ContElem, template<typename> typename Alloc,
@@ -66,9 +85,21 @@ namespace mt
     class ThreadSafeSTLAdapter
     {
     private:
+        using ElemAllocator = typename std::allocator_traits<Alloc<AllocElem>>::template rebind_alloc<typename AdaptElem::element_type>;
+
         Adapt<AdaptElem, Cont<ContElem, Alloc<AllocElem>>, Ts...> m_adapter;
-        std::mutex m_mutex;
+        // Allocates elements together with their shared_ptr control blocks, a copy of the container's allocator.
+        // It is fixed at construction (assignment and swap keep it), so pushes use it without the lock.
+        const ElemAllocator m_elemAllocator;
+        mutable std::mutex m_mutex; // Mutable, so copies can lock their source.
         std::condition_variable m_condVar;
+        std::condition_variable m_notFullCondVar; // Pushers waiting for room.
+        std::size_t m_waitersCount = 0; // Threads blocked in waitAndPop/waitFor, guarded by m_mutex.
+        std::size_t m_pushWaitersCount = 0; // Threads blocked in push/pushFor, guarded by m_mutex.
+        std::size_t m_capacity = 0;     // Maximum count of elements, 0 means unbounded, guarded by m_mutex.
+        bool m_closed = false;          // No more pushes are accepted, guarded by m_mutex.
+        bool m_recordStatistics = false; // See enableStatistics, guarded by m_mutex.
+        std::deque<std::chrono::steady_clock::time_point> m_pushTimes; // Push times of the newest elements, FIFO adapters only.
 
         explicit ThreadSafeSTLAdapter(Adapt<AdaptElem, Cont<ContElem, Alloc<AllocElem>>, Ts...>&& adapter);
 
@@ -76,13 +107,13 @@ namespace mt
             typename AdaptElem_, template<typename...> typename Cont_,
             typename ContElem_, template<typename> typename Alloc_,
             typename AllocElem_, typename... Ts_>
-        [[nodiscard]] friend auto createThreadSafeSTLAdapterFrom(const Adapt_<AdaptElem_, Cont_<ContElem_, Alloc_<AllocElem_>>, Ts_...>& adapter, Ts_... comparator);
+        friend auto createThreadSafeSTLAdapterFrom(const Adapt_<AdaptElem_, Cont_<ContElem_, Alloc_<AllocElem_>>, Ts_...>& adapter, Ts_... comparator);
 
         template<template<typename...> typename Adapt_,
             typename AdaptElem_, template<typename...> typename Cont_,
             typename ContElem_, template<typename> typename Alloc_,
             typename AllocElem_, typename... Ts_>
-        [[nodiscard]] friend auto createThreadSafeSTLAdapterFrom(Adapt_<AdaptElem_, Cont_<ContElem_, Alloc_<AllocElem_>>, Ts_...>&& adapter, Ts_... comparator);
+        friend auto createThreadSafeSTLAdapterFrom(Adapt_<AdaptElem_, Cont_<ContElem_, Alloc_<AllocElem_>>, Ts_...>&& adapter, Ts_... comparator);
 
     public:
         using Elem = typename AdaptElem::element_type;
@@ -93,19 +124,79 @@ namespace mt
         ThreadSafeSTLAdapter& operator=(ThreadSafeSTLAdapter&& rhs);
         ~ThreadSafeSTLAdapter() = default;
 
+        // Waits while the adapter is full. Throws ClosedAdapter if the adapter is closed, also while waiting.
         void push(Elem value);
         void pushAndNotify(Elem value);
+        // Returns false if the adapter is full. value is moved from only on success.
+        [[nodiscard]] bool tryPush(Elem& value);
+        // Returns false if the adapter is still full when timeout expires. value is moved from only on success.
+        template<typename Rep, typename Period>
+        [[nodiscard]] bool pushFor(Elem& value, const std::chrono::duration<Rep, Period>& timeout);
+
+        // Bulk variants move a run of elements under one lock acquisition with one notification. The elements are moved from
+        // The range, those which are not pushed are moved back. If the adapter gets closed on the way, ClosedAdapter is thrown
+        // And the elements pushed before stay in the adapter. Waits until every element is pushed.
+        template<typename ForwardIt>
+        void pushBulk(ForwardIt first, ForwardIt last);
+        // Pushes the elements which fit now, returns the iterator past the last pushed one.
+        template<typename ForwardIt>
+        [[nodiscard]] ForwardIt tryPushBulk(ForwardIt first, ForwardIt last);
+        // Pushes the elements which fit until timeout expires, returns the iterator past the last pushed one.
+        template<typename ForwardIt, typename Rep, typename Period>
+        [[nodiscard]] ForwardIt pushBulkFor(ForwardIt first, ForwardIt last, const std::chrono::duration<Rep, Period>& timeout);
+
+        // Bounds the count of elements, 0 (the default) means unbounded. Shrinking the capacity doesn't drop elements,
+        // Pushes wait until enough of them are popped.
+        void setCapacity(const std::size_t capacity);
+        [[nodiscard]] std::size_t getCapacity();
 
         void waitAndPop(Elem& value);
         std::shared_ptr<Elem> waitAndPop();
 
         bool tryPop(Elem& value);
         std::shared_ptr<Elem> tryPop();
+        // Appends up to maxCount elements to out under one lock acquisition, returns how many.
+        std::size_t tryPopBulk(std::vector<Elem>& out, const std::size_t maxCount);
+
+        // Blocks until the adapter is not empty, stopWaiting() returns true or timeout expires.
+        // stopWaiting is evaluated under the adapter's lock, so a notifyAll() after its condition is set can't be missed.
+        template<typename Rep, typename Period, typename Predicate>
+        void waitFor(const std::chrono::duration<Rep, Period>& timeout, Predicate stopWaiting);
+        // Wakes all threads blocked in waitFor to reevaluate their stop conditions.
+        void notifyAll();
+
+        // After close() push throws ClosedAdapter, remaining elements can still be popped.
+        // Threads blocked in waitFor are woken, so consumers can notice the end of input without polling,
+        // Threads blocked in push are woken and get ClosedAdapter.
+        void close();
+        [[nodiscard]] bool isClosed();
+        // True if the adapter is closed and all its elements are popped: no element will ever appear again.
+        [[nodiscard]] bool isDrained();
 
         void pop(Elem& value);
         std::shared_ptr<Elem> pop();
 
         void swap(ThreadSafeSTLAdapter& rhs);
+
+        // Marks the adapter as the pipeline's shared container: while mt::Statistics is enabled its pushes, pops,
+        // Depth and, for FIFO adapters (std::queue), the time elements wait are recorded.
+        void enableStatistics();
+
+    private:
+        // Pushes item once waitForRoom(lock, hasRoom) returns true, it is called under m_mutex only if the adapter is full.
+        template<typename WaitForRoom>
+        [[nodiscard]] bool pushWith(std::shared_ptr<Elem>& item, WaitForRoom waitForRoom);
+        template<typename ForwardIt, typename WaitForRoom>
+        [[nodiscard]] ForwardIt pushBulkWith(ForwardIt first, ForwardIt last, WaitForRoom waitForRoom);
+        // Called under m_mutex, records the time a pusher has waited for room.
+        void recordPushBlocked(const std::chrono::steady_clock::time_point waitStart);
+        [[nodiscard]] bool isFull() const noexcept { return m_capacity != 0 && m_adapter.size() >= m_capacity; }
+        // Called under m_mutex after an element is removed.
+        void notifyPusher();
+
+        // Both are called under m_mutex, recordPop before the element is removed.
+        void recordPush();
+        void recordPop();
     };
 
     template<template<typename...> typename Adapt,
@@ -115,6 +206,7 @@ namespace mt
     ThreadSafeSTLAdapter<Adapt, AdaptElem, Cont, ContElem, Alloc, AllocElem, Ts...>::
         ThreadSafeSTLAdapter(Adapt<AdaptElem, Cont<ContElem, Alloc<AllocElem>>, Ts...>&& adapter)
         : m_adapter(std::move(adapter))
+        , m_elemAllocator(getProtectedContainer(m_adapter).get_allocator())
     { }
 
     template<template<typename...> typename Adapt,
@@ -123,9 +215,13 @@ namespace mt
         typename AllocElem, typename... Ts>
     ThreadSafeSTLAdapter<Adapt, AdaptElem, Cont, ContElem, Alloc, AllocElem, Ts...>::
         ThreadSafeSTLAdapter(const ThreadSafeSTLAdapter<Adapt, AdaptElem, Cont, ContElem, Alloc, AllocElem, Ts...>& rhs)
+        : m_elemAllocator(rhs.m_elemAllocator)
     {
         std::lock_guard<std::mutex> lock(rhs.m_mutex);
         m_adapter = rhs.m_adapter;
+        m_capacity = rhs.m_capacity;
+        m_recordStatistics = rhs.m_recordStatistics;
+        m_pushTimes = rhs.m_pushTimes;
     }
 
     template<template<typename...> typename Adapt,
@@ -134,9 +230,14 @@ namespace mt
         typename AllocElem, typename... Ts>
     ThreadSafeSTLAdapter<Adapt, AdaptElem, Cont, ContElem, Alloc, AllocElem, Ts...>::
         ThreadSafeSTLAdapter(ThreadSafeSTLAdapter<Adapt, AdaptElem, Cont, ContElem, Alloc, AllocElem, Ts...>&& rhs)
+        : m_elemAllocator(rhs.m_elemAllocator)
     {
         std::lock_guard<std::mutex> lock(rhs.m_mutex);
         m_adapter = std::move_if_noexcept(rhs.m_adapter);
+        m_capacity = rhs.m_capacity;
+        m_recordStatistics = rhs.m_recordStatistics;
+        m_pushTimes = std::move(rhs.m_pushTimes);
+        rhs.m_pushTimes.clear();
     }
 
     template<template<typename...> typename Adapt,
@@ -151,6 +252,9 @@ namespace mt
         {
             std::scoped_lock lock(m_mutex, rhs.m_mutex);
             m_adapter = rhs.m_adapter;
+            m_capacity = rhs.m_capacity;
+            m_recordStatistics = rhs.m_recordStatistics;
+            m_pushTimes = rhs.m_pushTimes;
         }
         return *this;
     }
@@ -167,6 +271,10 @@ namespace mt
         {
             std::scoped_lock lock(m_mutex, rhs.m_mutex);
             m_adapter = std::move_if_noexcept(rhs.m_adapter);
+            m_capacity = rhs.m_capacity;
+            m_recordStatistics = rhs.m_recordStatistics;
+            m_pushTimes = std::move(rhs.m_pushTimes);
+            rhs.m_pushTimes.clear();
         }
         return *this;
     }
@@ -177,9 +285,252 @@ namespace mt
         typename AllocElem, typename... Ts>
     void ThreadSafeSTLAdapter<Adapt, AdaptElem, Cont, ContElem, Alloc, AllocElem, Ts...>::push(Elem value)
     {
-        std::shared_ptr<Elem> item(std::make_shared<Elem>(std::move_if_noexcept(value)));
+        std::shared_ptr<Elem> item(std::allocate_shared<Elem>(m_elemAllocator, std::move_if_noexcept(value)));
+        (void)pushWith(item, [this](std::unique_lock<std::mutex>& lock, const auto& hasRoom)
+            {
+                m_notFullCondVar.wait(lock, hasRoom);
+                return true;
+            });
+    }
+
+    template<template<typename...> typename Adapt,
+        typename AdaptElem, template<typename...> typename Cont,
+        typename ContElem, template<typename> typename Alloc,
+        typename AllocElem, typename... Ts>
+    bool ThreadSafeSTLAdapter<Adapt, AdaptElem, Cont, ContElem, Alloc, AllocElem, Ts...>::tryPush(Elem& value)
+    {
+        std::shared_ptr<Elem> item(std::allocate_shared<Elem>(m_elemAllocator, std::move_if_noexcept(value)));
+        if (!pushWith(item, [](std::unique_lock<std::mutex>&, const auto&) { return false; }))
+        {
+            value = std::move_if_noexcept(*item);
+            return false;
+        }
+        return true;
+    }
+
+    template<template<typename...> typename Adapt,
+        typename AdaptElem, template<typename...> typename Cont,
+        typename ContElem, template<typename> typename Alloc,
+        typename AllocElem, typename... Ts>
+    template<typename Rep, typename Period>
+    bool ThreadSafeSTLAdapter<Adapt, AdaptElem, Cont, ContElem, Alloc, AllocElem, Ts...>::pushFor(Elem& value, const std::chrono::duration<Rep, Period>& timeout)
+    {
+        std::shared_ptr<Elem> item(std::allocate_shared<Elem>(m_elemAllocator, std::move_if_noexcept(value)));
+        if (!pushWith(item, [&](std::unique_lock<std::mutex>& lock, const auto& hasRoom) { return m_notFullCondVar.wait_for(lock, timeout, hasRoom); }))
+        {
+            value = std::move_if_noexcept(*item);
+            return false;
+        }
+        return true;
+    }
+
+    template<template<typename...> typename Adapt,
+        typename AdaptElem, template<typename...> typename Cont,
+        typename ContElem, template<typename> typename Alloc,
+        typename AllocElem, typename... Ts>
+    template<typename WaitForRoom>
+    bool ThreadSafeSTLAdapter<Adapt, AdaptElem, Cont, ContElem, Alloc, AllocElem, Ts...>::pushWith(std::shared_ptr<Elem>& item, WaitForRoom waitForRoom)
+    {
+        bool hasWaiters;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (!m_closed && isFull())
+            {
+                const auto waitStart = std::chrono::steady_clock::now();
+                ++m_pushWaitersCount;
+                const bool hasRoom = waitForRoom(lock, [this] { return m_closed || !isFull(); });
+                --m_pushWaitersCount;
+                recordPushBlocked(waitStart);
+                if (!hasRoom)
+                {
+                    return false;
+                }
+            }
+            if (m_closed)
+            {
+                throw ClosedAdapter{};
+            }
+            m_adapter.push(std::move(item));
+            recordPush();
+            hasWaiters = m_waitersCount != 0;
+        }
+        // Parked threads are woken without the cost of a notification when nobody waits.
+        if (hasWaiters)
+        {
+            m_condVar.notify_one();
+        }
+        return true;
+    }
+
+    template<template<typename...> typename Adapt,
+        typename AdaptElem, template<typename...> typename Cont,
+        typename ContElem, template<typename> typename Alloc,
+        typename AllocElem, typename... Ts>
+    template<typename ForwardIt>
+    void ThreadSafeSTLAdapter<Adapt, AdaptElem, Cont, ContElem, Alloc, AllocElem, Ts...>::pushBulk(ForwardIt first, ForwardIt last)
+    {
+        (void)pushBulkWith(first, last, [this](std::unique_lock<std::mutex>& lock, const auto& hasRoom)
+            {
+                m_notFullCondVar.wait(lock, hasRoom);
+                return true;
+            });
+    }
+
+    template<template<typename...> typename Adapt,
+        typename AdaptElem, template<typename...> typename Cont,
+        typename ContElem, template<typename> typename Alloc,
+        typename AllocElem, typename... Ts>
+    template<typename ForwardIt>
+    ForwardIt ThreadSafeSTLAdapter<Adapt, AdaptElem, Cont, ContElem, Alloc, AllocElem, Ts...>::tryPushBulk(ForwardIt first, ForwardIt last)
+    {
+        return pushBulkWith(first, last, [](std::unique_lock<std::mutex>&, const auto&) { return false; });
+    }
+
+    template<template<typename...> typename Adapt,
+        typename AdaptElem, template<typename...> typename Cont,
+        typename ContElem, template<typename> typename Alloc,
+        typename AllocElem, typename... Ts>
+    template<typename ForwardIt, typename Rep, typename Period>
+    ForwardIt ThreadSafeSTLAdapter<Adapt, AdaptElem, Cont, ContElem, Alloc, AllocElem, Ts...>::pushBulkFor(ForwardIt first, ForwardIt last, const std::chrono::duration<Rep, Period>& timeout)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        return pushBulkWith(first, last, [&](std::unique_lock<std::mutex>& lock, const auto& hasRoom)
+            {
+                return m_notFullCondVar.wait_until(lock, deadline, hasRoom);
+            });
+    }
+
+    template<template<typename...> typename Adapt,
+        typename AdaptElem, template<typename...> typename Cont,
+        typename ContElem, template<typename> typename Alloc,
+        typename AllocElem, typename... Ts>
+    template<typename ForwardIt, typename WaitForRoom>
+    ForwardIt ThreadSafeSTLAdapter<Adapt, AdaptElem, Cont, ContElem, Alloc, AllocElem, Ts...>::pushBulkWith(ForwardIt first, ForwardIt last, WaitForRoom waitForRoom)
+    {
+        // Elements are wrapped without the lock, so it isn't held during allocations, and only as many as there is room for.
+        // So a producer retrying a long range against a full container doesn't wrap and unwrap all of it on every call.
+        std::vector<std::shared_ptr<Elem>> items; // Wrapped elements, items[itemsPushed...] aren't pushed yet.
+        std::size_t itemsPushed = 0;
+        ForwardIt unwrapped = first;
+        std::size_t unwrappedCount = static_cast<std::size_t>(std::distance(first, last));
+        std::size_t pushedCount = 0;
+        bool closed = false;
+        bool hasWaiters = false;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            while (itemsPushed != items.size() || unwrappedCount != 0)
+            {
+                if (m_closed)
+                {
+                    closed = true;
+                    break;
+                }
+                if (isFull())
+                {
+                    // Consumers may take the pushed part of the run while this thread waits for room.
+                    if (m_waitersCount != 0 && pushedCount != 0)
+                    {
+                        m_condVar.notify_all();
+                    }
+                    const auto waitStart = std::chrono::steady_clock::now();
+                    ++m_pushWaitersCount;
+                    const bool hasRoom = waitForRoom(lock, [this] { return m_closed || !isFull(); });
+                    --m_pushWaitersCount;
+                    recordPushBlocked(waitStart);
+                    if (!hasRoom)
+                    {
+                        break;
+                    }
+                    continue;
+                }
+                if (itemsPushed == items.size())
+                {
+                    const std::size_t wrapCount = m_capacity == 0 ? unwrappedCount : std::min(unwrappedCount, m_capacity - m_adapter.size());
+                    lock.unlock();
+                    items.clear();
+                    itemsPushed = 0;
+                    for (std::size_t i = 0; i < wrapCount; ++i, ++unwrapped)
+                    {
+                        items.push_back(std::allocate_shared<Elem>(m_elemAllocator, std::move_if_noexcept(*unwrapped)));
+                    }
+                    unwrappedCount -= wrapCount;
+                    lock.lock();
+                    // Others may have pushed or closed meanwhile.
+                    continue;
+                }
+                const std::size_t room = m_capacity == 0 ? items.size() - itemsPushed : m_capacity - m_adapter.size();
+                for (const std::size_t end = std::min(items.size(), itemsPushed + room); itemsPushed != end; ++itemsPushed, ++pushedCount)
+                {
+                    m_adapter.push(std::move(items[itemsPushed]));
+                    recordPush();
+                }
+            }
+            hasWaiters = m_waitersCount != 0;
+        }
+        // Wrapped elements which weren't pushed go back to their places.
+        std::advance(first, static_cast<std::ptrdiff_t>(pushedCount));
+        ForwardIt it = first;
+        for (; itemsPushed != items.size(); ++itemsPushed, ++it)
+        {
+            *it = std::move_if_noexcept(*items[itemsPushed]);
+        }
+        if (hasWaiters && pushedCount != 0)
+        {
+            m_condVar.notify_all();
+        }
+        if (closed)
+        {
+            throw ClosedAdapter{};
+        }
+        return first;
+    }
+
+    template<template<typename...> typename Adapt,
+        typename AdaptElem, template<typename...> typename Cont,
+        typename ContElem, template<typename> typename Alloc,
+        typename AllocElem, typename... Ts>
+    void ThreadSafeSTLAdapter<Adapt, AdaptElem, Cont, ContElem, Alloc, AllocElem, Ts...>::setCapacity(const std::size_t capacity)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_capacity = capacity;
+        }
+        m_notFullCondVar.notify_all();
+    }
+
+    template<template<typename...> typename Adapt,
+        typename AdaptElem, template<typename...> typename Cont,
+        typename ContElem, template<typename> typename Alloc,
+        typename AllocElem, typename... Ts>
+    std::size_t ThreadSafeSTLAdapter<Adapt, AdaptElem, Cont, ContElem, Alloc, AllocElem, Ts...>::getCapacity()
+    {
         std::lock_guard<std::mutex> lock(m_mutex);
-        m_adapter.push(std::move(item));
+        return m_capacity;
+    }
+
+    template<template<typename...> typename Adapt,
+        typename AdaptElem, template<typename...> typename Cont,
+        typename ContElem, template<typename> typename Alloc,
+        typename AllocElem, typename... Ts>
+    void ThreadSafeSTLAdapter<Adapt, AdaptElem, Cont, ContElem, Alloc, AllocElem, Ts...>::recordPushBlocked(const std::chrono::steady_clock::time_point waitStart)
+    {
+        if (m_recordStatistics)
+        {
+            const std::chrono::nanoseconds blocked = std::chrono::steady_clock::now() - waitStart;
+            Statistics::record(Statistics::Distribution::PushBlockedNs, static_cast<std::uint64_t>(blocked.count()));
+        }
+    }
+
+    template<template<typename...> typename Adapt,
+        typename AdaptElem, template<typename...> typename Cont,
+        typename ContElem, template<typename> typename Alloc,
+        typename AllocElem, typename... Ts>
+    void ThreadSafeSTLAdapter<Adapt, AdaptElem, Cont, ContElem, Alloc, AllocElem, Ts...>::notifyPusher()
+    {
+        if (m_pushWaitersCount != 0)
+        {
+            m_notFullCondVar.notify_one();
+        }
     }
 
     template<template<typename...> typename Adapt,
@@ -199,9 +550,13 @@ namespace mt
     void ThreadSafeSTLAdapter<Adapt, AdaptElem, Cont, ContElem, Alloc, AllocElem, Ts...>::waitAndPop(Elem& value)
     {
         std::unique_lock<std::mutex> lock(m_mutex);
+        ++m_waitersCount;
         m_condVar.wait(lock, [&] { return !m_adapter.empty(); });
+        --m_waitersCount;
         value = std::move_if_noexcept(*getCurrent<Adapt<AdaptElem, Cont<ContElem, Alloc<AllocElem>>, Ts...>>(m_adapter));
+        recordPop();
         m_adapter.pop();
+        notifyPusher();
     }
 
     template<template<typename...> typename Adapt,
@@ -212,9 +567,13 @@ namespace mt
         ThreadSafeSTLAdapter<Adapt, AdaptElem, Cont, ContElem, Alloc, AllocElem, Ts...>::waitAndPop()
     {
         std::unique_lock<std::mutex> lock(m_mutex);
+        ++m_waitersCount;
         m_condVar.wait(lock, [&] { return !m_adapter.empty(); });
+        --m_waitersCount;
         std::shared_ptr<Elem> res = std::move(getCurrent<Adapt<AdaptElem, Cont<ContElem, Alloc<AllocElem>>, Ts...>>(m_adapter));
+        recordPop();
         m_adapter.pop();
+        notifyPusher();
         return res;
     }
 
@@ -230,7 +589,9 @@ namespace mt
             return false;
         }
         value = std::move_if_noexcept(*getCurrent<Adapt<AdaptElem, Cont<ContElem, Alloc<AllocElem>>, Ts...>>(m_adapter));
+        recordPop();
         m_adapter.pop();
+        notifyPusher();
         return true;
     }
 
@@ -247,10 +608,96 @@ namespace mt
             return std::shared_ptr<Elem>{};
         }
         std::shared_ptr<Elem> res = std::move(getCurrent<Adapt<AdaptElem, Cont<ContElem, Alloc<AllocElem>>, Ts...>>(m_adapter));
+        recordPop();
         m_adapter.pop();
+        notifyPusher();
         return res;
     }
 
+    template<template<typename...> typename Adapt,
+        typename AdaptElem, template<typename...> typename Cont,
+        typename ContElem, template<typename> typename Alloc,
+        typename AllocElem, typename... Ts>
+    std::size_t ThreadSafeSTLAdapter<Adapt, AdaptElem, Cont, ContElem, Alloc, AllocElem, Ts...>::tryPopBulk(std::vector<Elem>& out, const std::size_t maxCount)
+    {
+        // Reserved before locking, so the lock isn't held during an allocation.
+        out.reserve(out.size() + maxCount);
+        std::size_t poppedCount = 0;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (; poppedCount != maxCount && !m_adapter.empty(); ++poppedCount)
+        {
+            out.push_back(std::move_if_noexcept(*getCurrent<Adapt<AdaptElem, Cont<ContElem, Alloc<AllocElem>>, Ts...>>(m_adapter)));
+            recordPop();
+            m_adapter.pop();
+        }
+        if (poppedCount != 0 && m_pushWaitersCount != 0)
+        {
+            m_notFullCondVar.notify_all();
+        }
+        return poppedCount;
+    }
+
+    template<template<typename...> typename Adapt,
+        typename AdaptElem, template<typename...> typename Cont,
+        typename ContElem, template<typename> typename Alloc,
+        typename AllocElem, typename... Ts>
+    template<typename Rep, typename Period, typename Predicate>
+    void ThreadSafeSTLAdapter<Adapt, AdaptElem, Cont, ContElem, Alloc, AllocElem, Ts...>::
+        waitFor(const std::chrono::duration<Rep, Period>& timeout, Predicate stopWaiting)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        ++m_waitersCount;
+        m_condVar.wait_for(lock, timeout, [&] { return !m_adapter.empty() || m_closed || stopWaiting(); });
+        --m_waitersCount;
+    }
+
+    template<template<typename...> typename Adapt,
+        typename AdaptElem, template<typename...> typename Cont,
+        typename ContElem, template<typename> typename Alloc,
+        typename AllocElem, typename... Ts>
+    void ThreadSafeSTLAdapter<Adapt, AdaptElem, Cont, ContElem, Alloc, AllocElem, Ts...>::notifyAll()
+    {
+        {
+            // Orders the notification after a waiter has evaluated its predicate.
+            std::lock_guard<std::mutex> lock(m_mutex);
+        }
+        m_condVar.notify_all();
+    }
+
+    template<template<typename...> typename Adapt,
+        typename AdaptElem, template<typename...> typename Cont,
+        typename ContElem, template<typename> typename Alloc,
+        typename AllocElem, typename... Ts>
+    void ThreadSafeSTLAdapter<Adapt, AdaptElem, Cont, ContElem, Alloc, AllocElem, Ts...>::close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_closed = true;
+        }
+        m_condVar.notify_all();
+        m_notFullCondVar.notify_all();
+    }
+
+    template<template<typename...> typename Adapt,
+        typename AdaptElem, template<typename...> typename Cont,
+        typename ContElem, template<typename> typename Alloc,
+        typename AllocElem, typename... Ts>
+    bool ThreadSafeSTLAdapter<Adapt, AdaptElem, Cont, ContElem, Alloc, AllocElem, Ts...>::isClosed()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_closed;
+    }
+
+    template<template<typename...> typename Adapt,
+        typename AdaptElem, template<typename...> typename Cont,
+        typename ContElem, template<typename> typename Alloc,
+        typename AllocElem, typename... Ts>
+    bool ThreadSafeSTLAdapter<Adapt, AdaptElem, Cont, ContElem, Alloc, AllocElem, Ts...>::isDrained()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_closed && m_adapter.empty();
+    }
+
     template<template<typename...> typename Adapt,
         typename AdaptElem, template<typename...> typename Cont,
         typename ContElem, template<typename> typename Alloc,
@@ -263,7 +710,9 @@ namespace mt
             throw EmptyAdapter{};
         }
         value = std::move_if_noexcept(*getCurrent<Adapt<AdaptElem, Cont<ContElem, Alloc<AllocElem>>, Ts...>>(m_adapter));
+        recordPop();
         m_adapter.pop();
+        notifyPusher();
     }
 
     template<template<typename...> typename Adapt,
@@ -279,7 +728,9 @@ namespace mt
             throw EmptyAdapter{};
         }
         std::shared_ptr<Elem> res = std::move(getCurrent<Adapt<AdaptElem, Cont<ContElem, Alloc<AllocElem>>, Ts...>>(m_adapter));
+        recordPop();
         m_adapter.pop();
+        notifyPusher();
         return res;
     }
 
@@ -293,6 +744,57 @@ namespace mt
         {
             std::scoped_lock lock(m_mutex, rhs.m_mutex);
             std::swap(m_adapter, rhs.m_adapter);
+            std::swap(m_capacity, rhs.m_capacity);
+            std::swap(m_recordStatistics, rhs.m_recordStatistics);
+            std::swap(m_pushTimes, rhs.m_pushTimes);
+        }
+    }
+
+    template<template<typename...> typename Adapt,
+        typename AdaptElem, template<typename...> typename Cont,
+        typename ContElem, template<typename> typename Alloc,
+        typename AllocElem, typename... Ts>
+    void ThreadSafeSTLAdapter<Adapt, AdaptElem, Cont, ContElem, Alloc, AllocElem, Ts...>::enableStatistics()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_recordStatistics = true;
+    }
+
+    template<template<typename...> typename Adapt,
+        typename AdaptElem, template<typename...> typename Cont,
+        typename ContElem, template<typename> typename Alloc,
+        typename AllocElem, typename... Ts>
+    void ThreadSafeSTLAdapter<Adapt, AdaptElem, Cont, ContElem, Alloc, AllocElem, Ts...>::recordPush()
+    {
+        if (!m_recordStatistics || !Statistics::isEnabled())
+        {
+            return;
+        }
+        // Stacks and priority queues (they have top()) don't pop in push order, their waits are not known.
+        if constexpr (!detectTopMethod<Adapt<AdaptElem, Cont<ContElem, Alloc<AllocElem>>, Ts...>>())
+        {
+            m_pushTimes.push_back(std::chrono::steady_clock::now());
+        }
+        Statistics::add(Statistics::Counter::SharedContainerPushes);
+        Statistics::updateSharedContainerHighWaterMark(m_adapter.size());
+    }
+
+    template<template<typename...> typename Adapt,
+        typename AdaptElem, template<typename...> typename Cont,
+        typename ContElem, template<typename> typename Alloc,
+        typename AllocElem, typename... Ts>
+    void ThreadSafeSTLAdapter<Adapt, AdaptElem, Cont, ContElem, Alloc, AllocElem, Ts...>::recordPop()
+    {
+        // Elements pushed before recording has started have no push time, they are the oldest ones.
+        if (!m_pushTimes.empty() && m_pushTimes.size() == m_adapter.size())
+        {
+            const std::chrono::nanoseconds wait = std::chrono::steady_clock::now() - m_pushTimes.front();
+            m_pushTimes.pop_front();
+            Statistics::record(Statistics::Distribution::QueueWaitNs, static_cast<std::uint64_t>(wait.count()));
+        }
+        if (m_recordStatistics)
+        {
+            Statistics::add(Statistics::Counter::SharedContainerPops);
         }
     }
 
@@ -350,24 +852,27 @@ namespace mt
     [[nodiscard]] auto createThreadSafeSTLAdapterFrom(const Adapt<AdaptElem, Cont<ContElem, Alloc<AllocElem>>, Ts...>& adapter, Ts... comparator)
     {
         auto& underlyingContainer = getProtectedContainer(adapter);
+        // The container's allocator allocates the new container and the elements (see PoolAllocator).
+        const Alloc<std::shared_ptr<AllocElem>> allocator(underlyingContainer.get_allocator());
+        const typename std::allocator_traits<Alloc<AllocElem>>::template rebind_alloc<AdaptElem> elemAllocator(underlyingContainer.get_allocator());
         if constexpr (sizeof...(Ts) == 1)
         {
             // std::priority_queue
             Adapt<std::shared_ptr<AdaptElem>, Cont<std::shared_ptr<ContElem>, Alloc<std::shared_ptr<AllocElem>>>, CustomComparator<Ts...>>
-                adapterWithSharedPtrElements{ CustomComparator{std::move(comparator...)} };
+                adapterWithSharedPtrElements{ CustomComparator{std::move(comparator...)}, allocator };
             auto& underlyingSharedPtrContainer = getProtectedContainer(adapterWithSharedPtrElements);
             std::transform(underlyingContainer.cbegin(), underlyingContainer.cend(), std::back_inserter(underlyingSharedPtrContainer),
-                [](auto& item) { return std::make_shared<AdaptElem>(item); });
+                [&](auto& item) { return std::allocate_shared<AdaptElem>(elemAllocator, item); });
             return ThreadSafeSTLAdapter{ std::move(adapterWithSharedPtrElements) };
         }
         if constexpr (sizeof...(Ts) == 0)
         {
             // std::stack / std::queue
             Adapt<std::shared_ptr<AdaptElem>, Cont<std::shared_ptr<ContElem>, Alloc<std::shared_ptr<AllocElem>>>>
-                adapterWithSharedPtrElements{ };
+                adapterWithSharedPtrElements{ allocator };
             auto& underlyingSharedPtrContainer = getProtectedContainer(adapterWithSharedPtrElements);
             std::transform(underlyingContainer.cbegin(), underlyingContainer.cend(), std::back_inserter(underlyingSharedPtrContainer),
-                [](auto& item) { return std::make_shared<AdaptElem>(item); });
+                [&](auto& item) { return std::allocate_shared<AdaptElem>(elemAllocator, item); });
             return ThreadSafeSTLAdapter{ std::move(adapterWithSharedPtrElements) };
         }
     }
@@ -379,24 +884,27 @@ namespace mt
     [[nodiscard]] auto createThreadSafeSTLAdapterFrom(Adapt<AdaptElem, Cont<ContElem, Alloc<AllocElem>>, Ts...>&& adapter, Ts... comparator)
     {
         auto& underlyingContainer = getProtectedContainer(adapter);
+        // The container's allocator allocates the new container and the elements (see PoolAllocator).
+        const Alloc<std::shared_ptr<AllocElem>> allocator(underlyingContainer.get_allocator());
+        const typename std::allocator_traits<Alloc<AllocElem>>::template rebind_alloc<AdaptElem> elemAllocator(underlyingContainer.get_allocator());
         if constexpr (sizeof...(Ts) == 1)
         {
             // std::priority_queue
             Adapt<std::shared_ptr<AdaptElem>, Cont<std::shared_ptr<ContElem>, Alloc<std::shared_ptr<AllocElem>>>, CustomComparator<Ts...>>
-                adapterWithSharedPtrElements{ CustomComparator{std::move(comparator...)} };
+                adapterWithSharedPtrElements{ CustomComparator{std::move(comparator...)}, allocator };
             auto& underlyingSharedPtrContainer = getProtectedContainer(adapterWithSharedPtrElements);
             std::transform(underlyingContainer.begin(), underlyingContainer.end(), std::back_inserter(underlyingSharedPtrContainer),
-                [](auto& item) { return std::make_shared<AdaptElem>(std::move(item)); });
+                [&](auto& item) { return std::allocate_shared<AdaptElem>(elemAllocator, std::move(item)); });
             return ThreadSafeSTLAdapter{ std::move(adapterWithSharedPtrElements) };
         }
         if constexpr (sizeof...(Ts) == 0)
         {
             // std::stack / std::queue
             Adapt<std::shared_ptr<AdaptElem>, Cont<std::shared_ptr<ContElem>, Alloc<std::shared_ptr<AllocElem>>>>
-                adapterWithSharedPtrElements{ };
+                adapterWithSharedPtrElements{ allocator };
             auto& underlyingSharedPtrContainer = getProtectedContainer(adapterWithSharedPtrElements);
             std::transform(underlyingContainer.begin(), underlyingContainer.end(), std::back_inserter(underlyingSharedPtrContainer),
-                [](auto& item) { return std::make_shared<AdaptElem>(std::move(item)); });
+                [&](auto& item) { return std::allocate_shared<AdaptElem>(elemAllocator, std::move(item)); });
             return ThreadSafeSTLAdapter{ std::move(adapterWithSharedPtrElements) };
         }
     }
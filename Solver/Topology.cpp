@@ -0,0 +1,340 @@
+/**
+ * @file Topology.cpp
+ *
+ * @brief Topology class for NUMA nodes and CPUs of the machine, thread pinning and node-local memory.
+ *
+ * @author Hovsep Papoyan
+ * Contact: papoyanhovsep93@gmail.com
+ * @Date 2024-03-28
+ *
+ */
+
+#include "Topology.h"
+
+#include <algorithm>
+#include <new>
+#include <thread>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#endif
+
+namespace mt
+{
+    namespace
+    {
+        // All CPUs in one node, used when the OS tells nothing about NUMA.
+        [[nodiscard]] Topology::Node getSingleNode()
+        {
+            const std::size_t cpusCount = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+            Topology::Node node{ 0, {} };
+            for (std::size_t cpu = 0; cpu < cpusCount; ++cpu)
+            {
+                node.m_cpus.push_back(cpu);
+            }
+            return node;
+        }
+
+#ifndef _WIN32
+        // Parses kernel CPU lists like "0-3,8,10-11".
+        [[nodiscard]] std::vector<std::size_t> parseCpuList(const std::string& list)
+        {
+            std::vector<std::size_t> cpus;
+            std::size_t position = 0;
+            while (position < list.size())
+            {
+                std::size_t end = list.find(',', position);
+                if (end == std::string::npos)
+                {
+                    end = list.size();
+                }
+                const std::string range = list.substr(position, end - position);
+                const std::size_t dash = range.find('-');
+                try
+                {
+                    const std::size_t first = std::stoul(range.substr(0, dash));
+                    const std::size_t last = dash == std::string::npos ? first : std::stoul(range.substr(dash + 1));
+                    for (std::size_t cpu = first; cpu <= last; ++cpu)
+                    {
+                        cpus.push_back(cpu);
+                    }
+                }
+                catch (const std::exception&)
+                {
+                    // Malformed ranges (e.g. the trailing newline) are skipped.
+                }
+                position = end + 1;
+            }
+            return cpus;
+        }
+#endif
+    } // namespace
+
+    Topology::Topology(std::vector<Node> nodes)
+        : m_nodes(std::move(nodes))
+    {
+        std::erase_if(m_nodes, [](const Node& node) { return node.m_cpus.empty(); });
+        if (m_nodes.empty())
+        {
+            m_nodes.push_back(getSingleNode());
+        }
+        std::ranges::sort(m_nodes, {}, &Node::m_id);
+    }
+
+    const Topology& Topology::get()
+    {
+        static const Topology topology = detect();
+        return topology;
+    }
+
+    std::size_t Topology::getCpusCount() const noexcept
+    {
+        std::size_t count = 0;
+        for (const Node& node : m_nodes)
+        {
+            count += node.m_cpus.size();
+        }
+        return count;
+    }
+
+    std::ostream& operator<<(std::ostream& os, const Topology& topology)
+    {
+        os << topology.getNodesCount() << (topology.getNodesCount() == 1 ? " node" : " nodes");
+        for (const Topology::Node& node : topology.getNodes())
+        {
+            os << ", node " << node.m_id << ": cpus ";
+            // Consecutive CPUs are printed as ranges.
+            for (std::size_t i = 0; i < node.m_cpus.size(); )
+            {
+                std::size_t last = i;
+                while (last + 1 < node.m_cpus.size() && node.m_cpus[last + 1] == node.m_cpus[last] + 1)
+                {
+                    ++last;
+                }
+                os << (i != 0 ? "," : "") << node.m_cpus[i];
+                if (last != i)
+                {
+                    os << '-' << node.m_cpus[last];
+                }
+                i = last + 1;
+            }
+        }
+        return os;
+    }
+
+#ifdef _WIN32
+
+    Topology Topology::detect()
+    {
+        DWORD length = 0;
+        GetLogicalProcessorInformationEx(RelationNumaNode, nullptr, &length);
+        std::vector<char> buffer(length);
+        if (length == 0 || !GetLogicalProcessorInformationEx(RelationNumaNode,
+            reinterpret_cast<SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.data()), &length))
+        {
+            return Topology({});
+        }
+
+        std::vector<Node> nodes;
+        for (DWORD offset = 0; offset < length; )
+        {
+            const auto& info = *reinterpret_cast<const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.data() + offset);
+            const GROUP_AFFINITY& groupMask = info.NumaNode.GroupMask;
+            Node node{ info.NumaNode.NodeNumber, {} };
+            for (std::size_t bit = 0; bit < sizeof(KAFFINITY) * 8; ++bit)
+            {
+                if ((groupMask.Mask >> bit) & 1)
+                {
+                    node.m_cpus.push_back(static_cast<std::size_t>(groupMask.Group) * 64 + bit);
+                }
+            }
+            nodes.push_back(std::move(node));
+            offset += info.Size;
+        }
+        return Topology(std::move(nodes));
+    }
+
+    bool Topology::pinCurrentThreadToCpu(const std::size_t cpu)
+    {
+        GROUP_AFFINITY affinity{};
+        affinity.Group = static_cast<WORD>(cpu / 64);
+        affinity.Mask = static_cast<KAFFINITY>(1) << (cpu % 64);
+        return SetThreadGroupAffinity(GetCurrentThread(), &affinity, nullptr) != 0;
+    }
+
+    bool Topology::pinCurrentThreadToNode(const std::size_t nodeIndex) const
+    {
+        // A thread can run in one processor group only, the group of the node's first CPU is taken.
+        const std::vector<std::size_t>& cpus = m_nodes[nodeIndex].m_cpus;
+        GROUP_AFFINITY affinity{};
+        affinity.Group = static_cast<WORD>(cpus.front() / 64);
+        for (const std::size_t cpu : cpus)
+        {
+            if (cpu / 64 == affinity.Group)
+            {
+                affinity.Mask |= static_cast<KAFFINITY>(1) << (cpu % 64);
+            }
+        }
+        return SetThreadGroupAffinity(GetCurrentThread(), &affinity, nullptr) != 0;
+    }
+
+    PageBuffer::PageBuffer(const std::size_t bytes)
+    {
+        if (bytes == 0)
+        {
+            return;
+        }
+        m_data = VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+        if (m_data == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        m_size = bytes;
+    }
+
+    void PageBuffer::release() noexcept
+    {
+        if (m_data != nullptr)
+        {
+            VirtualFree(m_data, 0, MEM_RELEASE);
+        }
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+#else
+
+    Topology Topology::detect()
+    {
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        const bool hasAllowed = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+        const auto isAllowed = [&](const std::size_t cpu)
+            {
+                return !hasAllowed || (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed));
+            };
+
+        std::vector<Node> nodes;
+        std::error_code error;
+        for (const auto& entry : std::filesystem::directory_iterator("/sys/devices/system/node", error))
+        {
+            const std::string name = entry.path().filename().string();
+            if (name.size() <= 4 || name.compare(0, 4, "node") != 0
+                || !std::all_of(name.begin() + 4, name.end(), [](const char ch) { return ch >= '0' && ch <= '9'; }))
+            {
+                continue;
+            }
+            std::ifstream cpuList(entry.path() / "cpulist");
+            std::string list;
+            std::getline(cpuList, list);
+            Node node{ std::stoul(name.substr(4)), {} };
+            for (const std::size_t cpu : parseCpuList(list))
+            {
+                if (isAllowed(cpu))
+                {
+                    node.m_cpus.push_back(cpu);
+                }
+            }
+            nodes.push_back(std::move(node));
+        }
+
+        if (nodes.empty() && hasAllowed)
+        {
+            // No sysfs (e.g. a container), the allowed CPUs form one node.
+            Node node{ 0, {} };
+            for (std::size_t cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+            {
+                if (CPU_ISSET(cpu, &allowed))
+                {
+                    node.m_cpus.push_back(cpu);
+                }
+            }
+            nodes.push_back(std::move(node));
+        }
+        return Topology(std::move(nodes));
+    }
+
+    bool Topology::pinCurrentThreadToCpu(const std::size_t cpu)
+    {
+        if (cpu >= CPU_SETSIZE)
+        {
+            return false;
+        }
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+    }
+
+    bool Topology::pinCurrentThreadToNode(const std::size_t nodeIndex) const
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (const std::size_t cpu : m_nodes[nodeIndex].m_cpus)
+        {
+            if (cpu < CPU_SETSIZE)
+            {
+                CPU_SET(cpu, &set);
+            }
+        }
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+    }
+
+    PageBuffer::PageBuffer(const std::size_t bytes)
+    {
+        if (bytes == 0)
+        {
+            return;
+        }
+        void* const address = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (address == MAP_FAILED)
+        {
+            throw std::bad_alloc();
+        }
+        m_data = address;
+        m_size = bytes;
+    }
+
+    void PageBuffer::release() noexcept
+    {
+        if (m_data != nullptr)
+        {
+            munmap(m_data, m_size);
+        }
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+#endif
+
+    PageBuffer::PageBuffer(PageBuffer&& rhs) noexcept
+        : m_data(std::exchange(rhs.m_data, nullptr))
+        , m_size(std::exchange(rhs.m_size, 0))
+    { }
+
+    PageBuffer& PageBuffer::operator=(PageBuffer&& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            release();
+            m_data = std::exchange(rhs.m_data, nullptr);
+            m_size = std::exchange(rhs.m_size, 0);
+        }
+        return *this;
+    }
+
+    PageBuffer::~PageBuffer()
+    {
+        release();
+    }
+} // namespace mt
@@ -0,0 +1,85 @@
+/**
+ * @file Topology.h
+ *
+ * @brief Topology class for NUMA nodes and CPUs of the machine, thread pinning and node-local memory.
+ *
+ * @author Hovsep Papoyan
+ * Contact: papoyanhovsep93@gmail.com
+ * @Date 2024-03-28
+ *
+ */
+
+#ifndef TOPOLOGY_H
+#define TOPOLOGY_H
+
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+namespace mt
+{
+    // NUMA nodes of the machine and the logical CPUs of every node, as the OS reports them.
+    // CPU ids are global: processor group * 64 + number in the group on Windows, kernel CPU numbers on Linux.
+    // Only CPUs the process is allowed to run on are listed, nodes without such CPUs are omitted.
+    class Topology
+    {
+    public:
+        struct Node
+        {
+            std::size_t m_id; // Id of the node in the OS.
+            std::vector<std::size_t> m_cpus;
+        };
+
+    private:
+        std::vector<Node> m_nodes;
+
+    public:
+        // At least one node with at least one CPU, empty or invalid nodes are dropped.
+        explicit Topology(std::vector<Node> nodes);
+
+        // Detected once, on first use. A single node with all CPUs if the OS has no NUMA information.
+        [[nodiscard]] static const Topology& get();
+
+        [[nodiscard]] const std::vector<Node>& getNodes() const noexcept { return m_nodes; }
+        [[nodiscard]] std::size_t getNodesCount() const noexcept { return m_nodes.size(); }
+        [[nodiscard]] std::size_t getCpusCount() const noexcept;
+
+        // Restrict the calling thread to one CPU or to all CPUs of m_nodes[nodeIndex]. Return false if the OS refused.
+        static bool pinCurrentThreadToCpu(const std::size_t cpu);
+        bool pinCurrentThreadToNode(const std::size_t nodeIndex) const;
+
+    private:
+        [[nodiscard]] static Topology detect();
+    };
+
+    // E.g. "2 nodes, node 0: cpus 0-15, node 1: cpus 16-31".
+    std::ostream& operator<<(std::ostream& os, const Topology& topology);
+
+    // Memory taken directly from the OS, its pages stay untouched until they are written.
+    // Both Windows and Linux place a page on the NUMA node of the thread that touches it first,
+    // So every part of the buffer ends up local to the (pinned) thread that fills it.
+    class PageBuffer
+    {
+    private:
+        void* m_data = nullptr;
+        std::size_t m_size = 0;
+
+    public:
+        PageBuffer() = default;
+        // Throws std::bad_alloc if the OS can't provide the memory.
+        explicit PageBuffer(const std::size_t bytes);
+        PageBuffer(const PageBuffer&) = delete;
+        PageBuffer(PageBuffer&& rhs) noexcept;
+        PageBuffer& operator=(const PageBuffer&) = delete;
+        PageBuffer& operator=(PageBuffer&& rhs) noexcept;
+        ~PageBuffer();
+
+        [[nodiscard]] void* data() const noexcept { return m_data; }
+        [[nodiscard]] std::size_t size() const noexcept { return m_size; }
+
+    private:
+        void release() noexcept;
+    };
+} // namespace mt
+
+#endif
@@ -0,0 +1,76 @@
+/**
+ * @file WaitPolicy.h
+ *
+ * @brief Waiting strategies of Producer and Consumer worker threads for an empty container.
+ *
+ *        A policy gets two callables: tryFn() attempts to take work and returns true on success,
+ *        parkFn(timeout) blocks until the container gets an element, the worker is interrupted or timeout expires.
+ *        wait() returns true if tryFn() has succeeded, false if the caller should check its state and call again.
+ *
+ * @author Hovsep Papoyan
+ * Contact: papoyanhovsep93@gmail.com
+ * @Date 2024-03-28
+ *
+ */
+
+#ifndef WAIT_POLICY_H
+#define WAIT_POLICY_H
+
+#include <chrono>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+namespace mt
+{
+    // Hints the CPU that the thread is busy-waiting (lets the sibling hyper-thread run, saves power).
+    inline void cpuRelax() noexcept
+    {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+        _mm_pause();
+#else
+        std::this_thread::yield();
+#endif
+    }
+
+    // Polls and yields when there is nothing to do. Lowest latency, but an idle worker burns a whole core.
+    struct YieldWaitPolicy
+    {
+        template<typename TryFn, typename ParkFn>
+        [[nodiscard]] bool wait(TryFn&& tryFn, ParkFn&&) const
+        {
+            if (tryFn())
+            {
+                return true;
+            }
+            std::this_thread::yield();
+            return false;
+        }
+    };
+
+    // Spins SpinCount times (work usually arrives quickly when the pipeline is busy),
+    // Then parks the thread until a push wakes it. Idle workers use almost no CPU.
+    // ParkTimeoutMs is only a safety net, wakeups are delivered by the container.
+    template<unsigned SpinCount = 1024, unsigned ParkTimeoutMs = 1000>
+    struct SpinThenParkWaitPolicy
+    {
+        template<typename TryFn, typename ParkFn>
+        [[nodiscard]] bool wait(TryFn&& tryFn, ParkFn&& parkFn) const
+        {
+            for (unsigned i = 0; i < SpinCount; ++i)
+            {
+                if (tryFn())
+                {
+                    return true;
+                }
+                cpuRelax();
+            }
+            parkFn(std::chrono::milliseconds(ParkTimeoutMs));
+            return tryFn();
+        }
+    };
+} // namespace mt
+
+#endif
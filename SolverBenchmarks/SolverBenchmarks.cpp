@@ -0,0 +1,695 @@
+/**
+ * @file SolverBenchmarks.cpp
+ *
+ * @brief Microbenchmarks for hot paths of Solver project: parsing, solving, thread-safe adapters and producer-consumer handoff.
+ *
+ * @author Hovsep Papoyan
+ * Contact: papoyanhovsep93@gmail.com
+ * @Date 2024-03-28
+ *
+ */
+
+#include "../Solver/CoefficientsView.h"
+#include "../Solver/Consumer.h"
+#include "../Solver/ConsumerPool.h"
+#include "../Solver/InputValidator.h"
+#include "../Solver/NodePool.h"
+#include "../Solver/ParallelSolver.h"
+#include "../Solver/PolynomialSolver.h"
+#include "../Solver/Producer.h"
+#include "../Solver/Solver.h"
+#include "../Solver/ThreadPool.h"
+#include "../Solver/ThreadSafeSTLAdapter.h"
+#include "../Solver/Topology.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// Usage: SolverBenchmarks [--quick] [--filter <name>]
+// Every result is printed as one JSON object per line (JSON Lines), e.g.
+// {"benchmark":"solve","case":"two_roots","iterations":16777216,"ns_per_op_median":3.1,"ns_per_op_min":3.0}
+// --quick shortens every measurement (smoke runs), --filter runs only benchmarks whose name contains <name>.
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct Options
+    {
+        bool m_quick = false;
+        std::string_view m_filter;
+    };
+
+    // Keeps the compiler from optimizing value (and the computation behind it) away.
+    template<typename T>
+    void doNotOptimize(const T& value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static const volatile void* sink;
+        sink = &value;
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+    }
+
+    // One output line. Fields are printed in the given order.
+    class Record
+    {
+    private:
+        using Value = std::variant<std::string, double, std::uint64_t>;
+        std::vector<std::pair<std::string, Value>> m_fields;
+
+    public:
+        explicit Record(const std::string_view benchmark)
+        {
+            add("benchmark", std::string(benchmark));
+        }
+
+        Record& add(const std::string_view name, Value value)
+        {
+            m_fields.emplace_back(std::string(name), std::move(value));
+            return *this;
+        }
+
+        void print() const
+        {
+            std::ostringstream line;
+            line << '{';
+            for (std::size_t i = 0; i < m_fields.size(); ++i)
+            {
+                line << (i != 0 ? "," : "") << '"' << m_fields[i].first << "\":";
+                if (const std::string* text = std::get_if<std::string>(&m_fields[i].second))
+                {
+                    // Names and descriptions never contain quotes or backslashes.
+                    line << '"' << *text << '"';
+                }
+                else if (const double* number = std::get_if<double>(&m_fields[i].second))
+                {
+                    line << *number;
+                }
+                else
+                {
+                    line << std::get<std::uint64_t>(m_fields[i].second);
+                }
+            }
+            line << '}';
+            std::cout << line.str() << std::endl;
+        }
+    };
+
+    struct Timing
+    {
+        std::uint64_t m_iterations;
+        double m_nsPerOpMedian;
+        double m_nsPerOpMin;
+    };
+
+    // Runs body(iterations) with a doubling count of iterations until one run takes minTime,
+    // Then repeats that run and reports the median and the minimum time per iteration.
+    template<typename Body>
+    [[nodiscard]] Timing measure(const Options& options, Body&& body)
+    {
+        const std::chrono::nanoseconds minTime = options.m_quick ? std::chrono::milliseconds(5) : std::chrono::milliseconds(100);
+        const int repetitions = options.m_quick ? 1 : 5;
+
+        std::uint64_t iterations = 1;
+        while (true)
+        {
+            const Clock::time_point start = Clock::now();
+            body(iterations);
+            if (Clock::now() - start >= minTime || iterations >= (std::uint64_t(1) << 40))
+            {
+                break;
+            }
+            iterations *= 2;
+        }
+
+        std::vector<double> nsPerOp;
+        for (int i = 0; i < repetitions; ++i)
+        {
+            const Clock::time_point start = Clock::now();
+            body(iterations);
+            const std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+            nsPerOp.push_back(elapsed.count() / static_cast<double>(iterations));
+        }
+        std::ranges::sort(nsPerOp);
+        return Timing{ iterations, nsPerOp[nsPerOp.size() / 2], nsPerOp.front() };
+    }
+
+    // 1, 2, 4, ..., and maxCount itself.
+    [[nodiscard]] std::vector<std::size_t> getThreadCounts(const std::size_t maxCount)
+    {
+        std::vector<std::size_t> counts;
+        for (std::size_t count = 1; count < maxCount; count *= 2)
+        {
+            counts.push_back(count);
+        }
+        counts.push_back(std::max<std::size_t>(maxCount, 1));
+        return counts;
+    }
+
+    [[nodiscard]] std::size_t getHardwareThreads()
+    {
+        return std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    }
+
+    void benchmarkContext()
+    {
+        std::ostringstream topology;
+        topology << mt::Topology::get();
+        Record("context")
+            .add("hardware_threads", static_cast<std::uint64_t>(getHardwareThreads()))
+            .add("topology", topology.str())
+            .add("float_bytes", static_cast<std::uint64_t>(sizeof(slv::Solver::Float)))
+            .add("kernel", std::string(slv::getBatchKernelName(slv::getBatchKernel())))
+#if defined(__clang__)
+            .add("compiler", "clang " __clang_version__)
+#elif defined(__GNUC__)
+            .add("compiler", "gcc " __VERSION__)
+#elif defined(_MSC_VER)
+            .add("compiler", "msvc " + std::to_string(_MSC_VER))
+#endif
+            .print();
+    }
+
+    // Solver::solve per call, for each kind of result.
+    void benchmarkSolve(const Options& options)
+    {
+        struct Case
+        {
+            std::string_view m_name;
+            int m_a;
+            int m_b;
+            int m_c;
+        };
+        static constexpr Case cases[]{
+            { "linear", 0, 2, 4 },
+            { "no_real_roots", 1, 0, 1 },
+            { "two_roots", 1, 2, -3 }
+        };
+        for (const Case& testCase : cases)
+        {
+            // Volatile inputs, so that the result can't be computed at compile time.
+            volatile int a = testCase.m_a;
+            volatile int b = testCase.m_b;
+            volatile int c = testCase.m_c;
+            const Timing timing = measure(options, [&](const std::uint64_t iterations)
+                {
+                    for (std::uint64_t i = 0; i < iterations; ++i)
+                    {
+                        const slv::Solver::Result result = slv::Solver::solve(a, b, c);
+                        doNotOptimize(result);
+                    }
+                });
+            Record("solve")
+                .add("case", std::string(testCase.m_name))
+                .add("iterations", timing.m_iterations)
+                .add("ns_per_op_median", timing.m_nsPerOpMedian)
+                .add("ns_per_op_min", timing.m_nsPerOpMin)
+                .print();
+        }
+    }
+
+    // BasicSolver<double>::solveBatch per equation, for every kernel this CPU supports.
+    // Small coefficients keep b^2 and 4ac below 2^53, full range ones need all 64 bits of the integer discriminant.
+    void benchmarkSolveBatch(const Options& options)
+    {
+        constexpr std::size_t count = 4096;
+        struct Range
+        {
+            const char* m_name;
+            int m_min;
+            int m_max;
+        };
+        const Range ranges[]{
+            { "small", -1000, 1000 },
+            { "full", std::numeric_limits<int>::min(), std::numeric_limits<int>::max() }
+        };
+        std::vector<double> roots(4 * count);
+        std::vector<slv::ResultKind> kinds(count);
+        const slv::BasicSolver<double>::ResultColumns columns{ roots.data(), roots.data() + count, roots.data() + 2 * count,
+            roots.data() + 3 * count, kinds.data() };
+
+        const slv::BatchKernel bestKernel = slv::getBatchKernel();
+        for (const Range& range : ranges)
+        {
+            std::mt19937 random(2024);
+            std::uniform_int_distribution<int> distribution(range.m_min, range.m_max);
+            std::vector<int> a(count);
+            std::vector<int> b(count);
+            std::vector<int> c(count);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                a[i] = distribution(random);
+                b[i] = distribution(random);
+                c[i] = distribution(random);
+            }
+            for (const slv::BatchKernel kernel : { slv::BatchKernel::Scalar, slv::BatchKernel::Sse2, slv::BatchKernel::Avx2, slv::BatchKernel::Avx512 })
+            {
+                if (!slv::setBatchKernel(kernel))
+                {
+                    continue;
+                }
+                const Timing timing = measure(options, [&](const std::uint64_t iterations)
+                    {
+                        for (std::uint64_t i = 0; i < iterations; ++i)
+                        {
+                            slv::BasicSolver<double>::solveBatch(a.data(), b.data(), c.data(), count, columns);
+                            doNotOptimize(roots.data());
+                        }
+                    });
+                Record("solve_batch")
+                    .add("kernel", std::string(slv::getBatchKernelName(kernel)))
+                    .add("coefficients", std::string(range.m_name))
+                    .add("equations", static_cast<std::uint64_t>(count))
+                    .add("iterations", timing.m_iterations)
+                    .add("ns_per_equation_median", timing.m_nsPerOpMedian / count)
+                    .add("ns_per_equation_min", timing.m_nsPerOpMin / count)
+                    .print();
+            }
+        }
+        slv::setBatchKernel(bestKernel);
+    }
+
+    // BasicPolynomialSolver<double>::solveBatch per polynomial, for cubics and quartics.
+    void benchmarkSolvePolynomials(const Options& options)
+    {
+        constexpr std::size_t count = 4096;
+        std::mt19937 random(2024);
+        std::uniform_int_distribution<int> distribution(-1000, 1000);
+        using PolynomialSolver = slv::BasicPolynomialSolver<double>;
+        slv::PolynomialResultStore<double> results;
+        results.resize(count);
+        for (const std::size_t degree : { 3, 4 })
+        {
+            std::vector<int> coeffs(count * (degree + 1));
+            for (int& coefficient : coeffs)
+            {
+                coefficient = distribution(random);
+            }
+            const slv::PolynomialsView polynomials(coeffs.data(), count, degree);
+            const Timing timing = measure(options, [&](const std::uint64_t iterations)
+                {
+                    for (std::uint64_t i = 0; i < iterations; ++i)
+                    {
+                        PolynomialSolver::solveBatch(polynomials, results.getColumns());
+                        doNotOptimize(results.getColumns().m_kinds);
+                    }
+                });
+            Record("solve_polynomials")
+                .add("degree", static_cast<std::uint64_t>(degree))
+                .add("polynomials", static_cast<std::uint64_t>(count))
+                .add("iterations", timing.m_iterations)
+                .add("ns_per_polynomial_median", timing.m_nsPerOpMedian / count)
+                .add("ns_per_polynomial_min", timing.m_nsPerOpMin / count)
+                .print();
+        }
+    }
+
+    // ParallelSolver::operator() over batch sizes and pool sizes. Only solving, without formatting.
+    void benchmarkParallelSolver(const Options& options)
+    {
+        const std::vector<std::size_t> batchSizes = options.m_quick
+            ? std::vector<std::size_t>{ 100, 10'000 } : std::vector<std::size_t>{ 100, 10'000, 1'000'000 };
+        const std::size_t maxBatchSize = batchSizes.back();
+
+        std::mt19937 random(2024);
+        std::uniform_int_distribution<int> distribution(-1000, 1000);
+        std::vector<int> a(maxBatchSize);
+        std::vector<int> b(maxBatchSize);
+        std::vector<int> c(maxBatchSize);
+        for (std::size_t i = 0; i < maxBatchSize; ++i)
+        {
+            a[i] = distribution(random);
+            b[i] = distribution(random);
+            c[i] = distribution(random);
+        }
+
+        for (const std::size_t threads : getThreadCounts(getHardwareThreads()))
+        {
+            mt::ThreadPool pool(threads);
+            slv::ParallelSolver pSolver(pool);
+            for (const std::size_t batchSize : batchSizes)
+            {
+                const slv::CoefficientsView coeffs = slv::CoefficientsView::fromColumns(a.data(), b.data(), c.data(), batchSize);
+                const Timing timing = measure(options, [&](const std::uint64_t iterations)
+                    {
+                        for (std::uint64_t i = 0; i < iterations; ++i)
+                        {
+                            pSolver(coeffs);
+                            doNotOptimize(pSolver.getResults());
+                        }
+                    });
+                Record("parallel_solver")
+                    .add("threads", static_cast<std::uint64_t>(threads))
+                    .add("equations", static_cast<std::uint64_t>(batchSize))
+                    .add("iterations", timing.m_iterations)
+                    .add("ns_per_batch_median", timing.m_nsPerOpMedian)
+                    .add("equations_per_s", static_cast<double>(batchSize) * 1e9 / timing.m_nsPerOpMedian)
+                    .print();
+            }
+        }
+    }
+
+    // InputValidator::getValidatedInput of whitespace separated text, serially (threads 0) and on pools of increasing size.
+    void benchmarkValidateText(const Options& options)
+    {
+        const std::size_t textSize = options.m_quick ? (std::size_t(4) << 20) : (std::size_t(64) << 20);
+        std::mt19937 random(2024);
+        std::uniform_int_distribution<int> distribution(-1000000, 1000000);
+        std::string text;
+        text.reserve(textSize + 64);
+        while (text.size() < textSize)
+        {
+            for (int i = 0; i < 3; ++i)
+            {
+                text += std::to_string(distribution(random));
+                text += i == 2 ? '\n' : ' ';
+            }
+        }
+
+        const InputValidator::ChunkHandler handler = [](std::vector<int> chunk) { doNotOptimize(chunk.data()); };
+        std::vector<std::size_t> threadCounts{ 0 };
+        for (const std::size_t threads : getThreadCounts(getHardwareThreads()))
+        {
+            threadCounts.push_back(threads);
+        }
+        for (const std::size_t threads : threadCounts)
+        {
+            std::unique_ptr<mt::ThreadPool> pool = threads != 0 ? std::make_unique<mt::ThreadPool>(threads) : nullptr;
+            const Timing timing = measure(options, [&](const std::uint64_t iterations)
+                {
+                    for (std::uint64_t i = 0; i < iterations; ++i)
+                    {
+                        const bool isValid = pool
+                            ? InputValidator::getValidatedInput(text, InputValidator::defaultChunkSize, handler, *pool)
+                            : InputValidator::getValidatedInput(text, InputValidator::defaultChunkSize, handler);
+                        if (!isValid)
+                        {
+                            throw std::runtime_error("validate_text: invalid input");
+                        }
+                    }
+                });
+            Record("validate_text")
+                .add("threads", static_cast<std::uint64_t>(threads))
+                .add("bytes", static_cast<std::uint64_t>(text.size()))
+                .add("iterations", timing.m_iterations)
+                .add("mb_per_s", static_cast<double>(text.size()) / 1e6 * 1e9 / timing.m_nsPerOpMedian)
+                .print();
+        }
+    }
+
+    // ThreadSafeSTLAdapter::push / tryPop with producers pushing and consumers polling concurrently.
+    // Run 1 moves items one by one, larger runs use pushBulk / tryPopBulk.
+    template<typename MakeAdapter>
+    void benchmarkAdapterWith(const Options& options, const MakeAdapter& makeAdapter, const std::string_view allocator)
+    {
+        const std::size_t itemsPerProducer = options.m_quick ? 10'000 : 200'000;
+        const int repetitions = options.m_quick ? 1 : 3;
+        const std::vector<std::size_t> threadCounts = getThreadCounts(std::min<std::size_t>(getHardwareThreads(), 8));
+
+        for (const std::size_t runSize : { std::size_t{ 1 }, std::size_t{ 64 } })
+        {
+            for (const std::size_t producers : threadCounts)
+            {
+                for (const std::size_t consumers : threadCounts)
+                {
+                    std::vector<double> seconds;
+                    for (int repetition = 0; repetition < repetitions; ++repetition)
+                    {
+                        auto adapter = makeAdapter();
+                        const std::size_t total = producers * itemsPerProducer;
+                        std::atomic<std::size_t> popped{ 0 };
+                        std::atomic<bool> go{ false };
+                        std::vector<std::jthread> threads;
+                        for (std::size_t i = 0; i < producers; ++i)
+                        {
+                            threads.emplace_back([&]
+                                {
+                                    while (!go.load(std::memory_order_acquire))
+                                    {
+                                        std::this_thread::yield();
+                                    }
+                                    std::vector<int> run;
+                                    for (std::size_t item = 0; item < itemsPerProducer; ++item)
+                                    {
+                                        if (runSize == 1)
+                                        {
+                                            adapter.push(static_cast<int>(item));
+                                            continue;
+                                        }
+                                        run.push_back(static_cast<int>(item));
+                                        if (run.size() == runSize || item + 1 == itemsPerProducer)
+                                        {
+                                            adapter.pushBulk(run.begin(), run.end());
+                                            run.clear();
+                                        }
+                                    }
+                                });
+                        }
+                        for (std::size_t i = 0; i < consumers; ++i)
+                        {
+                            threads.emplace_back([&]
+                                {
+                                    while (!go.load(std::memory_order_acquire))
+                                    {
+                                        std::this_thread::yield();
+                                    }
+                                    std::vector<int> items(1);
+                                    while (popped.load(std::memory_order_relaxed) < total)
+                                    {
+                                        std::size_t count = 0;
+                                        if (runSize == 1)
+                                        {
+                                            count = adapter.tryPop(items.front()) ? 1 : 0;
+                                        }
+                                        else
+                                        {
+                                            items.clear();
+                                            count = adapter.tryPopBulk(items, runSize);
+                                        }
+                                        if (count != 0)
+                                        {
+                                            doNotOptimize(items);
+                                            popped.fetch_add(count, std::memory_order_relaxed);
+                                        }
+                                        else
+                                        {
+                                            std::this_thread::yield();
+                                        }
+                                    }
+                                });
+                        }
+                        const Clock::time_point start = Clock::now();
+                        go.store(true, std::memory_order_release);
+                        threads.clear();
+                        seconds.push_back(std::chrono::duration<double>(Clock::now() - start).count());
+                    }
+                    std::ranges::sort(seconds);
+                    const double median = seconds[seconds.size() / 2];
+                    Record("adapter_push_trypop")
+                        .add("allocator", std::string(allocator))
+                        .add("run", static_cast<std::uint64_t>(runSize))
+                        .add("producers", static_cast<std::uint64_t>(producers))
+                        .add("consumers", static_cast<std::uint64_t>(consumers))
+                        .add("items", static_cast<std::uint64_t>(producers * itemsPerProducer))
+                        .add("seconds_median", median)
+                        .add("items_per_s", static_cast<double>(producers * itemsPerProducer) / median)
+                        .print();
+                }
+            }
+        }
+    }
+
+    // The adapter with the standard allocator and with the container and elements allocated from a NodePool.
+    void benchmarkAdapter(const Options& options)
+    {
+        benchmarkAdapterWith(options, [] { return mt::createThreadSafeSTLAdapterFrom(std::queue<int>{}); }, "std");
+        mt::NodePool pool;
+        benchmarkAdapterWith(options, [&]
+            {
+                using PooledDeque = std::deque<int, mt::PoolAllocator<int>>;
+                return mt::createThreadSafeSTLAdapterFrom(std::queue<int, PooledDeque>{ PooledDeque(mt::PoolAllocator<int>(pool)) });
+            }, "pool");
+    }
+
+    // Many independent batches consumed by a ConsumerPool, over worker counts and both orderings.
+    // Every batch is solved equation by equation on the worker thread, the sink counts the results.
+    void benchmarkConsumerPool(const Options& options)
+    {
+        const std::size_t batches = options.m_quick ? 64 : 512;
+        const std::size_t equationsPerBatch = 4096;
+        const int repetitions = options.m_quick ? 1 : 3;
+
+        std::mt19937 random(2024);
+        std::uniform_int_distribution<int> distribution(-1000, 1000);
+        std::vector<int> batch(3 * equationsPerBatch);
+        std::ranges::generate(batch, [&] { return distribution(random); });
+
+        const auto solveBatch = [](const std::vector<int>& coeffs)
+            {
+                std::size_t roots = 0;
+                for (std::size_t i = 0; i + 2 < coeffs.size(); i += 3)
+                {
+                    const slv::Solver::Result result = slv::Solver::solve(coeffs[i], coeffs[i + 1], coeffs[i + 2]);
+                    doNotOptimize(result);
+                    roots += result.index();
+                }
+                return roots;
+            };
+
+        for (const mt::Ordering ordering : { mt::Ordering::Input, mt::Ordering::Completion })
+        {
+            for (const std::size_t workers : getThreadCounts(getHardwareThreads()))
+            {
+                std::vector<double> seconds;
+                for (int repetition = 0; repetition < repetitions; ++repetition)
+                {
+                    std::size_t delivered = 0;
+                    auto sharedContainer = mt::createThreadSafeSTLAdapterFrom(std::queue<std::vector<int>>{});
+                    const Clock::time_point start = Clock::now();
+                    {
+                        mt::Producer producer(sharedContainer);
+                        mt::ConsumerPool pool(sharedContainer, solveBatch, [&](std::size_t) { ++delivered; }, ordering, workers);
+                        const std::shared_future<void> consumed = pool.getCompletionFuture();
+                        producer.enableWorkerThread();
+                        pool.enableWorkerThread();
+                        producer.push(std::vector<std::vector<int>>(batches, batch));
+                        producer.close();
+                        consumed.get();
+                    }
+                    seconds.push_back(std::chrono::duration<double>(Clock::now() - start).count());
+                    if (delivered != batches)
+                    {
+                        throw std::runtime_error("consumer_pool: lost results");
+                    }
+                }
+                std::ranges::sort(seconds);
+                const double median = seconds[seconds.size() / 2];
+                Record("consumer_pool")
+                    .add("ordering", std::string(ordering == mt::Ordering::Input ? "input" : "completion"))
+                    .add("workers", static_cast<std::uint64_t>(workers))
+                    .add("batches", static_cast<std::uint64_t>(batches))
+                    .add("equations_per_batch", static_cast<std::uint64_t>(equationsPerBatch))
+                    .add("seconds_median", median)
+                    .add("batches_per_s", static_cast<double>(batches) / median)
+                    .print();
+            }
+        }
+    }
+
+    // Time from Producer::push of a chunk to the Consumer callback receiving it, one chunk in flight at a time.
+    // Both workers run as in Main: the producer thread moves chunks to the shared container, the consumer thread pops them.
+    void benchmarkPipelineLatency(const Options& options)
+    {
+        const std::size_t messages = options.m_quick ? 1'000 : 20'000;
+        std::vector<Clock::time_point> sendTimes(messages);
+        std::vector<std::uint64_t> latencies(messages);
+        std::atomic<std::size_t> received{ 0 };
+
+        {
+            auto sharedContainer = mt::createThreadSafeSTLAdapterFrom(std::queue<std::vector<int>>{});
+            mt::Producer producer(sharedContainer);
+            mt::Consumer consumer(sharedContainer, [&](const std::vector<int>& chunk)
+                {
+                    const Clock::time_point now = Clock::now();
+                    const std::size_t sequence = static_cast<std::size_t>(chunk.front());
+                    latencies[sequence] = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - sendTimes[sequence]).count());
+                    received.fetch_add(1, std::memory_order_release);
+                });
+            const std::shared_future<void> consumed = consumer.getCompletionFuture();
+            producer.enableWorkerThread();
+            consumer.enableWorkerThread();
+            for (std::size_t i = 0; i < messages; ++i)
+            {
+                sendTimes[i] = Clock::now();
+                producer.push({ { static_cast<int>(i), 0, 0 } });
+                while (received.load(std::memory_order_acquire) != i + 1)
+                {
+                    std::this_thread::yield();
+                }
+            }
+            producer.close();
+            consumed.get();
+        }
+
+        std::ranges::sort(latencies);
+        const auto percentile = [&](const double p)
+            {
+                return latencies[std::min(static_cast<std::size_t>(p * static_cast<double>(messages)), messages - 1)];
+            };
+        Record("pipeline_handoff_latency")
+            .add("messages", static_cast<std::uint64_t>(messages))
+            .add("ns_p50", percentile(0.5))
+            .add("ns_p90", percentile(0.9))
+            .add("ns_p99", percentile(0.99))
+            .add("ns_p999", percentile(0.999))
+            .add("ns_max", latencies.back())
+            .print();
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--quick") == 0)
+        {
+            options.m_quick = true;
+        }
+        else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+        {
+            options.m_filter = argv[++i];
+        }
+        else
+        {
+            std::cerr << "Usage: SolverBenchmarks [--quick] [--filter <name>]" << std::endl;
+            return 1;
+        }
+    }
+
+    const std::pair<std::string_view, void (*)(const Options&)> benchmarks[]{
+        { "validate_text", benchmarkValidateText },
+        { "solve", benchmarkSolve },
+        { "solve_batch", benchmarkSolveBatch },
+        { "solve_polynomials", benchmarkSolvePolynomials },
+        { "parallel_solver", benchmarkParallelSolver },
+        { "adapter_push_trypop", benchmarkAdapter },
+        { "consumer_pool", benchmarkConsumerPool },
+        { "pipeline_handoff_latency", benchmarkPipelineLatency }
+    };
+    try
+    {
+        benchmarkContext();
+        for (const auto& [name, benchmark] : benchmarks)
+        {
+            if (name.find(options.m_filter) != std::string_view::npos)
+            {
+                benchmark(options);
+            }
+        }
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+}
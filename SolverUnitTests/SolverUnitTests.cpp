@@ -10,13 +10,54 @@
  */
 
 #include "CppUnitTest.h"
+#include "../Solver/BinaryCoefficientsFile.h"
+#include "../Solver/Consumer.h"
+#include "../Solver/ConsumerPool.h"
+#include "../Solver/GranularityPolicy.h"
 #include "../Solver/InputValidator.h"
+#include "../Solver/LockFreeRingBuffer.h"
+#include "../Solver/NodePool.h"
+#include "../Solver/ParallelPolynomialSolver.h"
+#include "../Solver/ParallelSolver.h"
+#include "../Solver/PolynomialSolver.h"
+#include "../Solver/Producer.h"
+#include "../Solver/ResultCache.h"
+#include "../Solver/ResultFormatter.h"
+#include "../Solver/ResultStore.h"
 #include "../Solver/Solver.h"
+#include "../Solver/Statistics.h"
+#include "../Solver/ThreadPool.h"
+#include "../Solver/Topology.h"
+
+#include <algorithm>
+#include <cmath>
+#include <coroutine>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <sstream>
+#include <tuple>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
 namespace SolverUnitTests
 {
+	// Coroutine which starts at once and is never awaited itself, enough to co_await a batch.
+	struct DetachedTask
+	{
+		struct promise_type
+		{
+			DetachedTask get_return_object() noexcept { return {}; }
+			std::suspend_never initial_suspend() noexcept { return {}; }
+			std::suspend_never final_suspend() noexcept { return {}; }
+			void return_void() noexcept { }
+			void unhandled_exception() noexcept { std::terminate(); }
+		};
+	};
+
 	TEST_CLASS(SolverUnitTests)
 	{
 	public:
@@ -95,6 +136,129 @@ namespace SolverUnitTests
 			const char* const argv21[]{ "ProgramName", "1", "0", "0" };
 			Assert::IsTrue(res1 == InputValidator::getValidatedInput(sizeof(argv21) / sizeof(argv21[0]), argv21), L"InputValidatorTest21");
 		}
+		TEST_METHOD(InputValidatorTextTests)
+		{
+			std::vector<std::vector<int>> chunks;
+			const InputValidator::ChunkHandler handler = [&](std::vector<int> chunk) { chunks.push_back(std::move(chunk)); };
+
+			// Testing of count and tokens (negative), same rules as for arguments.
+			Assert::IsFalse(InputValidator::getValidatedInput(std::string_view(""), 3, handler), L"InputValidatorTextTest1");
+			Assert::IsFalse(InputValidator::getValidatedInput(std::string_view("1 2 3 4"), 3, handler), L"InputValidatorTextTest2");
+			Assert::IsFalse(InputValidator::getValidatedInput(std::string_view("1 2 -0"), 3, handler), L"InputValidatorTextTest3");
+			Assert::IsFalse(InputValidator::getValidatedInput(std::string_view("1 2 0234"), 3, handler), L"InputValidatorTextTest4");
+			Assert::IsFalse(InputValidator::getValidatedInput(std::string_view("1 2 77777777777777"), 3, handler), L"InputValidatorTextTest5");
+			Assert::IsFalse(InputValidator::getValidatedInput(std::string_view("1 2,3"), 3, handler), L"InputValidatorTextTest6");
+
+			// Testing of chunking (positive). Any whitespace separates tokens, chunk size is rounded down to whole equations.
+			chunks.clear();
+			Assert::IsTrue(InputValidator::getValidatedInput(std::string_view(" 1 2\t3\n4 5 6\r\n7 8 0 "), 7, handler), L"InputValidatorTextTest7");
+			Assert::IsTrue(chunks == std::vector<std::vector<int>>{ { 1, 2, 3, 4, 5, 6 }, { 7, 8, 0 } }, L"InputValidatorTextTest8");
+		}
+		TEST_METHOD(InputValidatorParallelTests)
+		{
+			mt::ThreadPool pool(4);
+			// Same chunks and the same message as the serial version, captured from std::cerr.
+			auto validate = [](const auto& validator, std::vector<std::vector<int>>& chunks, std::string& message)
+				{
+					chunks.clear();
+					std::ostringstream errors;
+					std::streambuf* const cerrBuffer = std::cerr.rdbuf(errors.rdbuf());
+					const bool isValid = validator([&](std::vector<int> chunk) { chunks.push_back(std::move(chunk)); });
+					std::cerr.rdbuf(cerrBuffer);
+					message = errors.str();
+					return isValid;
+				};
+			std::vector<std::vector<int>> serialChunks, parallelChunks;
+			std::string serialMessage, parallelMessage;
+
+			// Several segments, tokens of every length and both signs, segment boundaries fall anywhere.
+			std::string text;
+			const char* const tokens[]{ "0", "-7", "-07", "123456789", "-0000000002147483648", "2147483647", "42", "-1000000" };
+			for (std::size_t i = 0; text.size() < (std::size_t(3) << 20); ++i)
+			{
+				text += tokens[i % 8];
+				text += i % 5 == 0 ? "\r\n" : " ";
+			}
+			text += "1 2 3";
+			auto validateText = [&](const std::string_view input, std::vector<std::vector<int>>& chunks, std::string& message, mt::ThreadPool* const threadPool)
+				{
+					return validate([&](const InputValidator::ChunkHandler& handler)
+						{
+							return threadPool ? InputValidator::getValidatedInput(input, 3000, handler, *threadPool) : InputValidator::getValidatedInput(input, 3000, handler);
+						}, chunks, message);
+				};
+			Assert::IsTrue(validateText(text, serialChunks, serialMessage, nullptr) && validateText(text, parallelChunks, parallelMessage, &pool), L"InputValidatorParallelTest1");
+			Assert::IsTrue(parallelChunks == serialChunks && serialChunks.size() > 100 && parallelMessage.empty(), L"InputValidatorParallelTest2");
+			const std::vector<std::vector<int>> textChunks = serialChunks;
+
+			// The first invalid token is reported, after the chunks before it were handled.
+			std::string invalidText = text;
+			invalidText.replace(invalidText.size() / 2, 1, "x");
+			invalidText.replace(invalidText.size() - 20, 1, "y");
+			Assert::IsFalse(validateText(invalidText, serialChunks, serialMessage, nullptr), L"InputValidatorParallelTest3");
+			Assert::IsFalse(validateText(invalidText, parallelChunks, parallelMessage, &pool), L"InputValidatorParallelTest4");
+			Assert::IsTrue(parallelChunks == serialChunks && parallelMessage == serialMessage && serialMessage.find('x') != std::string::npos, L"InputValidatorParallelTest5");
+
+			// Streams are read by blocks of several segments.
+			std::FILE* const file = std::tmpfile();
+			std::fwrite(text.data(), 1, text.size(), file);
+			std::rewind(file);
+			Assert::IsTrue(validate([&](const InputValidator::ChunkHandler& handler) { return InputValidator::getValidatedInput(file, 3000, handler, pool); },
+				parallelChunks, parallelMessage), L"InputValidatorParallelTest6");
+			std::fclose(file);
+			Assert::IsTrue(parallelChunks == textChunks, L"InputValidatorParallelTest7");
+
+			// Arguments are parsed by ranges.
+			std::vector<std::string> arguments{ "ProgramName" };
+			for (std::size_t i = 0; i < 150000; ++i)
+			{
+				arguments.push_back(std::to_string(static_cast<int>(i * 2654435761u)));
+			}
+			std::vector<const char*> argv;
+			for (const std::string& argument : arguments)
+			{
+				argv.push_back(argument.c_str());
+			}
+			const int argc = static_cast<int>(argv.size());
+			const std::optional<std::vector<int>> serialInput = InputValidator::getValidatedInput(argc, argv.data());
+			Assert::IsTrue(serialInput && serialInput == InputValidator::getValidatedInput(argc, argv.data(), pool), L"InputValidatorParallelTest8");
+			argv[100000] = "-0";
+			argv[140000] = "+1";
+			Assert::IsFalse(validate([&](const InputValidator::ChunkHandler&) { return InputValidator::getValidatedInput(argc, argv.data(), pool).has_value(); },
+				parallelChunks, parallelMessage), L"InputValidatorParallelTest9");
+			Assert::IsTrue(parallelMessage.find("\"-0\" is not an int") == 0, L"InputValidatorParallelTest10");
+		}
+		TEST_METHOD(BinaryCoefficientsFileTests)
+		{
+			const int interleaved[]{ 1, 2, 3, 4, 5, 6 };
+			const slv::CoefficientsView coeffs = slv::CoefficientsView::fromInterleaved(interleaved, 2);
+			const std::string path = (std::filesystem::temp_directory_path() / "SolverUnitTests.slvb").string();
+
+			for (const BinaryCoefficientsFile::Layout layout : { BinaryCoefficientsFile::Layout::Interleaved, BinaryCoefficientsFile::Layout::Columnar })
+			{
+				{
+					std::ofstream out(path, std::ios::binary);
+					BinaryCoefficientsFile::write(out, coeffs, layout);
+				}
+				const std::optional<BinaryCoefficientsFile> file = BinaryCoefficientsFile::open(path);
+				Assert::IsTrue(file.has_value(), L"BinaryCoefficientsFileTest1");
+				const slv::CoefficientsView& loaded = file->getCoefficients();
+				Assert::IsTrue(loaded.size() == 2 && loaded.isColumnar() == (layout == BinaryCoefficientsFile::Layout::Columnar), L"BinaryCoefficientsFileTest2");
+				for (std::size_t i = 0; i < 2; ++i)
+				{
+					Assert::IsTrue(loaded.a(i) == coeffs.a(i) && loaded.b(i) == coeffs.b(i) && loaded.c(i) == coeffs.c(i), L"BinaryCoefficientsFileTest3");
+				}
+			}
+
+			// Truncated data (negative).
+			{
+				std::ofstream out(path, std::ios::binary);
+				BinaryCoefficientsFile::write(out, coeffs, BinaryCoefficientsFile::Layout::Interleaved);
+				out.write("\0", 1);
+			}
+			Assert::IsFalse(BinaryCoefficientsFile::open(path).has_value(), L"BinaryCoefficientsFileTest4");
+			std::filesystem::remove(path);
+		}
 		TEST_METHOD(SolverLinearTests)
 		{
 			using namespace slv;
@@ -159,5 +323,1192 @@ namespace SolverUnitTests
 				refRes1.m_extremum == refRes2.m_extremum &&
 				refRes1.m_criticalPoint == refRes2.m_criticalPoint, L"SolverQuadraticTest3");
 		}
+		TEST_METHOD(SolverPrecisionTests)
+		{
+			using namespace slv;
+
+			// x^2 + 10^8x + 1 = 0: the textbook formula loses about half of the digits of the small root in double.
+			const auto roots = std::get<BasicSolver<double>::QuadraticResult>(BasicSolver<double>::solve(1.0, 1e8, 1.0)).m_roots.value();
+			Assert::IsTrue(std::fabs(roots.second + 1e-8) < 1e-22 && std::fabs(roots.first + 1e8) < 1e-6, L"SolverPrecisionTest1");
+
+			// Every precision gives the same roots in the same order, the sign of zero roots included.
+			const auto floatRoots = std::get<BasicSolver<float>::QuadraticResult>(BasicSolver<float>::solve(-1.0f, 2.0f, 0.0f)).m_roots.value();
+			const auto longDoubleRoots = std::get<BasicSolver<long double>::QuadraticResult>(BasicSolver<long double>::solve(-1.0L, 2.0L, 0.0L)).m_roots.value();
+			Assert::IsTrue(floatRoots.first == 2.0f && floatRoots.second == 0.0f && std::signbit(floatRoots.second), L"SolverPrecisionTest2");
+			Assert::IsTrue(longDoubleRoots.first == 2.0L && longDoubleRoots.second == 0.0L && std::signbit(longDoubleRoots.second), L"SolverPrecisionTest3");
+
+			// Batches of non-vectorized precisions match their solve().
+			const int a[]{ 1, 0, 2, -3, 1 };
+			const int b[]{ 7, 3, 0, 5, 0 };
+			const int c[]{ 6, -6, -8, 1, 1 };
+			constexpr std::size_t count = sizeof(a) / sizeof(a[0]);
+			float firstRoots[count];
+			float secondRoots[count];
+			float extremums[count];
+			float criticalPoints[count];
+			ResultKind kinds[count];
+			const BasicSolver<float>::ResultColumns columns{ firstRoots, secondRoots, extremums, criticalPoints, kinds };
+			BasicSolver<float>::solveBatch(a, b, c, count, columns);
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				Assert::IsTrue(BasicSolver<float>::toResult(columns, i) ==
+					BasicSolver<float>::solve(static_cast<float>(a[i]), static_cast<float>(b[i]), static_cast<float>(c[i])), L"SolverPrecisionTest4");
+			}
+
+			// Formatted text does not depend on the precision when values are exact.
+			std::vector<int> coeffs{ 1, 2, -3, 0, 2, 4, 1, 0, 1 };
+			BasicParallelSolver<float> floatSolver;
+			BasicParallelSolver<long double> longDoubleSolver;
+			floatSolver(coeffs);
+			longDoubleSolver(coeffs);
+			std::ostringstream floatText;
+			std::ostringstream longDoubleText;
+			floatText << floatSolver;
+			longDoubleText << longDoubleSolver;
+			Assert::IsTrue(floatText.str() == longDoubleText.str() && !floatText.str().empty(), L"SolverPrecisionTest5");
+		}
+		TEST_METHOD(SolverBatchTests)
+		{
+			using namespace slv;
+
+			// Covers every branch and more rows than one SIMD register holds, so vector and tail code are both used.
+			const int a[]{ 0, 0, 0, 0, 1, 1, 1, -1, 2, 0, 1 };
+			const int b[]{ 1, -1, 0, 0, 2, 1, 7, 0, 4, 3, -2 };
+			const int c[]{ 1, 1, 1, 0, 1, 10, 6, 4, 2, -6, -3 };
+			constexpr std::size_t count = sizeof(a) / sizeof(a[0]);
+			Solver::Float firstRoots[count];
+			Solver::Float secondRoots[count];
+			Solver::Float extremums[count];
+			Solver::Float criticalPoints[count];
+			Solver::ResultKind kinds[count];
+			const Solver::ResultColumns columns{ firstRoots, secondRoots, extremums, criticalPoints, kinds };
+			Solver::solveBatch(a, b, c, count, columns);
+
+			const Solver::ResultKind expectedKinds[]{
+				Solver::ResultKind::Linear, Solver::ResultKind::Linear, Solver::ResultKind::Incorrect, Solver::ResultKind::Identity,
+				Solver::ResultKind::TwoRoots, Solver::ResultKind::NoRealRoots, Solver::ResultKind::TwoRoots, Solver::ResultKind::TwoRoots,
+				Solver::ResultKind::TwoRoots, Solver::ResultKind::Linear, Solver::ResultKind::TwoRoots };
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				Assert::IsTrue(kinds[i] == expectedKinds[i], L"SolverBatchTest1");
+				Assert::IsTrue(Solver::toResult(columns, i) == Solver::solve(a[i], b[i], c[i]), L"SolverBatchTest2");
+			}
+		}
+		TEST_METHOD(BatchKernelTests)
+		{
+			using namespace slv;
+			using DoubleSolver = BasicSolver<double>;
+
+			// Every branch, large coefficients and a count which leaves a tail for every vector width.
+			constexpr std::size_t count = 45;
+			int a[count];
+			int b[count];
+			int c[count];
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				const int k = static_cast<int>(i);
+				a[i] = k % 5 == 0 ? 0 : (k % 2 == 0 ? -k : k * 1000003);
+				b[i] = k % 7 == 0 ? 0 : (k % 3 == 0 ? 2 * k : -k * 77777);
+				c[i] = k % 11 == 0 ? 0 : k * k - 200;
+			}
+			auto solveWith = [&](const BatchKernel kernel, std::vector<DoubleSolver::Result>& results)
+				{
+					double roots[4][count];
+					ResultKind kinds[count];
+					const DoubleSolver::ResultColumns columns{ roots[0], roots[1], roots[2], roots[3], kinds };
+					setBatchKernel(kernel);
+					DoubleSolver::solveBatch(a, b, c, count, columns);
+					results.clear();
+					for (std::size_t i = 0; i < count; ++i)
+					{
+						results.push_back(DoubleSolver::toResult(columns, i));
+					}
+				};
+
+			Assert::IsTrue(isBatchKernelSupported(BatchKernel::Scalar) && isBatchKernelSupported(getBestBatchKernel()), L"BatchKernelTest1");
+			Assert::IsTrue(getBatchKernelName(BatchKernel::Avx512) == "avx512" && getBatchKernelName(BatchKernel::Scalar) == "scalar", L"BatchKernelTest2");
+			std::vector<DoubleSolver::Result> expectedResults;
+			solveWith(BatchKernel::Scalar, expectedResults);
+			Assert::IsTrue(getBatchKernel() == BatchKernel::Scalar, L"BatchKernelTest3");
+
+			// Every kernel this CPU runs gives identical results, columns unused by a result's kind may differ.
+			for (const BatchKernel kernel : { BatchKernel::Sse2, BatchKernel::Avx2, BatchKernel::Avx512 })
+			{
+				if (!isBatchKernelSupported(kernel))
+				{
+					Assert::IsTrue(!setBatchKernel(kernel) && getBatchKernel() == BatchKernel::Scalar, L"BatchKernelTest4");
+					continue;
+				}
+				std::vector<DoubleSolver::Result> results;
+				solveWith(kernel, results);
+				Assert::IsTrue(getBatchKernel() == kernel, L"BatchKernelTest5");
+				Assert::IsTrue(results == expectedResults, L"BatchKernelTest6");
+				setBatchKernel(BatchKernel::Scalar);
+			}
+			setBatchKernel(getBestBatchKernel());
+		}
+		TEST_METHOD(IntegerDiscriminantTests)
+		{
+			using namespace slv;
+			using DoubleSolver = BasicSolver<double>;
+			constexpr int intMin = std::numeric_limits<int>::min();
+			constexpr int intMax = std::numeric_limits<int>::max();
+
+			// D = -4, but b^2 and 4ac round to the same double.
+			Assert::IsTrue(!std::get<DoubleSolver::QuadraticResult>(DoubleSolver::solve(900000001, 1799940002, 899940002)).m_roots, L"IntegerDiscriminantTest1");
+
+			// D = 1 is a perfect square, roots are -(10^9 + 1) / 10^9 and -1 rounded once, also in float.
+			const auto roots = std::get<DoubleSolver::QuadraticResult>(DoubleSolver::solve(1000000000, 2000000001, 1000000001)).m_roots.value();
+			Assert::IsTrue(roots.first == -1000000001.0 / 1000000000.0 && roots.second == -1.0, L"IntegerDiscriminantTest2");
+			const auto floatRoots = std::get<BasicSolver<float>::QuadraticResult>(BasicSolver<float>::solve(1000000000, 2000000001, 1000000001)).m_roots.value();
+			Assert::IsTrue(floatRoots.second == -1.0f, L"IntegerDiscriminantTest3");
+
+			// Extreme coefficients don't overflow.
+			Assert::IsTrue(!std::get<DoubleSolver::QuadraticResult>(DoubleSolver::solve(intMin, 0, intMin)).m_roots, L"IntegerDiscriminantTest4");
+			const auto extremeRoots = std::get<DoubleSolver::QuadraticResult>(DoubleSolver::solve(intMin, intMin, intMax)).m_roots.value();
+			Assert::IsTrue(std::isfinite(extremeRoots.first) && std::isfinite(extremeRoots.second) && extremeRoots.first > 0 && extremeRoots.second < 0, L"IntegerDiscriminantTest5");
+
+			// Every kernel falls back to the integer path for such rows, wherever they are in a vector.
+			const int a[]{ 1, 900000001, 2, intMin, 1000000000, 1, intMin, 3, 1, 4, 900000001, 1, 5, -1, 1000000000, 2 };
+			const int b[]{ 2, 1799940002, -3, 0, 2000000001, 0, intMin, 1, -2, 4, 1799940002, 7, 0, 3, 2000000001, 5 };
+			const int c[]{ 1, 899940002, 1, intMin, 1000000001, -4, intMax, -2, 1, 1, 899940002, 6, 5, 4, 1000000001, -3 };
+			constexpr std::size_t count = sizeof(a) / sizeof(a[0]);
+			double firstRoots[count];
+			double secondRoots[count];
+			double extremums[count];
+			double criticalPoints[count];
+			ResultKind kinds[count];
+			const DoubleSolver::ResultColumns columns{ firstRoots, secondRoots, extremums, criticalPoints, kinds };
+			for (const BatchKernel kernel : { BatchKernel::Scalar, BatchKernel::Sse2, BatchKernel::Avx2, BatchKernel::Avx512 })
+			{
+				if (setBatchKernel(kernel))
+				{
+					DoubleSolver::solveBatch(a, b, c, count, columns);
+					for (std::size_t i = 0; i < count; ++i)
+					{
+						Assert::IsTrue(DoubleSolver::toResult(columns, i) == DoubleSolver::solve(a[i], b[i], c[i]), L"IntegerDiscriminantTest6");
+					}
+				}
+			}
+			setBatchKernel(getBestBatchKernel());
+		}
+		TEST_METHOD(PolynomialSolverTests)
+		{
+			using namespace slv;
+			using DoubleSolver = BasicPolynomialSolver<double>;
+			const auto solve = [](std::vector<int> coeffs)
+				{
+					return DoubleSolver::solve(coeffs.data(), coeffs.size() - 1);
+				};
+			const auto hasRoots = [](const DoubleSolver::Result& result, const PolynomialKind kind, const std::vector<double>& roots)
+				{
+					if (result.m_kind != kind || result.m_roots.size() != roots.size())
+					{
+						return false;
+					}
+					for (std::size_t i = 0; i < roots.size(); ++i)
+					{
+						if (std::abs(result.m_roots[i] - roots[i]) > 1e-9)
+						{
+							return false;
+						}
+					}
+					return true;
+				};
+
+			// Cubics, multiple roots are counted with their multiplicity.
+			Assert::IsTrue(hasRoots(solve({ 1, -6, 11, -6 }), PolynomialKind::ThreeRoots, { 1, 2, 3 }), L"PolynomialSolverTest1");
+			Assert::IsTrue(hasRoots(solve({ 1, 0, 0, -1 }), PolynomialKind::OneRoot, { 1 }), L"PolynomialSolverTest2");
+			Assert::IsTrue(hasRoots(solve({ 1, -3, 3, -1 }), PolynomialKind::ThreeRoots, { 1, 1, 1 }), L"PolynomialSolverTest3");
+			Assert::IsTrue(hasRoots(solve({ 2, 0, 0, 0 }), PolynomialKind::ThreeRoots, { 0, 0, 0 }), L"PolynomialSolverTest4");
+			Assert::IsTrue(hasRoots(solve({ 1, 5, 0, 0 }), PolynomialKind::ThreeRoots, { -5, 0, 0 }), L"PolynomialSolverTest5");
+
+			// Quartics.
+			Assert::IsTrue(hasRoots(solve({ 1, -10, 35, -50, 24 }), PolynomialKind::FourRoots, { 1, 2, 3, 4 }), L"PolynomialSolverTest6");
+			Assert::IsTrue(hasRoots(solve({ 1, 0, -2, 0, 1 }), PolynomialKind::FourRoots, { -1, -1, 1, 1 }), L"PolynomialSolverTest7");
+			Assert::IsTrue(hasRoots(solve({ 1, 0, 0, 0, 1 }), PolynomialKind::NoRealRoots, {}), L"PolynomialSolverTest8");
+			Assert::IsTrue(hasRoots(solve({ 1, 0, -5, 0, 4 }), PolynomialKind::FourRoots, { -2, -1, 1, 2 }), L"PolynomialSolverTest9");
+			Assert::IsTrue(hasRoots(solve({ 1, -4, 6, -4, 1 }), PolynomialKind::FourRoots, { 1, 1, 1, 1 }), L"PolynomialSolverTest10");
+			// The discriminant and D are 0, but a real double root is left with a complex pair: (x - 3)^2 (x^2 - 4x + 6), 2(x - 1)^2 (x^2 - 4x + 6).
+			Assert::IsTrue(hasRoots(solve({ 1, -10, 39, -72, 54 }), PolynomialKind::TwoRoots, { 3, 3 }), L"PolynomialSolverTest17");
+			Assert::IsTrue(hasRoots(solve({ 2, -12, 30, -32, 12 }), PolynomialKind::TwoRoots, { 1, 1 }), L"PolynomialSolverTest18");
+			Assert::IsTrue(hasRoots(solve({ 1, 0, 2, 0, 1 }), PolynomialKind::NoRealRoots, {}), L"PolynomialSolverTest19");
+
+			// Leading zeros lower the degree, down to identities and incorrect rows.
+			Assert::IsTrue(hasRoots(solve({ 0, 0, 1, -3, 2 }), PolynomialKind::TwoRoots, { 1, 2 }), L"PolynomialSolverTest11");
+			Assert::IsTrue(hasRoots(solve({ 0, 0, 0, 2, -1 }), PolynomialKind::OneRoot, { 0.5 }), L"PolynomialSolverTest12");
+			Assert::IsTrue(hasRoots(solve({ 0, 0, 0, 0, 0 }), PolynomialKind::Identity, {}), L"PolynomialSolverTest13");
+			Assert::IsTrue(hasRoots(solve({ 0, 0, 0, 0, 7 }), PolynomialKind::Incorrect, {}), L"PolynomialSolverTest14");
+
+			// solveBatch matches solve row by row, including rows solved by BasicSolver::solveBatch and roots at 0.
+			for (const std::size_t degree : { 3, 4 })
+			{
+				std::vector<int> coeffs((degree + 1) * 1000);
+				for (std::size_t i = 0; i < coeffs.size(); ++i)
+				{
+					coeffs[i] = i % 11 == 0 ? 0 : static_cast<int>((i * 7919) % 201) - 100;
+				}
+				const PolynomialsView polynomials(coeffs.data(), coeffs.size() / (degree + 1), degree);
+				PolynomialResultStore<double> results;
+				results.resize(polynomials.size());
+				DoubleSolver::solveBatch(polynomials, results.getColumns());
+				bool resultsMatch = true;
+				for (std::size_t i = 0; i < polynomials.size(); ++i)
+				{
+					resultsMatch = resultsMatch && results[i] == DoubleSolver::solve(coeffs.data() + i * (degree + 1), degree);
+				}
+				Assert::IsTrue(resultsMatch, L"PolynomialSolverTest15");
+			}
+
+			// Formatted text.
+			const int quartics[]{ 1, -10, 35, -50, 24, 1, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1 };
+			const PolynomialsView polynomials(quartics, 4, 4);
+			PolynomialResultStore<double> results;
+			results.resize(polynomials.size());
+			DoubleSolver::solveBatch(polynomials, results.getColumns());
+			std::string buffer;
+			ResultFormatter::formatBlock(polynomials, results.getColumns(), buffer);
+			Assert::IsTrue(buffer ==
+				"INPUT: (1, -10, 35, -50, 24)\nOUTPUT: (1.000000, 2.000000, 3.000000, 4.000000)\n\n"
+				"INPUT: (1, 0, 0, 0, 1)\nOUTPUT: NO REAL ROOTS\n\n"
+				"INPUT: (0, 0, 0, 0, 0)\nOUTPUT: AN IDENTITY\n\n"
+				"INPUT: (0, 0, 0, 0, 1)\nOUTPUT: NOT CORRECT\n\n", L"PolynomialSolverTest16");
+		}
+		TEST_METHOD(ParallelPolynomialSolverTests)
+		{
+			using namespace slv;
+			using DoubleSolver = BasicPolynomialSolver<double>;
+
+			constexpr std::size_t degree = 4;
+			std::vector<int> coeffs((degree + 1) * 100000);
+			for (std::size_t i = 0; i < coeffs.size(); ++i)
+			{
+				coeffs[i] = static_cast<int>((i * 7919) % 2001) - 1000;
+			}
+			const PolynomialsView polynomials(coeffs.data(), coeffs.size() / (degree + 1), degree);
+			mt::ThreadPool pool(4);
+			BasicParallelPolynomialSolver<double> pSolver(pool);
+
+			// Blocks arrive in input order, cover the batch and match solve.
+			std::size_t next = 0;
+			bool resultsMatch = true;
+			std::string expected;
+			pSolver.stream(polynomials, [&](const BasicParallelPolynomialSolver<double>::SolvedBlock& block)
+				{
+					resultsMatch = resultsMatch && block.m_first == next && block.m_results.size() == block.m_polynomials.size();
+					for (std::size_t i = 0; i < block.m_polynomials.size() && resultsMatch; i += 97)
+					{
+						resultsMatch = block.m_results[i] == DoubleSolver::solve(coeffs.data() + (block.m_first + i) * (degree + 1), degree);
+					}
+					ResultFormatter::formatBlock(block.m_polynomials, block.m_results.getColumns(), expected);
+					next += block.m_polynomials.size();
+				});
+			Assert::IsTrue(resultsMatch && next == polynomials.size(), L"ParallelPolynomialSolverTest1");
+
+			// Streaming to a file writes the same text.
+			const std::string path = (std::filesystem::temp_directory_path() / "SolverUnitTests.txt").string();
+			std::FILE* const file = std::fopen(path.c_str(), "wb");
+			Assert::IsTrue(file != nullptr, L"ParallelPolynomialSolverTest2");
+			pSolver.stream(polynomials, file);
+			std::fclose(file);
+			std::ifstream written(path, std::ios::binary);
+			const std::string text((std::istreambuf_iterator<char>(written)), std::istreambuf_iterator<char>());
+			written.close();
+			std::filesystem::remove(path);
+			Assert::IsTrue(text == expected, L"ParallelPolynomialSolverTest3");
+		}
+		TEST_METHOD(ResultCacheTests)
+		{
+			using namespace slv;
+
+			auto solveRow = [](const int a, const int b, const int c, const Solver::ResultColumns& columns)
+				{
+					Solver::solveBatch(&a, &b, &c, 1, columns);
+				};
+			Solver::Float firstRoot, secondRoot, extremum, criticalPoint;
+			ResultKind kind;
+			const Solver::ResultColumns columns{ &firstRoot, &secondRoot, &extremum, &criticalPoint, &kind };
+
+			// Only the same equation hits, multiples are separate entries.
+			ResultCache<Solver::Float> cache(1000);
+			Assert::IsTrue(!cache.lookup(1, -3, 2, columns, 0), L"ResultCacheTest1");
+			solveRow(1, -3, 2, columns);
+			cache.insert(1, -3, 2, columns, 0);
+			Assert::IsTrue(cache.lookup(1, -3, 2, columns, 0), L"ResultCacheTest2");
+			Assert::IsTrue(Solver::toResult(columns, 0) == Solver::solve(1, -3, 2), L"ResultCacheTest3");
+
+			// Multiples miss, linear equations and equations with c == 0 are solved directly.
+			Assert::IsTrue(!cache.lookup(2, -6, 4, columns, 0) && !cache.lookup(-1, 3, -2, columns, 0), L"ResultCacheTest4");
+			Assert::IsTrue(!cache.lookup(0, 2, 4, columns, 0) && !cache.lookup(1, 2, 0, columns, 0), L"ResultCacheTest4");
+			ResultCache<Solver::Float>::Statistics statistics = cache.getStatistics();
+			Assert::IsTrue(statistics.m_hits == 1 && statistics.m_misses == 3 && statistics.m_size == 1, L"ResultCacheTest5");
+
+			// A full cache evicts, entries hit since the last pass of the clock hand survive.
+			ResultCache<Solver::Float> smallCache(2, 1);
+			for (const int c : { 1, 2 })
+			{
+				solveRow(1, 5, c, columns);
+				smallCache.insert(1, 5, c, columns, 0);
+			}
+			Assert::IsTrue(smallCache.lookup(1, 5, 1, columns, 0), L"ResultCacheTest6");
+			solveRow(1, 5, 3, columns);
+			smallCache.insert(1, 5, 3, columns, 0);
+			statistics = smallCache.getStatistics();
+			Assert::IsTrue(statistics.m_evictions == 1 && statistics.m_size == 2, L"ResultCacheTest7");
+			Assert::IsTrue(smallCache.lookup(1, 5, 1, columns, 0) && !smallCache.lookup(1, 5, 2, columns, 0), L"ResultCacheTest8");
+
+			// Cached solving prints the same text.
+			std::vector<int> coeffs;
+			for (int i = 0; i < 1000; ++i)
+			{
+				coeffs.insert(coeffs.end(), { (i % 7) - 3, i % 5, (i % 3) - 1 });
+			}
+			ParallelSolver plain;
+			ParallelSolver cached;
+			cached.setCache(&cache);
+			plain(coeffs);
+			cached(coeffs);
+			const std::uint64_t firstHits = cache.getStatistics().m_hits;
+			cached(coeffs);
+			std::ostringstream plainText;
+			std::ostringstream cachedText;
+			plainText << plain;
+			cachedText << cached;
+			Assert::IsTrue(plainText.str() == cachedText.str(), L"ResultCacheTest9");
+			// The second batch hits every row but the linear ones and those with c == 0.
+			std::size_t cacheableCount = 0;
+			for (std::size_t i = 0; i < coeffs.size(); i += 3)
+			{
+				cacheableCount += coeffs[i] != 0 && coeffs[i + 2] != 0 ? 1 : 0;
+			}
+			Assert::IsTrue(cache.getStatistics().m_hits - firstHits == cacheableCount, L"ResultCacheTest10");
+
+			// Hits are bit-identical to solveBatch, also for scaled equations in float, where rescaled results would round differently.
+			using FloatSolver = BasicSolver<float>;
+			float floatRoots[4];
+			ResultKind floatKind;
+			const FloatSolver::ResultColumns cachedColumns{ &floatRoots[0], &floatRoots[1], &floatRoots[2], &floatRoots[3], &floatKind };
+			float solvedRoots[4];
+			ResultKind solvedKind;
+			const FloatSolver::ResultColumns solvedColumns{ &solvedRoots[0], &solvedRoots[1], &solvedRoots[2], &solvedRoots[3], &solvedKind };
+			ResultCache<float> floatCache(100000);
+			bool hitsMatch = true;
+			for (int i = 0; i < 20000; ++i)
+			{
+				const int factor = i % 7 - 3 != 0 ? i % 7 - 3 : 5;
+				const int a = factor * ((i * 37) % 23 + 1);
+				const int b = factor * ((i * 53) % 41 - 20);
+				const int c = factor * ((i * 71) % 29 - 14);
+				FloatSolver::solveBatch(&a, &b, &c, 1, solvedColumns);
+				if (floatCache.lookup(a, b, c, cachedColumns, 0))
+				{
+					hitsMatch = hitsMatch && FloatSolver::toResult(cachedColumns, 0) == FloatSolver::toResult(solvedColumns, 0);
+				}
+				else
+				{
+					floatCache.insert(a, b, c, solvedColumns, 0);
+				}
+			}
+			Assert::IsTrue(hitsMatch && floatCache.getStatistics().m_hits > 0, L"ResultCacheTest11");
+		}
+		TEST_METHOD(GranularityPolicyTests)
+		{
+			using namespace slv;
+
+			// 1 ns per equation: a block needs 20000 equations, 45 bytes per equation fit 23301 equations into the cache.
+			GranularityPolicy policy(45, 4, 1.0);
+			const GranularityPolicy::Plan tiny = policy.plan(30000);
+			Assert::IsTrue(tiny.m_inline && tiny.m_blocksCount == 1, L"GranularityPolicyTest1");
+			const GranularityPolicy::Plan small = policy.plan(100000);
+			Assert::IsTrue(!small.m_inline && small.m_blocksCount == 5, L"GranularityPolicyTest2");
+			Assert::IsTrue(policy.plan(1000000).m_blocksCount == 43, L"GranularityPolicyTest3");
+
+			// Short batches are ignored, others move the estimation by a quarter of the difference.
+			policy.record(1000, std::chrono::microseconds(100));
+			Assert::IsTrue(policy.getNanosecondsPerEquation() == 1.0, L"GranularityPolicyTest4");
+			policy.record(10000, std::chrono::microseconds(130));
+			Assert::IsTrue(policy.getNanosecondsPerEquation() == 4.0, L"GranularityPolicyTest5");
+			Assert::IsTrue(policy.plan(30000).m_blocksCount == 6, L"GranularityPolicyTest6");
+
+			// Inline batches print the same text.
+			ParallelSolver pSolver;
+			pSolver({ 1, 2, -3, 0, 2, 4 });
+			std::ostringstream text;
+			text << pSolver;
+			Assert::IsTrue(text.str() == "INPUT: (1, 2, -3)\nOUTPUT: (-3.000000, 1.000000). GLOBAL MIN = -4.000000 AT x = -1.000000\n\n"
+				"INPUT: (0, 2, 4)\nOUTPUT: (-2.000000). GLOBAL MIN(MAX) = -2.000000\n\n", L"GranularityPolicyTest7");
+		}
+		TEST_METHOD(ParallelSolverAsyncTests)
+		{
+			using namespace slv;
+
+			// Batches big enough to be split into blocks.
+			std::vector<std::vector<int>> batches(3);
+			for (std::size_t i = 0; i < batches.size(); ++i)
+			{
+				batches[i].resize(3 * (100000 + 1000 * i));
+				for (std::size_t j = 0; j < batches[i].size(); ++j)
+				{
+					batches[i][j] = static_cast<int>((j * 7919 + i * 104729) % 2001) - 1000;
+				}
+			}
+			std::vector<std::string> expected;
+			for (const std::vector<int>& batch : batches)
+			{
+				ParallelSolver pSolver;
+				pSolver(batch);
+				std::ostringstream text;
+				text << pSolver;
+				expected.push_back(text.str());
+			}
+
+			// All batches are in flight on one solver at the same time, each keeps its own results.
+			mt::ThreadPool pool(4);
+			ParallelSolver pSolver(pool);
+			pSolver({ 1, 2, -3 });
+			std::vector<ParallelSolver::BatchHandle> handles;
+			for (const std::vector<int>& batch : batches)
+			{
+				handles.push_back(pSolver.solveAsync(batch));
+			}
+			for (std::size_t i = 0; i < handles.size(); ++i)
+			{
+				std::ostringstream text;
+				ResultFormatter::write(text, handles[i].format());
+				Assert::IsTrue(text.str() == expected[i], L"ParallelSolverAsyncTest1");
+				Assert::IsTrue(handles[i].isReady() && handles[i].getResults().size() == batches[i].size() / 3, L"ParallelSolverAsyncTest2");
+			}
+			// The last batch of operator() is not affected.
+			Assert::IsTrue(pSolver.getResults().size() == 1, L"ParallelSolverAsyncTest3");
+
+			// Polling, without helping the pool.
+			const ParallelSolver::BatchHandle polled = pSolver.solveAsync(batches[0]);
+			for (int i = 0; i < 10000 && !polled.isReady(); ++i)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+			Assert::IsTrue(polled.isReady(), L"ParallelSolverAsyncTest4");
+
+			// co_await, both for a batch in flight and for one solved inline before it is awaited.
+			std::promise<std::size_t> awaited;
+			std::future<std::size_t> awaitedFuture = awaited.get_future();
+			[](ParallelSolver& solver, const std::vector<int>& batch, std::promise<std::size_t>& result) -> DetachedTask
+				{
+					// Results belong to the handle, so it is kept.
+					const ParallelSolver::BatchHandle handle = solver.solveAsync(batch);
+					const ResultStore<Solver::Float>& results = co_await handle;
+					const ParallelSolver::BatchHandle inlineHandle = solver.solveAsync({ 1, 2, -3, 0, 2, 4 });
+					const ResultStore<Solver::Float>& inlineResults = co_await inlineHandle;
+					result.set_value(results.size() + inlineResults.size());
+				}(pSolver, batches[1], awaited);
+			Assert::IsTrue(awaitedFuture.get() == batches[1].size() / 3 + 2, L"ParallelSolverAsyncTest5");
+		}
+		TEST_METHOD(ParallelSolverStreamTests)
+		{
+			using namespace slv;
+
+			std::vector<int> coeffs(3 * 150000);
+			for (std::size_t i = 0; i < coeffs.size(); ++i)
+			{
+				coeffs[i] = static_cast<int>((i * 7919) % 2001) - 1000;
+			}
+			const CoefficientsView view = CoefficientsView::fromInterleaved(coeffs.data(), coeffs.size() / 3);
+			mt::ThreadPool pool(4);
+			ParallelSolver pSolver(pool);
+			pSolver(coeffs);
+			std::ostringstream expected;
+			expected << pSolver;
+
+			// Blocks arrive in input order and cover the batch, the last batch of operator() is kept.
+			std::size_t next = 0;
+			bool resultsMatch = true;
+			pSolver.stream(view, [&](const ParallelSolver::SolvedBlock& block)
+				{
+					resultsMatch = resultsMatch && block.m_first == next && block.m_results.size() == block.m_coeffs.size();
+					for (std::size_t i = 0; i < block.m_coeffs.size() && resultsMatch; i += 97)
+					{
+						resultsMatch = block.m_results[i] == pSolver.getResults()[block.m_first + i];
+					}
+					next += block.m_coeffs.size();
+				});
+			Assert::IsTrue(resultsMatch && next == view.size(), L"ParallelSolverStreamTest1");
+			Assert::IsTrue(pSolver.getResults().size() == view.size(), L"ParallelSolverStreamTest2");
+
+			// In completion order every block arrives once.
+			std::vector<std::pair<std::size_t, std::size_t>> blocks;
+			pSolver.stream(view, [&](const ParallelSolver::SolvedBlock& block)
+				{
+					blocks.emplace_back(block.m_first, block.m_coeffs.size());
+				}, mt::Ordering::Completion);
+			std::sort(blocks.begin(), blocks.end());
+			next = 0;
+			for (const auto& [first, size] : blocks)
+			{
+				resultsMatch = resultsMatch && first == next;
+				next += size;
+			}
+			Assert::IsTrue(resultsMatch && next == view.size(), L"ParallelSolverStreamTest3");
+
+			// Streaming to a file writes the same text as write.
+			const std::string path = (std::filesystem::temp_directory_path() / "SolverUnitTests.txt").string();
+			std::FILE* const file = std::fopen(path.c_str(), "wb");
+			Assert::IsTrue(file != nullptr, L"ParallelSolverStreamTest4");
+			pSolver.stream(view, file);
+			std::fclose(file);
+			std::ifstream written(path, std::ios::binary);
+			const std::string text((std::istreambuf_iterator<char>(written)), std::istreambuf_iterator<char>());
+			written.close();
+			std::filesystem::remove(path);
+			Assert::IsTrue(text == expected.str(), L"ParallelSolverStreamTest5");
+		}
+		TEST_METHOD(StatisticsTests)
+		{
+			using mt::Histogram;
+			using mt::Statistics;
+
+			// Exact below 32, then 16 buckets per power of two.
+			Assert::IsTrue(Histogram::getBucketIndex(31) == 31 && Histogram::getBucketIndex(32) == 32 && Histogram::getBucketIndex(33) == 32
+				&& Histogram::getBucketIndex(34) == 33 && Histogram::getBucketUpperBound(32) == 33, L"StatisticsTest1");
+			bool boundsAreTight = Histogram::getBucketIndex(UINT64_MAX) == Histogram::bucketsCount - 1;
+			for (std::uint64_t value = 1; value < (std::uint64_t(1) << 60); value = value * 3 + 1)
+			{
+				const std::uint64_t upperBound = Histogram::getBucketUpperBound(Histogram::getBucketIndex(value));
+				boundsAreTight = boundsAreTight && upperBound >= value && upperBound - value <= value / Histogram::subBucketsCount;
+			}
+			Assert::IsTrue(boundsAreTight, L"StatisticsTest2");
+
+			Histogram histogram;
+			for (std::uint64_t value = 1; value <= 1000; ++value)
+			{
+				histogram.record(value);
+			}
+			Histogram::Snapshot snapshot;
+			histogram.addTo(snapshot);
+			Assert::IsTrue(snapshot.getCount() == 1000 && snapshot.getMin() == 1 && snapshot.getMax() == 1000 && snapshot.getMean() == 500.5, L"StatisticsTest3");
+			Assert::IsTrue(snapshot.getPercentile(0.5) >= 500 && snapshot.getPercentile(0.5) <= 531 && snapshot.getPercentile(1.0) == 1000, L"StatisticsTest4");
+
+			// Counters of finished threads are kept, nothing is recorded while disabled.
+			Statistics::setEnabled(true);
+			const Statistics::Snapshot before = Statistics::getSnapshot();
+			{
+				std::vector<std::jthread> threads;
+				for (int i = 0; i < 4; ++i)
+				{
+					threads.emplace_back([]
+						{
+							for (int j = 0; j < 1000; ++j)
+							{
+								Statistics::add(Statistics::Counter::SolvedBlocks);
+							}
+						});
+				}
+			}
+			auto sharedContainer = mt::createThreadSafeSTLAdapterFrom(std::queue<int>{});
+			sharedContainer.enableStatistics();
+			for (int i = 0; i < 3; ++i)
+			{
+				sharedContainer.push(i);
+			}
+			int item;
+			while (sharedContainer.tryPop(item))
+			{ }
+			Statistics::setEnabled(false);
+			Statistics::add(Statistics::Counter::SolvedBlocks);
+			const Statistics::Snapshot after = Statistics::getSnapshot();
+			Assert::IsTrue(after.get(Statistics::Counter::SolvedBlocks) - before.get(Statistics::Counter::SolvedBlocks) == 4000, L"StatisticsTest5");
+			Assert::IsTrue(after.get(Statistics::Counter::SharedContainerPushes) - before.get(Statistics::Counter::SharedContainerPushes) == 3
+				&& after.get(Statistics::Counter::SharedContainerPops) - before.get(Statistics::Counter::SharedContainerPops) == 3
+				&& after.get(Statistics::Distribution::QueueWaitNs).getCount() - before.get(Statistics::Distribution::QueueWaitNs).getCount() == 3
+				&& after.m_sharedContainerHighWaterMark >= 3, L"StatisticsTest6");
+		}
+		TEST_METHOD(ThreadPoolTests)
+		{
+			mt::ThreadPool pool(2);
+			Assert::IsTrue(pool.getThreadsCount() == 2, L"ThreadPoolTest1");
+
+			// Tasks spawning tasks land in the worker's own deque and can be stolen by others.
+			std::atomic<int> counter{ 0 };
+			std::vector<std::future<void>> futures;
+			for (int i = 0; i < 100; ++i)
+			{
+				futures.push_back(pool.submit([&]
+					{
+						auto inner = pool.submit([&] { ++counter; });
+						pool.waitFor(inner);
+						++counter;
+					}));
+			}
+			for (const std::future<void>& future : futures)
+			{
+				pool.waitFor(future);
+			}
+			Assert::IsTrue(counter == 200, L"ThreadPoolTest2");
+
+			// Results and exceptions are delivered through futures.
+			std::future<int> value = pool.submit([] { return 42; });
+			pool.waitFor(value);
+			Assert::IsTrue(value.get() == 42, L"ThreadPoolTest3");
+
+			std::future<void> failure = pool.submit([] { throw std::runtime_error("failure"); });
+			pool.waitFor(failure);
+			bool thrown = false;
+			try
+			{
+				failure.get();
+			}
+			catch (const std::runtime_error&)
+			{
+				thrown = true;
+			}
+			Assert::IsTrue(thrown, L"ThreadPoolTest4");
+		}
+		TEST_METHOD(TopologyTests)
+		{
+			// Whatever the machine is, there is at least one node and every node has CPUs.
+			const mt::Topology& topology = mt::Topology::get();
+			Assert::IsTrue(topology.getNodesCount() >= 1 && topology.getCpusCount() >= topology.getNodesCount(), L"TopologyTest1");
+
+			const mt::Topology twoNodes({ { 1, { 4, 5, 6, 9 } }, { 0, { 0, 1 } }, { 2, {} } });
+			Assert::IsTrue(twoNodes.getNodesCount() == 2 && twoNodes.getNodes()[0].m_id == 0 && twoNodes.getCpusCount() == 6, L"TopologyTest2");
+			std::ostringstream text;
+			text << twoNodes;
+			Assert::IsTrue(text.str() == "2 nodes, node 0: cpus 0-1, node 1: cpus 4-6,9", L"TopologyTest3");
+
+			// Pinned workers spread over nodes round-robin and solve the same as unpinned ones.
+			mt::ThreadPool pool(3, mt::ThreadPool::Affinity::Node);
+			Assert::IsTrue(pool.getWorkerNode(1) == 1 % topology.getNodesCount(), L"TopologyTest4");
+			std::future<int> value = pool.submitTo(2, [] { return 42; });
+			pool.waitFor(value);
+			Assert::IsTrue(value.get() == 42, L"TopologyTest5");
+
+			std::vector<int> coeffs;
+			for (int i = 0; i < 1000; ++i)
+			{
+				coeffs.insert(coeffs.end(), { (i % 7) - 3, i % 5, (i % 3) - 1 });
+			}
+			slv::ParallelSolver plain;
+			slv::ParallelSolver pinned(pool);
+			plain(coeffs);
+			pinned(coeffs);
+			std::ostringstream plainText;
+			std::ostringstream pinnedText;
+			plainText << plain;
+			pinnedText << pinned;
+			Assert::IsTrue(plainText.str() == pinnedText.str(), L"TopologyTest6");
+		}
+		TEST_METHOD(ResultFormatterTests)
+		{
+			using namespace slv;
+
+			// Text must stay byte-identical to the original iostream output (std::ios::fixed, precision 6).
+			const int a[]{ 1, 0, 0, 0, 1, -1 };
+			const int b[]{ 2, 2, 0, 0, 0, 0 };
+			const int c[]{ -3, 4, 0, 1, 1, -2147483647 };
+			const CoefficientsView coeffs = CoefficientsView::fromColumns(a, b, c, 6);
+			ResultStore<Solver::Float> results;
+			results.resize(coeffs.size());
+			Solver::solveBatch(a, b, c, coeffs.size(), results.getColumns());
+			std::string buffer;
+			ResultFormatter::formatBlock(coeffs, results.getColumns(), buffer);
+			Assert::IsTrue(buffer ==
+				"INPUT: (1, 2, -3)\nOUTPUT: (-3.000000, 1.000000). GLOBAL MIN = -4.000000 AT x = -1.000000\n\n"
+				"INPUT: (0, 2, 4)\nOUTPUT: (-2.000000). GLOBAL MIN(MAX) = -2.000000\n\n"
+				"INPUT: (0, 0, 0)\nOUTPUT: AN IDENTITY\n\n"
+				"INPUT: (0, 0, 1)\nOUTPUT: NOT CORRECT\n\n"
+				"INPUT: (1, 0, 1)\nOUTPUT: NO REAL ROOTS. GLOBAL MIN = 1.000000 AT x = -0.000000\n\n"
+				"INPUT: (-1, 0, -2147483647)\nOUTPUT: NO REAL ROOTS. GLOBAL MAX = -2147483647.000000 AT x = 0.000000\n\n", L"ResultFormatterTest1");
+
+			// Packed rows convert back to the Result representation.
+			for (std::size_t i = 0; i < coeffs.size(); ++i)
+			{
+				Assert::IsTrue(results[i] == Solver::solve(a[i], b[i], c[i]), L"ResultFormatterTest2");
+			}
+		}
+		TEST_METHOD(RingBufferTests)
+		{
+			// Capacity is rounded up to a power of two, full ring rejects tryPush.
+			mt::SPSCRingBuffer<std::vector<int>> spsc(3);
+			Assert::IsTrue(spsc.capacity() == 4, L"RingBufferTest1");
+			for (int i = 0; i < 4; ++i)
+			{
+				spsc.push({ i });
+			}
+			std::vector<int> extra{ 4 };
+			Assert::IsFalse(spsc.tryPush(extra) || extra.empty(), L"RingBufferTest2");
+			std::vector<int> item;
+			for (int i = 0; i < 4; ++i)
+			{
+				Assert::IsTrue(spsc.tryPop(item) && item == std::vector<int>{ i }, L"RingBufferTest3");
+			}
+			Assert::IsFalse(spsc.tryPop(item), L"RingBufferTest4");
+
+			// Every pushed element is popped exactly once with several producers and consumers.
+			mt::MPMCRingBuffer<int> mpmc(64);
+			constexpr int itemsPerProducer = 10000;
+			std::atomic<long long> sum{ 0 };
+			std::atomic<int> popped{ 0 };
+			{
+				std::vector<std::jthread> threads;
+				for (int p = 0; p < 2; ++p)
+				{
+					threads.emplace_back([&] { for (int i = 1; i <= itemsPerProducer; ++i) mpmc.push(i); });
+					threads.emplace_back([&]
+						{
+							while (popped.load() < 2 * itemsPerProducer)
+							{
+								if (int value; mpmc.tryPop(value))
+								{
+									sum += value;
+									++popped;
+								}
+							}
+						});
+				}
+			}
+			Assert::IsTrue(sum == 2LL * itemsPerProducer * (itemsPerProducer + 1) / 2, L"RingBufferTest5");
+
+			// Ring buffers plug into Producer and Consumer as the shared container.
+			mt::MPMCRingBuffer<int> sharedContainer(16);
+			std::atomic<int> consumed{ 0 };
+			{
+				mt::Producer producer(sharedContainer);
+				mt::Consumer consumer(sharedContainer, [&](int value) { consumed += value; });
+				producer.enableWorkerThread();
+				consumer.enableWorkerThread();
+				producer.push({ 1, 2, 3, 4 });
+				for (int i = 0; i < 1000 && consumed != 10; ++i)
+				{
+					std::this_thread::sleep_for(std::chrono::milliseconds(5));
+				}
+			}
+			Assert::IsTrue(consumed == 10, L"RingBufferTest6");
+		}
+		TEST_METHOD(WaitPolicyTests)
+		{
+			// No spinning and a timeout far beyond the test duration: only explicit wakeups can make progress.
+			using ParkOnlyPolicy = mt::SpinThenParkWaitPolicy<0, 60000>;
+			auto sharedContainer = mt::createThreadSafeSTLAdapterFrom(std::queue<int>{});
+			std::atomic<int> consumed{ 0 };
+			const auto start = std::chrono::steady_clock::now();
+			{
+				mt::Producer<decltype(sharedContainer), ParkOnlyPolicy> producer(sharedContainer);
+				mt::Consumer<decltype(sharedContainer), std::function<void(int)>, ParkOnlyPolicy> consumer(
+					sharedContainer, [&](int value) { consumed += value; });
+				producer.enableWorkerThread();
+				consumer.enableWorkerThread();
+				// Let both workers park before pushing.
+				std::this_thread::sleep_for(std::chrono::milliseconds(50));
+				producer.push({ 1, 2, 3 });
+				for (int i = 0; i < 1000 && consumed != 6; ++i)
+				{
+					std::this_thread::sleep_for(std::chrono::milliseconds(5));
+				}
+			}
+			// Parked workers are woken on push and on shutdown, not by the timeout.
+			Assert::IsTrue(consumed == 6, L"WaitPolicyTest1");
+			Assert::IsTrue(std::chrono::steady_clock::now() - start < std::chrono::seconds(30), L"WaitPolicyTest2");
+
+			// The polling policy keeps the old behaviour.
+			consumed = 0;
+			{
+				mt::Producer<decltype(sharedContainer), mt::YieldWaitPolicy> producer(sharedContainer);
+				mt::Consumer<decltype(sharedContainer), std::function<void(int)>, mt::YieldWaitPolicy> consumer(
+					sharedContainer, [&](int value) { consumed += value; });
+				producer.enableWorkerThread();
+				consumer.enableWorkerThread();
+				producer.push({ 4, 5 });
+				for (int i = 0; i < 1000 && consumed != 9; ++i)
+				{
+					std::this_thread::sleep_for(std::chrono::milliseconds(5));
+				}
+			}
+			Assert::IsTrue(consumed == 9, L"WaitPolicyTest3");
+		}
+		TEST_METHOD(DrainTests)
+		{
+			// Every pushed item is consumed before the completion future becomes ready, without any sleep.
+			auto sharedContainer = mt::createThreadSafeSTLAdapterFrom(std::queue<int>{});
+			long long sum = 0;
+			{
+				mt::Producer producer(sharedContainer);
+				mt::Consumer consumer(sharedContainer, std::function<void(int)>([&](int value) { sum += value; }));
+				const std::shared_future<void> producerDone = producer.getCompletionFuture();
+				const std::shared_future<void> consumerDone = consumer.getCompletionFuture();
+				producer.enableWorkerThread();
+				consumer.enableWorkerThread();
+				for (int i = 0; i < 100; ++i)
+				{
+					std::vector<int> items(100);
+					std::iota(items.begin(), items.end(), i * 100);
+					producer.push(std::move(items));
+				}
+				producer.close();
+				consumerDone.get();
+				Assert::IsTrue(producerDone.wait_for(std::chrono::seconds(0)) == std::future_status::ready, L"DrainTest1");
+				Assert::IsTrue(sum == 10000LL * 9999 / 2, L"DrainTest2");
+			}
+			Assert::IsTrue(sharedContainer.isDrained(), L"DrainTest3");
+			bool pushThrown = false;
+			try
+			{
+				sharedContainer.push(1);
+			}
+			catch (const mt::ClosedAdapter&)
+			{
+				pushThrown = true;
+			}
+			Assert::IsTrue(pushThrown, L"DrainTest4");
+
+			// Failure of the consumer's callable is delivered through the completion future.
+			auto failingContainer = mt::createThreadSafeSTLAdapterFrom(std::queue<int>{});
+			{
+				mt::Producer producer(failingContainer);
+				mt::Consumer consumer(failingContainer, std::function<void(int)>([](int) { throw std::runtime_error("failed"); }));
+				const std::shared_future<void> consumerDone = consumer.getCompletionFuture();
+				producer.enableWorkerThread();
+				consumer.enableWorkerThread();
+				producer.push({ 1 });
+				producer.close();
+				bool failureDelivered = false;
+				try
+				{
+					consumerDone.get();
+				}
+				catch (const std::runtime_error&)
+				{
+					failureDelivered = true;
+				}
+				Assert::IsTrue(failureDelivered, L"DrainTest5");
+			}
+
+			// The same semantics with a lock-free ring as the shared container.
+			mt::SPSCRingBuffer<int> ring(8);
+			sum = 0;
+			{
+				mt::Producer producer(ring);
+				mt::Consumer consumer(ring, std::function<void(int)>([&](int value) { sum += value; }));
+				const std::shared_future<void> consumerDone = consumer.getCompletionFuture();
+				producer.enableWorkerThread();
+				consumer.enableWorkerThread();
+				std::vector<int> items(1000);
+				std::iota(items.begin(), items.end(), 0);
+				producer.push(std::move(items));
+				producer.close();
+				consumerDone.get();
+			}
+			Assert::IsTrue(sum == 1000LL * 999 / 2 && ring.isDrained(), L"DrainTest6");
+		}
+		TEST_METHOD(BackpressureTests)
+		{
+			auto adapter = mt::createThreadSafeSTLAdapterFrom(std::queue<int>{});
+			adapter.setCapacity(2);
+			int value = 1;
+			const bool pushed = adapter.tryPush(value) && adapter.tryPush(value);
+			value = 3;
+			Assert::IsTrue(pushed && !adapter.tryPush(value) && value == 3 && adapter.getCapacity() == 2, L"BackpressureTest1");
+			const auto start = std::chrono::steady_clock::now();
+			Assert::IsTrue(!adapter.pushFor(value, std::chrono::milliseconds(20))
+				&& std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(20), L"BackpressureTest2");
+
+			// A blocked push completes as soon as an element is popped.
+			std::atomic<bool> blockedPushDone{ false };
+			{
+				std::jthread pusher([&]
+					{
+						adapter.push(4);
+						blockedPushDone = true;
+					});
+				std::this_thread::sleep_for(std::chrono::milliseconds(20));
+				const bool wasBlocked = !blockedPushDone;
+				int popped = 0;
+				Assert::IsTrue(wasBlocked && adapter.tryPop(popped) && popped == 1, L"BackpressureTest3");
+			}
+			int first = 0, second = 0;
+			Assert::IsTrue(blockedPushDone && adapter.tryPop(first) && adapter.tryPop(second) && first == 1 && second == 4, L"BackpressureTest4");
+
+			// close wakes blocked pushers with ClosedAdapter.
+			adapter.setCapacity(1);
+			adapter.push(5);
+			std::atomic<bool> pushThrown{ false };
+			{
+				std::jthread pusher([&]
+					{
+						try
+						{
+							adapter.push(6);
+						}
+						catch (const mt::ClosedAdapter&)
+						{
+							pushThrown = true;
+						}
+					});
+				std::this_thread::sleep_for(std::chrono::milliseconds(20));
+				adapter.close();
+			}
+			Assert::IsTrue(pushThrown, L"BackpressureTest5");
+
+			// Without a consumer the producer fills the shared container up to its capacity and can still be stopped.
+			auto sharedContainer = mt::createThreadSafeSTLAdapterFrom(std::queue<int>{});
+			sharedContainer.setCapacity(4);
+			{
+				mt::Producer producer(sharedContainer);
+				producer.enableWorkerThread();
+				std::vector<int> items(100);
+				std::iota(items.begin(), items.end(), 0);
+				producer.push(std::move(items));
+				std::this_thread::sleep_for(std::chrono::milliseconds(50));
+			}
+			int count = 0;
+			for (int item = 0; sharedContainer.tryPop(item); )
+			{
+				++count;
+			}
+			Assert::IsTrue(count == 4, L"BackpressureTest6");
+
+			// Bounded on both sides, every item still reaches the consumer.
+			auto boundedContainer = mt::createThreadSafeSTLAdapterFrom(std::queue<int>{});
+			boundedContainer.setCapacity(8);
+			long long sum = 0;
+			{
+				mt::Producer producer(boundedContainer, 2);
+				mt::Consumer consumer(boundedContainer, std::function<void(int)>([&](int item) { sum += item; }));
+				const std::shared_future<void> consumerDone = consumer.getCompletionFuture();
+				producer.enableWorkerThread();
+				consumer.enableWorkerThread();
+				for (int i = 0; i < 50; ++i)
+				{
+					std::vector<int> items(100);
+					std::iota(items.begin(), items.end(), i * 100);
+					producer.push(std::move(items));
+				}
+				producer.close();
+				consumerDone.get();
+			}
+			Assert::IsTrue(sum == 5000LL * 4999 / 2 && boundedContainer.isDrained(), L"BackpressureTest7");
+		}
+		TEST_METHOD(BulkTests)
+		{
+			auto adapter = mt::createThreadSafeSTLAdapterFrom(std::queue<std::string>{});
+			std::vector<std::string> items{ "a", "b", "c", "d", "e" };
+			adapter.pushBulk(items.begin(), items.end());
+			std::vector<std::string> popped;
+			Assert::IsTrue(adapter.tryPopBulk(popped, 3) == 3 && adapter.tryPopBulk(popped, 3) == 2 && adapter.tryPopBulk(popped, 3) == 0
+				&& popped == std::vector<std::string>{ "a", "b", "c", "d", "e" }, L"BulkTest1");
+
+			// Only the elements which fit are pushed, the others stay in the range.
+			adapter.setCapacity(3);
+			items = { "a", "b", "c", "d", "e" };
+			const auto pushedEnd = adapter.tryPushBulk(items.begin(), items.end());
+			Assert::IsTrue(pushedEnd == items.begin() + 3 && items[3] == "d" && items[4] == "e", L"BulkTest2");
+			const auto start = std::chrono::steady_clock::now();
+			Assert::IsTrue(adapter.pushBulkFor(pushedEnd, items.end(), std::chrono::milliseconds(20)) == pushedEnd
+				&& std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(20) && items[3] == "d", L"BulkTest3");
+
+			// A blocking bulk push larger than the capacity completes while a consumer pops.
+			auto boundedContainer = mt::createThreadSafeSTLAdapterFrom(std::queue<int>{});
+			boundedContainer.setCapacity(4);
+			std::vector<int> values(100);
+			std::iota(values.begin(), values.end(), 0);
+			std::vector<int> received;
+			{
+				std::jthread consumer([&]
+					{
+						while (received.size() != values.size())
+						{
+							if (boundedContainer.tryPopBulk(received, 16) == 0)
+							{
+								std::this_thread::yield();
+							}
+						}
+					});
+				boundedContainer.pushBulk(values.begin(), values.end());
+			}
+			std::vector<int> expected(100);
+			std::iota(expected.begin(), expected.end(), 0);
+			Assert::IsTrue(received == expected, L"BulkTest4");
+
+			// Rings push what fits and pop in order.
+			mt::SPSCRingBuffer<int> spsc(8);
+			mt::MPMCRingBuffer<int> mpmc(8);
+			std::vector<int> spscOut, mpmcOut;
+			const bool spscPushed = spsc.tryPushBulk(values.begin(), values.begin() + 10) == values.begin() + 8;
+			const bool mpmcPushed = mpmc.tryPushBulk(values.begin(), values.begin() + 10) == values.begin() + 8;
+			Assert::IsTrue(spscPushed && spsc.tryPopBulk(spscOut, 100) == 8 && spscOut == std::vector<int>(expected.begin(), expected.begin() + 8), L"BulkTest5");
+			Assert::IsTrue(mpmcPushed && mpmc.tryPopBulk(mpmcOut, 5) == 5 && mpmc.tryPopBulk(mpmcOut, 5) == 3
+				&& mpmcOut == std::vector<int>(expected.begin(), expected.begin() + 8), L"BulkTest6");
+
+			// Only the elements which fit are wrapped, a full adapter doesn't move any.
+			struct Counted
+			{
+				int* m_moves;
+				explicit Counted(int* const moves) : m_moves(moves) { }
+				Counted(Counted&& rhs) noexcept : m_moves(rhs.m_moves) { ++*m_moves; }
+				Counted& operator=(Counted&& rhs) noexcept { m_moves = rhs.m_moves; ++*m_moves; return *this; }
+			};
+			int moves = 0;
+			auto countedContainer = mt::createThreadSafeSTLAdapterFrom(std::queue<Counted>{});
+			countedContainer.setCapacity(1);
+			std::vector<Counted> counted;
+			counted.reserve(1001);
+			for (int i = 0; i < 1001; ++i)
+			{
+				counted.emplace_back(&moves);
+			}
+			countedContainer.pushBulk(counted.end() - 1, counted.end());
+			moves = 0;
+			Assert::IsTrue(countedContainer.pushBulkFor(counted.begin(), counted.end() - 1, std::chrono::milliseconds(1)) == counted.begin()
+				&& moves == 0, L"BulkTest7");
+		}
+		TEST_METHOD(NodePoolTests)
+		{
+			mt::NodePool pool;
+			// Blocks of the same size class are recycled, large blocks bypass the slabs.
+			void* const first = pool.allocate(24, alignof(int));
+			pool.deallocate(first, 24, alignof(int));
+			void* const second = pool.allocate(20, alignof(int));
+			const std::size_t slabsCount = pool.getSlabsCount();
+			void* const large = pool.allocate(4 * mt::NodePool::maxBlockSize, alignof(int));
+			Assert::IsTrue(first == second && slabsCount == 1 && pool.getSlabsCount() == 1, L"NodePoolTest1");
+			pool.deallocate(large, 4 * mt::NodePool::maxBlockSize, alignof(int));
+			pool.deallocate(second, 20, alignof(int));
+
+			// Once warmed up, a pooled adapter takes nothing more from the global heap.
+			using PooledDeque = std::deque<int, mt::PoolAllocator<int>>;
+			std::queue<int, PooledDeque> queue{ PooledDeque(mt::PoolAllocator<int>(pool)) };
+			queue.push(1);
+			auto adapter = mt::createThreadSafeSTLAdapterFrom(std::move(queue));
+			int value = 0;
+			Assert::IsTrue(adapter.tryPop(value) && value == 1, L"NodePoolTest2");
+			std::vector<int> items(100);
+			std::iota(items.begin(), items.end(), 0);
+			long long sum = 0;
+			std::size_t warmSlabsCount = 0;
+			for (int round = 0; round < 1000; ++round)
+			{
+				adapter.pushBulk(items.begin(), items.end());
+				for (int item = 0; adapter.tryPop(item); )
+				{
+					sum += item;
+				}
+				// The deque's map reaches its final size within the first rounds.
+				if (round == 9)
+				{
+					warmSlabsCount = pool.getSlabsCount();
+				}
+			}
+			Assert::IsTrue(sum == 1000LL * 99 * 100 / 2 && pool.getSlabsCount() == warmSlabsCount, L"NodePoolTest3");
+
+			// Priority queues keep their order, with elements allocated by the pool.
+			std::priority_queue<int, std::vector<int, mt::PoolAllocator<int>>, std::less<int>> priorityQueue{
+				std::less<int>{}, std::vector<int, mt::PoolAllocator<int>>(mt::PoolAllocator<int>(pool)) };
+			priorityQueue.push(3);
+			priorityQueue.push(7);
+			priorityQueue.push(5);
+			auto priorityAdapter = mt::createThreadSafeSTLAdapterFrom(priorityQueue, std::less<int>{});
+			int top = 0;
+			Assert::IsTrue(priorityAdapter.tryPop(top) && top == 7, L"NodePoolTest4");
+		}
+		TEST_METHOD(ConsumerPoolTests)
+		{
+			// Results reach the sink in input order although later elements finish first.
+			auto sharedContainer = mt::createThreadSafeSTLAdapterFrom(std::queue<int>{});
+			std::vector<int> results;
+			{
+				mt::Producer producer(sharedContainer);
+				mt::ConsumerPool pool(sharedContainer, [](int value)
+					{
+						std::this_thread::sleep_for(std::chrono::microseconds((value % 7) * 100));
+						return value * 2;
+					}, [&](int result) { results.push_back(result); }, mt::Ordering::Input, 4);
+				const std::shared_future<void> poolDone = pool.getCompletionFuture();
+				producer.enableWorkerThread();
+				pool.enableWorkerThread();
+				std::vector<int> items(200);
+				std::iota(items.begin(), items.end(), 0);
+				producer.push(std::move(items));
+				producer.close();
+				poolDone.get();
+			}
+			std::vector<int> expected(200);
+			std::generate(expected.begin(), expected.end(), [i = 0]() mutable { return 2 * i++; });
+			Assert::IsTrue(results == expected, L"ConsumerPoolTest1");
+
+			// In completion order every result is delivered once, the completion future waits for all workers.
+			auto unorderedContainer = mt::createThreadSafeSTLAdapterFrom(std::queue<int>{});
+			results.clear();
+			{
+				mt::Producer producer(unorderedContainer);
+				mt::ConsumerPool pool(unorderedContainer, [](int value) { return value; },
+					[&](int result) { results.push_back(result); }, mt::Ordering::Completion, 4);
+				const std::shared_future<void> poolDone = pool.getCompletionFuture();
+				producer.enableWorkerThread();
+				pool.enableWorkerThread();
+				std::vector<int> items(1000);
+				std::iota(items.begin(), items.end(), 0);
+				producer.push(std::move(items));
+				producer.close();
+				poolDone.get();
+			}
+			std::sort(results.begin(), results.end());
+			expected.resize(1000);
+			std::iota(expected.begin(), expected.end(), 0);
+			Assert::IsTrue(results == expected, L"ConsumerPoolTest2");
+
+			// Without a sink the workers really run concurrently.
+			mt::MPMCRingBuffer<int> ring(64);
+			std::atomic<int> running{ 0 };
+			std::atomic<int> maxRunning{ 0 };
+			std::atomic<long long> sum{ 0 };
+			{
+				mt::Producer producer(ring);
+				mt::ConsumerPool pool(ring, [&](int value)
+					{
+						const int now = ++running;
+						for (int seen = maxRunning; now > seen && !maxRunning.compare_exchange_weak(seen, now);)
+						{ }
+						std::this_thread::sleep_for(std::chrono::milliseconds(1));
+						sum += value;
+						--running;
+					}, 4);
+				const std::shared_future<void> poolDone = pool.getCompletionFuture();
+				producer.enableWorkerThread();
+				pool.enableWorkerThread();
+				std::vector<int> items(200);
+				std::iota(items.begin(), items.end(), 0);
+				producer.push(std::move(items));
+				producer.close();
+				poolDone.get();
+			}
+			Assert::IsTrue(sum == 200LL * 199 / 2 && ring.isDrained(), L"ConsumerPoolTest3");
+			Assert::IsTrue(maxRunning > 1, L"ConsumerPoolTest4");
+
+			// A failing worker fails the whole pool.
+			auto failingContainer = mt::createThreadSafeSTLAdapterFrom(std::queue<int>{});
+			{
+				mt::Producer producer(failingContainer);
+				mt::ConsumerPool pool(failingContainer, [](int value)
+					{
+						if (value == 3)
+						{
+							throw std::runtime_error("failed");
+						}
+					}, 2);
+				const std::shared_future<void> poolDone = pool.getCompletionFuture();
+				producer.enableWorkerThread();
+				pool.enableWorkerThread();
+				producer.push({ 1, 2, 3, 4 });
+				producer.close();
+				bool failureDelivered = false;
+				try
+				{
+					poolDone.get();
+				}
+				catch (const std::runtime_error&)
+				{
+					failureDelivered = true;
+				}
+				Assert::IsTrue(failureDelivered, L"ConsumerPoolTest5");
+			}
+		}
 	};
 }